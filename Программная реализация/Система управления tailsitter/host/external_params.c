@@ -0,0 +1,13 @@
+/**
+ * @file external_params.c
+ * Parameters owned by other PX4 modules (fw_pos_control, mc_pos_control, ...) that
+ * vtol_att_control reads. Defaults match upstream PX4.
+ */
+
+PARAM_DEFINE_FLOAT(FW_PSP_OFF, 0.0f);
+PARAM_DEFINE_INT32(FW_USE_AIRSPD, 1);
+PARAM_DEFINE_FLOAT(MPC_XY_CRUISE, 5.0f);
+PARAM_DEFINE_FLOAT(MPC_LAND_ALT1, 10.0f);
+PARAM_DEFINE_FLOAT(MPC_LAND_ALT2, 5.0f);
+PARAM_DEFINE_FLOAT(WEIGHT_BASE, -1.0f);
+PARAM_DEFINE_FLOAT(WEIGHT_GROSS, -1.0f);
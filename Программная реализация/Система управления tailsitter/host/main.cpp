@@ -0,0 +1,399 @@
+/**
+ * @file main.cpp
+ * @brief Host driver: runs vtol_att_control against a scripted flight on simulated time.
+ *
+ * The virtual MC and FW controllers publish at 250 Hz each. A transition to fixed-wing is
+ * commanded after 2 s and a back transition after 20 s (--back-transition). Every output the module publishes
+ * is folded into a checksum trace so two builds can be compared for identical behaviour.
+ * The controller runs on a ManualClock stepped by this driver, the stand-ins (work queue
+ * delays, subscription intervals, perf intervals) follow it through the host hrt.
+ *
+ * With --trace the state transitions and, at the end, the tilt of the last attitude setpoint are printed.
+ * With --auto the flight is an auto mission and the driver also stands in for the FW position
+ * controller, which publishes the flaps setpoint in fixed-wing. --trace then prints every change of it.
+ * With --bench the 'bench' command measures the cycle cost over the given wall-clock time in a
+ * second thread, the flight continues (hovering after the script ends) until it is done.
+ * With --replay the vehicle stays disarmed and the 'quadchute_replay' command runs the scripted
+ * failures through the checks of the controller, the parameters set the checks and limits.
+ *
+ * Usage: vtol_att_control_host_bin [vt_type] [seconds] [--trace] [--auto] [--back-transition seconds]
+ *                                  [--bench seconds] [--replay look-ahead seconds] [PARAM=value ...]
+ *        vtol_att_control_host_bin <module command> [args ...], e.g. trig_bench
+ */
+
+#include "vtol_att_control_main.h"
+
+#include <ctype.h>
+#include <drivers/drv_hrt.h>
+#include <parameters/param.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+#include <uORB/Publication.hpp>
+#include <uORB/Subscription.hpp>
+#include <uORB/topics/airspeed_validated.h>
+#include <uORB/topics/normalized_unsigned_setpoint.h>
+#include <uORB/topics/vehicle_attitude.h>
+#include <uORB/topics/vehicle_attitude_setpoint.h>
+#include <uORB/topics/vehicle_command.h>
+#include <uORB/topics/vehicle_control_mode.h>
+#include <uORB/topics/vehicle_land_detected.h>
+#include <uORB/topics/vehicle_local_position.h>
+#include <uORB/topics/vehicle_status.h>
+#include <uORB/topics/vehicle_thrust_setpoint.h>
+#include <uORB/topics/vehicle_torque_setpoint.h>
+#include <uORB/topics/vtol_vehicle_status.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+extern "C" int vtol_att_control_main(int argc, char *argv[]);
+
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t len)
+{
+	const uint8_t *p = static_cast<const uint8_t *>(data);
+
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ p[i]) * 1099511628211ull;
+	}
+
+	return hash;
+}
+
+static void quat_from_euler(float roll, float pitch, float yaw, float q[4])
+{
+	const float cr = cosf(roll / 2), sr = sinf(roll / 2);
+	const float cp = cosf(pitch / 2), sp = sinf(pitch / 2);
+	const float cy = cosf(yaw / 2), sy = sinf(yaw / 2);
+	q[0] = cr * cp * cy + sr * sp * sy;
+	q[1] = sr * cp * cy - cr * sp * sy;
+	q[2] = cr * sp * cy + sr * cp * sy;
+	q[3] = cr * cp * sy - sr * sp * cy;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1 && !isdigit(argv[1][0])) {
+		// module command without a running controller, e.g. trig_bench
+		return vtol_att_control_main(argc, argv);
+	}
+
+	const int32_t vt_type = argc > 1 ? atoi(argv[1]) : 0;
+	const float duration = argc > 2 ? atof(argv[2]) : 30.f;
+	bool trace = false;
+	bool auto_mission = false;
+	float back_transition_time = 20.f;
+	const char *bench_duration = nullptr;
+	const char *replay_horizon = nullptr;
+
+	param_set_no_notification(param_find("VT_TYPE"), &vt_type);
+
+	for (int i = 3; i < argc; i++) {
+		if (strcmp(argv[i], "--trace") == 0) {
+			trace = true;
+			continue;
+		}
+
+		if (strcmp(argv[i], "--auto") == 0) {
+			auto_mission = true;
+			continue;
+		}
+
+		if (strcmp(argv[i], "--back-transition") == 0 && i + 1 < argc) {
+			back_transition_time = atof(argv[++i]);
+			continue;
+		}
+
+		if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+			bench_duration = argv[++i];
+			continue;
+		}
+
+		if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+			replay_horizon = argv[++i];
+			continue;
+		}
+
+		char param[32] {};
+		const char *value = strchr(argv[i], '=');
+
+		if (value == nullptr || value - argv[i] >= (long)sizeof(param)) {
+			fprintf(stderr, "invalid argument %s\n", argv[i]);
+			return 1;
+		}
+
+		memcpy(param, argv[i], value - argv[i]);
+		const param_t handle = param_find(param);
+
+		if (handle == PARAM_INVALID) {
+			fprintf(stderr, "unknown parameter %s\n", param);
+			return 1;
+		}
+
+		if (param_type(handle) == PARAM_TYPE_FLOAT) {
+			const float f = atof(value + 1);
+			param_set_no_notification(handle, &f);
+
+		} else {
+			const int32_t v = atoi(value + 1);
+			param_set_no_notification(handle, &v);
+		}
+	}
+
+	ManualClock clock{1000000};
+	hrt_set_absolute_time(clock.now());
+
+	uORB::Publication<vehicle_torque_setpoint_s> torque_mc_pub{ORB_ID(vehicle_torque_setpoint_virtual_mc)};
+	uORB::Publication<vehicle_torque_setpoint_s> torque_fw_pub{ORB_ID(vehicle_torque_setpoint_virtual_fw)};
+	uORB::Publication<vehicle_thrust_setpoint_s> thrust_mc_pub{ORB_ID(vehicle_thrust_setpoint_virtual_mc)};
+	uORB::Publication<vehicle_thrust_setpoint_s> thrust_fw_pub{ORB_ID(vehicle_thrust_setpoint_virtual_fw)};
+	uORB::Publication<vehicle_attitude_setpoint_s> mc_att_sp_pub{ORB_ID(mc_virtual_attitude_setpoint)};
+	uORB::Publication<vehicle_attitude_setpoint_s> fw_att_sp_pub{ORB_ID(fw_virtual_attitude_setpoint)};
+	uORB::Publication<vehicle_attitude_s> att_pub{ORB_ID(vehicle_attitude)};
+	uORB::Publication<vehicle_local_position_s> lpos_pub{ORB_ID(vehicle_local_position)};
+	uORB::Publication<airspeed_validated_s> airspeed_pub{ORB_ID(airspeed_validated)};
+	uORB::Publication<vehicle_control_mode_s> control_mode_pub{ORB_ID(vehicle_control_mode)};
+	uORB::Publication<vehicle_status_s> status_pub{ORB_ID(vehicle_status)};
+	uORB::Publication<vehicle_land_detected_s> land_pub{ORB_ID(vehicle_land_detected)};
+	uORB::Publication<vehicle_command_s> cmd_pub{ORB_ID(vehicle_command)};
+	uORB::Publication<normalized_unsigned_setpoint_s> fw_flaps_pub{ORB_ID(flaps_setpoint)};
+
+	char name[] = "vtol_att_control";
+
+	if (VtolAttitudeControl::spawn(clock) != 0) {
+		return 1;
+	}
+
+	uORB::Subscription torque0_sub{ORB_ID(vehicle_torque_setpoint), 0};
+	uORB::Subscription thrust0_sub{ORB_ID(vehicle_thrust_setpoint), 0};
+	uORB::Subscription torque1_sub{ORB_ID(vehicle_torque_setpoint), 1};
+	uORB::Subscription thrust1_sub{ORB_ID(vehicle_thrust_setpoint), 1};
+	uORB::Subscription att_sp_sub{ORB_ID(vehicle_attitude_setpoint)};
+	uORB::Subscription vtol_status_sub{ORB_ID(vtol_vehicle_status)};
+	uORB::Subscription flaps_sub{ORB_ID(flaps_setpoint)};
+
+	uint64_t checksum = 1469598103934665603ull;
+	unsigned outputs = 0;
+	unsigned runs = 0;
+	uint8_t last_state = 0;
+	float last_flaps = NAN;
+
+	// attitude follows the published setpoint (perfect tracking) with a small disturbance
+	float q_track[4];
+	quat_from_euler(0.f, 0.f, 0.3f, q_track);
+
+	const hrt_abstime dt = 4000; // 250 Hz virtual controllers
+	const hrt_abstime t_start = clock.now();
+	bool fw_cmd_sent = false;
+	bool mc_cmd_sent = false;
+
+	// shell command run against the cycling controller
+	char bench_cmd[] = "bench";
+	char replay_cmd[] = "quadchute_replay";
+	char *command = bench_duration != nullptr ? bench_cmd : (replay_horizon != nullptr ? replay_cmd : nullptr);
+	const char *command_arg = bench_duration != nullptr ? bench_duration : replay_horizon;
+
+	std::atomic<bool> command_running{command != nullptr};
+	std::thread command_thread;
+
+	if (command != nullptr) {
+		command_thread = std::thread([&]() {
+			char *command_argv[] = {name, command, const_cast<char *>(command_arg), nullptr};
+			vtol_att_control_main(3, command_argv);
+			command_running = false;
+		});
+	}
+
+	while (clock.now() - t_start < hrt_abstime(duration * 1e6f) || command_running) {
+		const hrt_abstime now = clock.now();
+		const float t = (now - t_start) * 1e-6f;
+
+		// slow topics at 10 Hz
+		if (((now - t_start) / dt) % 25 == 0) {
+			vehicle_status_s status{};
+			status.timestamp = now;
+			status.nav_state = auto_mission ? vehicle_status_s::NAVIGATION_STATE_AUTO_MISSION
+					   : vehicle_status_s::NAVIGATION_STATE_POSCTL;
+			status.is_vtol = true;
+			status_pub.publish(status);
+
+			vehicle_control_mode_s control_mode{};
+			control_mode.timestamp = now;
+			control_mode.flag_armed = replay_horizon == nullptr;
+			control_mode.flag_control_auto_enabled = auto_mission;
+			control_mode.flag_control_altitude_enabled = true;
+			control_mode.flag_control_climb_rate_enabled = true;
+			control_mode.flag_control_attitude_enabled = true;
+			control_mode.flag_control_rates_enabled = true;
+			control_mode_pub.publish(control_mode);
+
+			vehicle_land_detected_s land{};
+			land.timestamp = now;
+			land.landed = false;
+			land_pub.publish(land);
+
+			airspeed_validated_s airspeed{};
+			airspeed.timestamp = now;
+			airspeed.calibrated_airspeed_m_s = fminf(t > 2.f ? (t - 2.f) * 3.f : 0.f, 18.f);
+			airspeed.true_airspeed_m_s = airspeed.calibrated_airspeed_m_s;
+			airspeed.airspeed_sensor_measurement_valid = true;
+			airspeed_pub.publish(airspeed);
+		}
+
+		if (!fw_cmd_sent && t > 2.f) {
+			vehicle_command_s cmd{};
+			cmd.timestamp = now;
+			cmd.command = vehicle_command_s::VEHICLE_CMD_DO_VTOL_TRANSITION;
+			cmd.param1 = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW;
+			cmd_pub.publish(cmd);
+			fw_cmd_sent = true;
+		}
+
+		if (!mc_cmd_sent && t > back_transition_time) {
+			vehicle_command_s cmd{};
+			cmd.timestamp = now;
+			cmd.command = vehicle_command_s::VEHICLE_CMD_DO_VTOL_TRANSITION;
+			cmd.param1 = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_MC;
+			cmd_pub.publish(cmd);
+			mc_cmd_sent = true;
+		}
+
+		vehicle_attitude_s att{};
+		att.timestamp = now;
+		att.timestamp_sample = now - 500;
+		float q_dist[4];
+		quat_from_euler(0.01f * sinf(t), 0.01f * cosf(0.7f * t), 0.f, q_dist);
+		att.q[0] = q_track[0] * q_dist[0] - q_track[1] * q_dist[1] - q_track[2] * q_dist[2] - q_track[3] * q_dist[3];
+		att.q[1] = q_track[0] * q_dist[1] + q_track[1] * q_dist[0] + q_track[2] * q_dist[3] - q_track[3] * q_dist[2];
+		att.q[2] = q_track[0] * q_dist[2] - q_track[1] * q_dist[3] + q_track[2] * q_dist[0] + q_track[3] * q_dist[1];
+		att.q[3] = q_track[0] * q_dist[3] + q_track[1] * q_dist[2] - q_track[2] * q_dist[1] + q_track[3] * q_dist[0];
+		att_pub.publish(att);
+
+		vehicle_local_position_s lpos{};
+		lpos.timestamp = now;
+		lpos.timestamp_sample = now - 500;
+		lpos.xy_valid = lpos.z_valid = lpos.v_xy_valid = lpos.v_z_valid = true;
+		lpos.z = -30.f + 0.5f * sinf(0.3f * t);
+		lpos.vx = fminf(t > 2.f ? (t - 2.f) * 3.f : 0.f, 18.f);
+		lpos.vy = 0.5f;
+		lpos.vz = 0.15f * cosf(0.3f * t);
+		lpos.dist_bottom = 30.f;
+		lpos.dist_bottom_valid = true;
+		lpos_pub.publish(lpos);
+
+		vehicle_attitude_setpoint_s mc_sp{};
+		mc_sp.timestamp = now;
+		quat_from_euler(0.f, -0.05f, 0.3f, mc_sp.q_d);
+		mc_sp.thrust_body[2] = -0.6f;
+		mc_att_sp_pub.publish(mc_sp);
+
+		vehicle_attitude_setpoint_s fw_sp{};
+		fw_sp.timestamp = now;
+		quat_from_euler(0.02f, 0.05f, 0.3f, fw_sp.q_d);
+		fw_sp.thrust_body[0] = 0.55f;
+		fw_att_sp_pub.publish(fw_sp);
+
+		vehicle_torque_setpoint_s torque{};
+		torque.timestamp = now;
+		torque.timestamp_sample = now - 300;
+		torque.xyz[0] = 0.01f * sinf(5.f * t);
+		torque.xyz[1] = 0.02f * cosf(3.f * t);
+		torque.xyz[2] = 0.005f;
+
+		vehicle_thrust_setpoint_s thrust{};
+		thrust.timestamp = now;
+		thrust.timestamp_sample = now - 300;
+		thrust.xyz[2] = -0.6f;
+
+		if (auto_mission && last_state == vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW) {
+			// FW position controller deflection
+			normalized_unsigned_setpoint_s flaps{};
+			flaps.timestamp = now;
+			flaps.normalized_setpoint = 0.5f;
+			fw_flaps_pub.publish(flaps);
+		}
+
+		thrust_mc_pub.publish(thrust);
+		torque_mc_pub.publish(torque);
+		runs += px4::work_queue_run_pending();
+
+		thrust.xyz[0] = 0.55f;
+		thrust.xyz[2] = 0.f;
+		torque.xyz[0] *= 0.5f;
+		thrust_fw_pub.publish(thrust);
+		torque_fw_pub.publish(torque);
+		runs += px4::work_queue_run_pending();
+
+		vehicle_torque_setpoint_s torque_out;
+		vehicle_thrust_setpoint_s thrust_out;
+		vehicle_attitude_setpoint_s att_sp_out;
+		vtol_vehicle_status_s vtol_status;
+
+		if (torque0_sub.update(&torque_out)) {
+			checksum = fnv1a(checksum, torque_out.xyz, sizeof(torque_out.xyz));
+			outputs++;
+		}
+
+		if (torque1_sub.update(&torque_out)) {
+			checksum = fnv1a(checksum, torque_out.xyz, sizeof(torque_out.xyz));
+			outputs++;
+		}
+
+		if (thrust0_sub.update(&thrust_out)) {
+			checksum = fnv1a(checksum, thrust_out.xyz, sizeof(thrust_out.xyz));
+			outputs++;
+		}
+
+		if (thrust1_sub.update(&thrust_out)) {
+			checksum = fnv1a(checksum, thrust_out.xyz, sizeof(thrust_out.xyz));
+			outputs++;
+		}
+
+		if (att_sp_sub.update(&att_sp_out)) {
+			checksum = fnv1a(checksum, att_sp_out.q_d, sizeof(att_sp_out.q_d));
+			outputs++;
+			memcpy(q_track, att_sp_out.q_d, sizeof(q_track));
+		}
+
+		if (vtol_status_sub.update(&vtol_status) && vtol_status.vehicle_vtol_state != last_state) {
+			last_state = vtol_status.vehicle_vtol_state;
+
+			if (trace) {
+				printf("t=%.3f vtol_state=%u fw_failure=%d\n", (double)t, last_state, vtol_status.fixed_wing_system_failure);
+			}
+		}
+
+		normalized_unsigned_setpoint_s flaps_out;
+
+		if (flaps_sub.update(&flaps_out) && !(flaps_out.normalized_setpoint == last_flaps)) {
+			last_flaps = flaps_out.normalized_setpoint;
+
+			if (trace) {
+				printf("t=%.3f flaps=%.2f\n", (double)t, (double)last_flaps);
+			}
+		}
+
+		clock.advance(dt);
+		hrt_set_absolute_time(clock.now());
+	}
+
+	if (command_thread.joinable()) {
+		command_thread.join();
+	}
+
+	if (trace) {
+		// tilt of the last attitude setpoint from hover (MC frame for a tailsitter)
+		const float cos_tilt = q_track[0] * q_track[0] - q_track[1] * q_track[1] - q_track[2] * q_track[2]
+				       + q_track[3] * q_track[3];
+		printf("setpoint tilt %.2f deg\n", (double)(acosf(fmaxf(fminf(cos_tilt, 1.f), -1.f)) * 180.f / (float)M_PI));
+	}
+
+	char status_cmd[] = "status";
+	char *status_argv[] = {name, status_cmd, nullptr};
+	vtol_att_control_main(2, status_argv);
+
+	printf("runs %u outputs %u checksum %016llx\n", runs, outputs, (unsigned long long)checksum);
+	return 0;
+}
@@ -0,0 +1,32 @@
+/**
+ * @file hrt.cpp
+ * @brief Host simulated high-resolution timer.
+ */
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/posix.h>
+
+static hrt_abstime host_time{0};
+
+hrt_abstime hrt_absolute_time()
+{
+	return host_time;
+}
+
+void hrt_set_absolute_time(hrt_abstime now)
+{
+	if (now > host_time) {
+		host_time = now;
+	}
+}
+
+void hrt_advance_time(hrt_abstime dt)
+{
+	host_time += dt;
+}
+
+int px4_usleep(unsigned usec)
+{
+	// only shell commands sleep (bench), they wait in wall-clock time while the driver steps the simulated time
+	return usleep(usec);
+}
@@ -0,0 +1,117 @@
+/**
+ * @file param.cpp
+ * @brief Host parameter store, initialised from the generated parameter table.
+ */
+
+#include <parameters/param.h>
+#include <parameters/px4_parameters.hpp>
+
+#include <drivers/drv_hrt.h>
+#include <uORB/Publication.hpp>
+#include <uORB/topics/parameter_update.h>
+
+#include <string.h>
+
+namespace
+{
+
+union param_value_u {
+	int32_t i;
+	float f;
+};
+
+param_value_u values[px4::param_table_size];
+bool initialised{false};
+uint32_t instance_count{0};
+
+void init_values()
+{
+	if (!initialised) {
+		for (unsigned i = 0; i < px4::param_table_size; i++) {
+			if (px4::param_table[i].type == PARAM_TYPE_FLOAT) {
+				values[i].f = px4::param_table[i].default_float;
+
+			} else {
+				values[i].i = px4::param_table[i].default_int;
+			}
+		}
+
+		initialised = true;
+	}
+}
+
+} // namespace
+
+param_t param_find(const char *name)
+{
+	for (unsigned i = 0; i < px4::param_table_size; i++) {
+		if (strcmp(px4::param_table[i].name, name) == 0) {
+			return static_cast<param_t>(i);
+		}
+	}
+
+	return PARAM_INVALID;
+}
+
+unsigned param_count()
+{
+	return px4::param_table_size;
+}
+
+const char *param_name(param_t param)
+{
+	return param < px4::param_table_size ? px4::param_table[param].name : nullptr;
+}
+
+param_type_t param_type(param_t param)
+{
+	return param < px4::param_table_size ? px4::param_table[param].type : PARAM_TYPE_UNKNOWN;
+}
+
+int param_get(param_t param, void *val)
+{
+	if (param >= px4::param_table_size || val == nullptr) {
+		return -1;
+	}
+
+	init_values();
+	memcpy(val, &values[param], sizeof(int32_t));
+	return 0;
+}
+
+int param_set_no_notification(param_t param, const void *val)
+{
+	if (param >= px4::param_table_size || val == nullptr) {
+		return -1;
+	}
+
+	init_values();
+	memcpy(&values[param], val, sizeof(int32_t));
+	return 0;
+}
+
+void param_notify_changes()
+{
+	parameter_update_s pupdate{};
+	pupdate.timestamp = hrt_absolute_time();
+	pupdate.instance = ++instance_count;
+	uORB::Publication<parameter_update_s> pub{ORB_ID(parameter_update)};
+	pub.publish(pupdate);
+}
+
+int param_set(param_t param, const void *val)
+{
+	const int ret = param_set_no_notification(param, val);
+
+	if (ret == 0) {
+		param_notify_changes();
+	}
+
+	return ret;
+}
+
+void param_reset_all()
+{
+	initialised = false;
+	init_values();
+}
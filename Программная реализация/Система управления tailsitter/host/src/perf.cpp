@@ -0,0 +1,170 @@
+/**
+ * @file perf.cpp
+ * @brief Host performance counters backed by the steady clock.
+ */
+
+#include <lib/perf/perf_counter.h>
+
+#include <drivers/drv_hrt.h>
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct perf_ctr_header {
+	perf_counter_type type;
+	const char *name;
+	uint64_t event_count;
+	uint64_t time_start;
+	uint64_t time_total;
+	uint64_t time_least;
+	uint64_t time_most;
+	float mean;
+	float M2;
+};
+
+static uint64_t steady_us()
+{
+	using namespace std::chrono;
+	return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+perf_counter_t perf_alloc(enum perf_counter_type type, const char *name)
+{
+	perf_counter_t ctr = static_cast<perf_counter_t>(calloc(1, sizeof(perf_ctr_header)));
+
+	if (ctr) {
+		ctr->type = type;
+		ctr->name = name;
+		ctr->time_least = UINT64_MAX;
+	}
+
+	return ctr;
+}
+
+void perf_free(perf_counter_t handle)
+{
+	free(handle);
+}
+
+void perf_count(perf_counter_t handle)
+{
+	if (handle == nullptr) {
+		return;
+	}
+
+	if (handle->type == PC_INTERVAL) {
+		// intervals follow the (simulated) hrt time like on the target
+		const uint64_t now = hrt_absolute_time();
+
+		if (handle->event_count > 0) {
+			const uint64_t interval = now - handle->time_start;
+			handle->time_total += interval;
+
+			if (interval < handle->time_least) {
+				handle->time_least = interval;
+			}
+
+			if (interval > handle->time_most) {
+				handle->time_most = interval;
+			}
+
+			const float dt = interval / 1e6f;
+			const float delta = dt - handle->mean;
+			handle->mean += delta / handle->event_count;
+			handle->M2 += delta * (dt - handle->mean);
+		}
+
+		handle->time_start = now;
+	}
+
+	handle->event_count++;
+}
+
+void perf_begin(perf_counter_t handle)
+{
+	if (handle) {
+		handle->time_start = steady_us();
+	}
+}
+
+void perf_end(perf_counter_t handle)
+{
+	if (handle == nullptr || handle->time_start == 0) {
+		return;
+	}
+
+	const uint64_t elapsed = steady_us() - handle->time_start;
+	handle->event_count++;
+	handle->time_total += elapsed;
+
+	if (elapsed < handle->time_least) {
+		handle->time_least = elapsed;
+	}
+
+	if (elapsed > handle->time_most) {
+		handle->time_most = elapsed;
+	}
+
+	// Welford's online mean
+	const float dt = elapsed / 1e6f;
+	const float delta = dt - handle->mean;
+	handle->mean += delta / handle->event_count;
+	handle->M2 += delta * (dt - handle->mean);
+	handle->time_start = 0;
+}
+
+void perf_cancel(perf_counter_t handle)
+{
+	if (handle) {
+		handle->time_start = 0;
+	}
+}
+
+void perf_reset(perf_counter_t handle)
+{
+	if (handle) {
+		const perf_counter_type type = handle->type;
+		const char *name = handle->name;
+		memset(handle, 0, sizeof(*handle));
+		handle->type = type;
+		handle->name = name;
+		handle->time_least = UINT64_MAX;
+	}
+}
+
+void perf_print_counter(perf_counter_t handle)
+{
+	if (handle == nullptr) {
+		return;
+	}
+
+	if (handle->type == PC_ELAPSED && handle->event_count > 0) {
+		printf("%s: %llu events, %lluus elapsed, %.2fus avg, min %lluus max %lluus\n",
+		       handle->name, (unsigned long long)handle->event_count, (unsigned long long)handle->time_total,
+		       (double)handle->time_total / handle->event_count,
+		       (unsigned long long)handle->time_least, (unsigned long long)handle->time_most);
+
+	} else if (handle->type == PC_INTERVAL && handle->event_count > 1) {
+		const uint64_t intervals = handle->event_count - 1;
+		printf("%s: %llu events, %.2fus avg, min %lluus max %lluus %5.3fus rms\n",
+		       handle->name, (unsigned long long)handle->event_count, (double)handle->time_total / intervals,
+		       (unsigned long long)handle->time_least, (unsigned long long)handle->time_most,
+		       (double)(1e6f * sqrtf(handle->M2 / (intervals > 1 ? intervals - 1 : 1))));
+
+	} else {
+		printf("%s: %llu events\n", handle->name, (unsigned long long)handle->event_count);
+	}
+}
+
+uint64_t perf_event_count(perf_counter_t handle)
+{
+	return handle ? handle->event_count : 0;
+}
+
+float perf_mean(perf_counter_t handle)
+{
+	return handle ? handle->mean : 0.f;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file uORB.cpp
+ * @brief Host in-process uORB broker.
+ */
+
+#include <uORB/uORB.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace uORB
+{
+
+class DeviceNode
+{
+public:
+	const orb_metadata *meta;
+	uint8_t instance;
+	bool advertised{false};
+	unsigned generation{0};
+	uint8_t *data{nullptr};
+	std::vector<px4::WorkItem *> callbacks;
+};
+
+static std::vector<DeviceNode *> &nodes()
+{
+	static std::vector<DeviceNode *> all;
+	return all;
+}
+
+DeviceNode *get_node(const orb_metadata *meta, uint8_t instance)
+{
+	for (DeviceNode *node : nodes()) {
+		if (node->meta == meta && node->instance == instance) {
+			return node;
+		}
+	}
+
+	DeviceNode *node = new DeviceNode();
+	node->meta = meta;
+	node->instance = instance;
+	node->data = static_cast<uint8_t *>(calloc(1, meta->o_size));
+	nodes().push_back(node);
+	return node;
+}
+
+bool node_advertised(const DeviceNode *node)
+{
+	return node && node->advertised;
+}
+
+int advertise(const orb_metadata *meta, bool multi, int instance)
+{
+	if (!multi) {
+		DeviceNode *node = get_node(meta, instance < 0 ? 0 : instance);
+		node->advertised = true;
+		return node->instance;
+	}
+
+	for (uint8_t i = 0; i < ORB_MULTI_MAX_INSTANCES; i++) {
+		DeviceNode *node = get_node(meta, i);
+
+		if (!node->advertised) {
+			node->advertised = true;
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+bool publish(const orb_metadata *meta, uint8_t instance, const void *data)
+{
+	DeviceNode *node = get_node(meta, instance);
+	memcpy(node->data, data, meta->o_size);
+	node->advertised = true;
+	node->generation++;
+
+	for (px4::WorkItem *item : node->callbacks) {
+		item->ScheduleNow();
+	}
+
+	return true;
+}
+
+bool copy(DeviceNode *node, void *dst, unsigned &last_generation, bool only_if_updated)
+{
+	if (node == nullptr || node->generation == 0) {
+		return false;
+	}
+
+	if (only_if_updated && node->generation == last_generation) {
+		return false;
+	}
+
+	memcpy(dst, node->data, node->meta->o_size);
+	last_generation = node->generation;
+	return true;
+}
+
+unsigned generation(const DeviceNode *node)
+{
+	return node ? node->generation : 0;
+}
+
+void register_callback(DeviceNode *node, px4::WorkItem *item)
+{
+	node->callbacks.push_back(item);
+}
+
+void unregister_callback(DeviceNode *node, px4::WorkItem *item)
+{
+	for (size_t i = 0; i < node->callbacks.size(); i++) {
+		if (node->callbacks[i] == item) {
+			node->callbacks.erase(node->callbacks.begin() + i);
+			return;
+		}
+	}
+}
+
+void reset_all()
+{
+	for (DeviceNode *node : nodes()) {
+		free(node->data);
+		delete node;
+	}
+
+	nodes().clear();
+}
+
+} // namespace uORB
@@ -0,0 +1,161 @@
+/**
+ * @file work_queue.cpp
+ * @brief Host single-threaded work queue scheduler.
+ */
+
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+
+#include <stddef.h>
+#include <vector>
+
+namespace px4
+{
+
+static std::vector<WorkItem *> &items()
+{
+	static std::vector<WorkItem *> all;
+	return all;
+}
+
+static std::vector<ScheduledWorkItem *> &scheduled_items()
+{
+	static std::vector<ScheduledWorkItem *> all;
+	return all;
+}
+
+WorkItem::WorkItem(const char *name, const wq_config_t &config) :
+	_item_name(name),
+	_config(config)
+{
+	items().push_back(this);
+}
+
+WorkItem::~WorkItem()
+{
+	Deinit();
+
+	for (size_t i = 0; i < items().size(); i++) {
+		if (items()[i] == this) {
+			items().erase(items().begin() + i);
+			break;
+		}
+	}
+}
+
+bool WorkItem::Init(const wq_config_t &config)
+{
+	_config = config;
+	return true;
+}
+
+void WorkItem::Deinit()
+{
+	_pending = false;
+}
+
+void WorkItem::ScheduleNow()
+{
+	_pending = true;
+}
+
+void WorkItem::ScheduleClear()
+{
+	_pending = false;
+}
+
+void WorkItem::RunPreamble()
+{
+	_pending = false;
+	_run_count++;
+	Run();
+}
+
+void ScheduledWorkItem::ScheduleDelayed(uint32_t delay_us)
+{
+	_interval_us = 0;
+	_next_run = hrt_absolute_time() + delay_us;
+
+	bool known = false;
+
+	for (ScheduledWorkItem *item : scheduled_items()) {
+		known |= (item == this);
+	}
+
+	if (!known) {
+		scheduled_items().push_back(this);
+	}
+}
+
+void ScheduledWorkItem::ScheduleOnInterval(uint32_t interval_us, uint32_t delay_us)
+{
+	ScheduleDelayed(delay_us);
+	_interval_us = interval_us;
+}
+
+void ScheduledWorkItem::ScheduleClear()
+{
+	_next_run = 0;
+	_interval_us = 0;
+	WorkItem::ScheduleClear();
+}
+
+void ScheduledWorkItem::CheckDeadline(hrt_abstime now)
+{
+	if (_next_run != 0 && now >= _next_run) {
+		ScheduleNow();
+
+		if (_interval_us > 0) {
+			// keep the phase of the interval, skip missed slots like the real scheduler
+			while (_next_run <= now) {
+				_next_run += _interval_us;
+			}
+
+		} else {
+			_next_run = 0;
+		}
+	}
+}
+
+ScheduledWorkItem::~ScheduledWorkItem()
+{
+	for (size_t i = 0; i < scheduled_items().size(); i++) {
+		if (scheduled_items()[i] == this) {
+			scheduled_items().erase(scheduled_items().begin() + i);
+			break;
+		}
+	}
+}
+
+unsigned work_queue_run_pending()
+{
+	unsigned runs = 0;
+	const hrt_abstime now = hrt_absolute_time();
+
+	for (ScheduledWorkItem *item : scheduled_items()) {
+		item->CheckDeadline(now);
+	}
+
+	bool ran = true;
+
+	while (ran) {
+		ran = false;
+		WorkItem *next = nullptr;
+
+		for (WorkItem *item : items()) {
+			if (item->pending() && (next == nullptr
+						|| item->WorkQueueConfig().relative_priority > next->WorkQueueConfig().relative_priority)) {
+				next = item;
+			}
+		}
+
+		if (next) {
+			next->RunPreamble();
+			runs++;
+			ran = true;
+		}
+	}
+
+	return runs;
+}
+
+} // namespace px4
@@ -0,0 +1,45 @@
+/**
+ * @file drv_hrt.h
+ * @brief Host stand-in for the PX4 high-resolution timer.
+ *
+ * Time starts at zero and only moves when the host driver advances it, so every
+ * run of the controller is deterministic and can go faster than wall-clock time.
+ * Code durations are measured on the host monotonic clock instead (measurement_time_ns()).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef uint64_t hrt_abstime;
+
+/**
+ * @return Current host time [us]
+ */
+hrt_abstime hrt_absolute_time();
+
+/**
+ * Set the host time [us]. Time never moves backwards.
+ */
+void hrt_set_absolute_time(hrt_abstime now);
+
+/**
+ * Advance the host time by dt [us].
+ */
+void hrt_advance_time(hrt_abstime dt);
+
+static inline hrt_abstime hrt_elapsed_time(const hrt_abstime *then)
+{
+	return hrt_absolute_time() - *then;
+}
+
+namespace time_literals
+{
+
+constexpr hrt_abstime operator "" _s(unsigned long long seconds) { return hrt_abstime(seconds * 1000000ULL); }
+constexpr hrt_abstime operator "" _s(long double seconds) { return hrt_abstime(seconds * 1000000ULL); }
+constexpr hrt_abstime operator "" _ms(unsigned long long milliseconds) { return hrt_abstime(milliseconds * 1000ULL); }
+constexpr hrt_abstime operator "" _ms(long double milliseconds) { return hrt_abstime(milliseconds * 1000ULL); }
+constexpr hrt_abstime operator "" _us(unsigned long long microseconds) { return hrt_abstime(microseconds); }
+
+} // namespace time_literals
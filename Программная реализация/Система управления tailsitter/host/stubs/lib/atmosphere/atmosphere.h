@@ -0,0 +1,13 @@
+/**
+ * @file atmosphere.h
+ * @brief Host stand-in for the PX4 atmosphere library (constants only).
+ */
+
+#pragma once
+
+namespace atmosphere
+{
+
+static constexpr float kAirDensitySeaLevelStandardAtmos = 1.225f; // [kg/m^3]
+
+} // namespace atmosphere
@@ -0,0 +1,66 @@
+/**
+ * @file mathlib.h
+ * @brief Host stand-in for the subset of PX4 mathlib used by vtol_att_control.
+ */
+
+#pragma once
+
+#include <float.h>
+#include <math.h>
+#include <px4_platform_common/defines.h>
+
+namespace math
+{
+
+template<typename T>
+constexpr const T &min(const T &a, const T &b)
+{
+	return (a < b) ? a : b;
+}
+
+template<typename T>
+constexpr const T &max(const T &a, const T &b)
+{
+	return (a > b) ? a : b;
+}
+
+template<typename T>
+constexpr T constrain(T val, T min_val, T max_val)
+{
+	return (val < min_val) ? min_val : ((val > max_val) ? max_val : val);
+}
+
+template<typename T>
+constexpr T radians(T degrees)
+{
+	return degrees * (static_cast<T>(M_PI) / static_cast<T>(180));
+}
+
+template<typename T>
+constexpr T degrees(T radians)
+{
+	return radians * (static_cast<T>(180) / static_cast<T>(M_PI));
+}
+
+template<typename T>
+const T expo(const T &value, const T &e)
+{
+	const T x = constrain(value, (T) - 1, (T) 1);
+	const T ec = constrain(e, (T) 0, (T) 1);
+	return (1 - ec) * x + ec * x * x * x;
+}
+
+template<typename T>
+int countSetBits(T n)
+{
+	int count = 0;
+
+	while (n) {
+		count += n & 1;
+		n >>= 1;
+	}
+
+	return count;
+}
+
+} // namespace math
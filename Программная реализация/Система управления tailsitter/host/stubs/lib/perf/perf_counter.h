@@ -0,0 +1,31 @@
+/**
+ * @file perf_counter.h
+ * @brief Host stand-in for the PX4 performance counters.
+ *
+ * Elapsed counters measure real (steady clock) time, independent of the
+ * simulated hrt time, so host benchmarks report actual CPU cost.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+enum perf_counter_type {
+	PC_COUNT,
+	PC_ELAPSED,
+	PC_INTERVAL
+};
+
+struct perf_ctr_header;
+typedef struct perf_ctr_header *perf_counter_t;
+
+perf_counter_t perf_alloc(enum perf_counter_type type, const char *name);
+void perf_free(perf_counter_t handle);
+void perf_count(perf_counter_t handle);
+void perf_begin(perf_counter_t handle);
+void perf_end(perf_counter_t handle);
+void perf_cancel(perf_counter_t handle);
+void perf_reset(perf_counter_t handle);
+void perf_print_counter(perf_counter_t handle);
+uint64_t perf_event_count(perf_counter_t handle);
+float perf_mean(perf_counter_t handle);
@@ -0,0 +1,416 @@
+/**
+ * @file math.hpp
+ * @brief Host stand-in for the subset of the PX4 matrix library used by vtol_att_control.
+ *
+ * Conventions follow PX4: Hamilton quaternions (w, x, y, z) rotating body to earth frame,
+ * Dcm as body to earth rotation matrix and 3-2-1 (yaw, pitch, roll) Euler angles.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <string.h>
+
+namespace matrix
+{
+
+template<typename Type>
+Type wrap_pi(Type x)
+{
+	const Type pi = static_cast<Type>(M_PI);
+
+	if (!isfinite(x)) {
+		return x;
+	}
+
+	while (x >= pi) {
+		x -= 2 * pi;
+	}
+
+	while (x < -pi) {
+		x += 2 * pi;
+	}
+
+	return x;
+}
+
+template<typename Type>
+class Vector2
+{
+public:
+	Vector2() = default;
+	Vector2(Type x, Type y) : _data{x, y} {}
+
+	Type &operator()(size_t i) { return _data[i]; }
+	Type operator()(size_t i) const { return _data[i]; }
+
+	Vector2 operator*(Type s) const { return Vector2(_data[0] * s, _data[1] * s); }
+	Vector2 operator/(Type s) const { return *this * (Type(1) / s); }
+
+	Type dot(const Vector2 &o) const { return _data[0] * o._data[0] + _data[1] * o._data[1]; }
+	Type norm() const { return sqrt(dot(*this)); }
+	Type norm_squared() const { return dot(*this); }
+
+	void normalize() { *this = *this / norm(); }
+	Vector2 normalized() const { return *this / norm(); }
+
+private:
+	Type _data[2] {};
+};
+
+template<typename Type>
+class Vector3
+{
+public:
+	Vector3() = default;
+	Vector3(Type x, Type y, Type z) : _data{x, y, z} {}
+	explicit Vector3(const Type data[3]) { memcpy(_data, data, sizeof(_data)); }
+
+	Type &operator()(size_t i) { return _data[i]; }
+	Type operator()(size_t i) const { return _data[i]; }
+
+	Vector3 operator+(const Vector3 &o) const { return Vector3(_data[0] + o._data[0], _data[1] + o._data[1], _data[2] + o._data[2]); }
+	Vector3 operator-(const Vector3 &o) const { return Vector3(_data[0] - o._data[0], _data[1] - o._data[1], _data[2] - o._data[2]); }
+	Vector3 operator-() const { return Vector3(-_data[0], -_data[1], -_data[2]); }
+	Vector3 operator*(Type s) const { return Vector3(_data[0] * s, _data[1] * s, _data[2] * s); }
+	Vector3 operator/(Type s) const { return *this * (Type(1) / s); }
+
+	Type dot(const Vector3 &o) const { return _data[0] * o._data[0] + _data[1] * o._data[1] + _data[2] * o._data[2]; }
+	Type operator*(const Vector3 &o) const { return dot(o); }
+
+	Vector3 cross(const Vector3 &b) const
+	{
+		const Vector3 &a = *this;
+		return Vector3(a(1) * b(2) - a(2) * b(1), -a(0) * b(2) + a(2) * b(0), a(0) * b(1) - a(1) * b(0));
+	}
+
+	Vector3 operator%(const Vector3 &b) const { return cross(b); }
+
+	Type norm() const { return sqrt(dot(*this)); }
+	Type norm_squared() const { return dot(*this); }
+	Type length() const { return norm(); }
+
+	void normalize() { *this = *this / norm(); }
+	Vector3 normalized() const { return *this / norm(); }
+	Vector3 unit() const { return normalized(); }
+
+	void copyTo(Type dst[3]) const { memcpy(dst, _data, sizeof(_data)); }
+
+private:
+	Type _data[3] {};
+};
+
+template<typename Type>
+Vector3<Type> operator*(Type s, const Vector3<Type> &v)
+{
+	return v * s;
+}
+
+template<typename Type> class Dcm;
+template<typename Type> class Euler;
+template<typename Type> class AxisAngle;
+
+template<typename Type>
+class Quaternion
+{
+public:
+	Quaternion() : _data{1, 0, 0, 0} {}
+	Quaternion(Type a, Type b, Type c, Type d) : _data{a, b, c, d} {}
+	explicit Quaternion(const Type data[4]) { memcpy(_data, data, sizeof(_data)); }
+
+	Quaternion(const Dcm<Type> &R)
+	{
+		const Type t = R(0, 0) + R(1, 1) + R(2, 2);
+
+		if (t > Type(0)) {
+			Type s = sqrt(t + Type(1));
+			_data[0] = Type(0.5) * s;
+			s = Type(0.5) / s;
+			_data[1] = (R(2, 1) - R(1, 2)) * s;
+			_data[2] = (R(0, 2) - R(2, 0)) * s;
+			_data[3] = (R(1, 0) - R(0, 1)) * s;
+
+		} else {
+			// Find maximum diagonal element in dcm
+			size_t dcm_i = 0;
+
+			for (size_t i = 1; i < 3; i++) {
+				if (R(i, i) > R(dcm_i, dcm_i)) {
+					dcm_i = i;
+				}
+			}
+
+			const size_t dcm_j = (dcm_i + 1) % 3;
+			const size_t dcm_k = (dcm_i + 2) % 3;
+
+			Type s = sqrt((R(dcm_i, dcm_i) - R(dcm_j, dcm_j) - R(dcm_k, dcm_k)) + Type(1));
+			_data[dcm_i + 1] = s * Type(0.5);
+			s = Type(0.5) / s;
+			_data[dcm_j + 1] = (R(dcm_i, dcm_j) + R(dcm_j, dcm_i)) * s;
+			_data[dcm_k + 1] = (R(dcm_k, dcm_i) + R(dcm_i, dcm_k)) * s;
+			_data[0] = (R(dcm_k, dcm_j) - R(dcm_j, dcm_k)) * s;
+		}
+	}
+
+	Quaternion(const Euler<Type> &euler)
+	{
+		const Type cosPhi_2 = cos(euler.phi() / Type(2));
+		const Type cosTheta_2 = cos(euler.theta() / Type(2));
+		const Type cosPsi_2 = cos(euler.psi() / Type(2));
+		const Type sinPhi_2 = sin(euler.phi() / Type(2));
+		const Type sinTheta_2 = sin(euler.theta() / Type(2));
+		const Type sinPsi_2 = sin(euler.psi() / Type(2));
+		_data[0] = cosPhi_2 * cosTheta_2 * cosPsi_2 + sinPhi_2 * sinTheta_2 * sinPsi_2;
+		_data[1] = sinPhi_2 * cosTheta_2 * cosPsi_2 - cosPhi_2 * sinTheta_2 * sinPsi_2;
+		_data[2] = cosPhi_2 * sinTheta_2 * cosPsi_2 + sinPhi_2 * cosTheta_2 * sinPsi_2;
+		_data[3] = cosPhi_2 * cosTheta_2 * sinPsi_2 - sinPhi_2 * sinTheta_2 * cosPsi_2;
+	}
+
+	Quaternion(const AxisAngle<Type> &aa)
+	{
+		const Type angle = aa.norm();
+
+		if (angle < Type(1e-10)) {
+			_data[0] = 1;
+			_data[1] = _data[2] = _data[3] = 0;
+
+		} else {
+			const Vector3<Type> axis = aa.unit();
+			const Type magnitude = sin(angle / Type(2));
+			_data[0] = cos(angle / Type(2));
+			_data[1] = axis(0) * magnitude;
+			_data[2] = axis(1) * magnitude;
+			_data[3] = axis(2) * magnitude;
+		}
+	}
+
+	Type &operator()(size_t i) { return _data[i]; }
+	Type operator()(size_t i) const { return _data[i]; }
+
+	Quaternion operator*(const Quaternion &p) const
+	{
+		const Quaternion &q = *this;
+		return Quaternion(
+			       q(0) * p(0) - q(1) * p(1) - q(2) * p(2) - q(3) * p(3),
+			       q(1) * p(0) + q(0) * p(1) - q(3) * p(2) + q(2) * p(3),
+			       q(2) * p(0) + q(3) * p(1) + q(0) * p(2) - q(1) * p(3),
+			       q(3) * p(0) - q(2) * p(1) + q(1) * p(2) + q(0) * p(3));
+	}
+
+	Quaternion operator-() const { return Quaternion(-_data[0], -_data[1], -_data[2], -_data[3]); }
+
+	Type norm() const { return sqrt(_data[0] * _data[0] + _data[1] * _data[1] + _data[2] * _data[2] + _data[3] * _data[3]); }
+
+	void normalize()
+	{
+		const Type n = norm();
+
+		for (size_t i = 0; i < 4; i++) {
+			_data[i] /= n;
+		}
+	}
+
+	Quaternion normalized() const
+	{
+		Quaternion q = *this;
+		q.normalize();
+		return q;
+	}
+
+	Quaternion inversed() const
+	{
+		const Type n2 = _data[0] * _data[0] + _data[1] * _data[1] + _data[2] * _data[2] + _data[3] * _data[3];
+		return Quaternion(_data[0] / n2, -_data[1] / n2, -_data[2] / n2, -_data[3] / n2);
+	}
+
+	void invert() { *this = inversed(); }
+
+	Vector3<Type> imag() const { return Vector3<Type>(_data[1], _data[2], _data[3]); }
+
+	/**
+	 * Corresponding body z-axis to an attitude quaternion / last orthogonal unit basis vector
+	 */
+	Vector3<Type> dcm_z() const
+	{
+		const Quaternion &q = *this;
+		const Type a = q(0);
+		const Type b = q(1);
+		const Type c = q(2);
+		const Type d = q(3);
+		return Vector3<Type>(2 * (a * c + b * d), 2 * (c * d - a * b), a * a - b * b - c * c + d * d);
+	}
+
+	Vector3<Type> rotateVector(const Vector3<Type> &vec) const
+	{
+		return Dcm<Type>(*this) * vec;
+	}
+
+	void copyTo(Type dst[4]) const { memcpy(dst, _data, sizeof(_data)); }
+
+private:
+	Type _data[4];
+};
+
+template<typename Type>
+class Dcm
+{
+public:
+	Dcm()
+	{
+		for (size_t i = 0; i < 3; i++) {
+			for (size_t j = 0; j < 3; j++) {
+				_data[i][j] = (i == j) ? Type(1) : Type(0);
+			}
+		}
+	}
+
+	Dcm(const Quaternion<Type> &q)
+	{
+		const Type a = q(0);
+		const Type b = q(1);
+		const Type c = q(2);
+		const Type d = q(3);
+		const Type aa = a * a;
+		const Type ab = a * b;
+		const Type ac = a * c;
+		const Type ad = a * d;
+		const Type bb = b * b;
+		const Type bc = b * c;
+		const Type bd = b * d;
+		const Type cc = c * c;
+		const Type cd = c * d;
+		const Type dd = d * d;
+		_data[0][0] = aa + bb - cc - dd;
+		_data[0][1] = Type(2) * (bc - ad);
+		_data[0][2] = Type(2) * (ac + bd);
+		_data[1][0] = Type(2) * (bc + ad);
+		_data[1][1] = aa - bb + cc - dd;
+		_data[1][2] = Type(2) * (cd - ab);
+		_data[2][0] = Type(2) * (bd - ac);
+		_data[2][1] = Type(2) * (ab + cd);
+		_data[2][2] = aa - bb - cc + dd;
+	}
+
+	Dcm(const Euler<Type> &euler)
+	{
+		const Type cosPhi = cos(euler.phi());
+		const Type sinPhi = sin(euler.phi());
+		const Type cosThe = cos(euler.theta());
+		const Type sinThe = sin(euler.theta());
+		const Type cosPsi = cos(euler.psi());
+		const Type sinPsi = sin(euler.psi());
+
+		_data[0][0] = cosThe * cosPsi;
+		_data[0][1] = -cosPhi * sinPsi + sinPhi * sinThe * cosPsi;
+		_data[0][2] = sinPhi * sinPsi + cosPhi * sinThe * cosPsi;
+
+		_data[1][0] = cosThe * sinPsi;
+		_data[1][1] = cosPhi * cosPsi + sinPhi * sinThe * sinPsi;
+		_data[1][2] = -sinPhi * cosPsi + cosPhi * sinThe * sinPsi;
+
+		_data[2][0] = -sinThe;
+		_data[2][1] = sinPhi * cosThe;
+		_data[2][2] = cosPhi * cosThe;
+	}
+
+	Type &operator()(size_t i, size_t j) { return _data[i][j]; }
+	Type operator()(size_t i, size_t j) const { return _data[i][j]; }
+
+	Vector3<Type> operator*(const Vector3<Type> &v) const
+	{
+		return Vector3<Type>(
+			       _data[0][0] * v(0) + _data[0][1] * v(1) + _data[0][2] * v(2),
+			       _data[1][0] * v(0) + _data[1][1] * v(1) + _data[1][2] * v(2),
+			       _data[2][0] * v(0) + _data[2][1] * v(1) + _data[2][2] * v(2));
+	}
+
+	Dcm transpose() const
+	{
+		Dcm res;
+
+		for (size_t i = 0; i < 3; i++) {
+			for (size_t j = 0; j < 3; j++) {
+				res._data[i][j] = _data[j][i];
+			}
+		}
+
+		return res;
+	}
+
+	Dcm T() const { return transpose(); }
+
+	Vector3<Type> col(size_t j) const { return Vector3<Type>(_data[0][j], _data[1][j], _data[2][j]); }
+
+private:
+	Type _data[3][3];
+};
+
+template<typename Type>
+class Euler
+{
+public:
+	Euler() = default;
+	Euler(Type phi, Type theta, Type psi) : _data{phi, theta, psi} {}
+
+	Euler(const Dcm<Type> &dcm)
+	{
+		const Type pi_2 = static_cast<Type>(M_PI / 2);
+		Type theta = asin(-dcm(2, 0));
+		Type phi;
+		Type psi;
+
+		if (fabs(theta - pi_2) < Type(1.0e-3)) {
+			phi = 0;
+			psi = atan2(dcm(1, 2), dcm(0, 2));
+
+		} else if (fabs(theta + pi_2) < Type(1.0e-3)) {
+			phi = 0;
+			psi = atan2(-dcm(1, 2), -dcm(0, 2));
+
+		} else {
+			phi = atan2(dcm(2, 1), dcm(2, 2));
+			psi = atan2(dcm(1, 0), dcm(0, 0));
+		}
+
+		_data[0] = phi;
+		_data[1] = theta;
+		_data[2] = psi;
+	}
+
+	Euler(const Quaternion<Type> &q) : Euler(Dcm<Type>(q)) {}
+
+	Type &operator()(size_t i) { return _data[i]; }
+	Type operator()(size_t i) const { return _data[i]; }
+
+	Type phi() const { return _data[0]; }
+	Type theta() const { return _data[1]; }
+	Type psi() const { return _data[2]; }
+
+	Type &phi() { return _data[0]; }
+	Type &theta() { return _data[1]; }
+	Type &psi() { return _data[2]; }
+
+private:
+	Type _data[3] {};
+};
+
+template<typename Type>
+class AxisAngle : public Vector3<Type>
+{
+public:
+	AxisAngle() = default;
+	AxisAngle(Type x, Type y, Type z) : Vector3<Type>(x, y, z) {}
+	AxisAngle(const Vector3<Type> &axis, Type angle) : Vector3<Type>(axis.unit() * angle) {}
+
+	Vector3<Type> axis() const { return this->unit(); }
+	Type angle() const { return this->norm(); }
+};
+
+typedef Vector2<float> Vector2f;
+typedef Vector3<float> Vector3f;
+typedef Quaternion<float> Quatf;
+typedef Dcm<float> Dcmf;
+typedef Euler<float> Eulerf;
+typedef AxisAngle<float> AxisAnglef;
+
+} // namespace matrix
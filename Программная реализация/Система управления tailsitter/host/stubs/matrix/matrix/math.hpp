@@ -0,0 +1,8 @@
+/**
+ * @file math.hpp
+ * @brief Include path alias (<matrix/matrix/math.hpp>) of the host matrix stand-in.
+ */
+
+#pragma once
+
+#include "../math.hpp"
@@ -0,0 +1,35 @@
+/**
+ * @file param.h
+ * @brief Host stand-in for the PX4 parameter interface.
+ *
+ * The parameter table (names, types and defaults) is generated at configure time
+ * from the PARAM_DEFINE_* entries of the module's *_params.c files.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef uint16_t param_t;
+
+#define PARAM_INVALID ((uint16_t)0xffff)
+
+typedef enum param_type_e {
+	PARAM_TYPE_UNKNOWN = 0,
+	PARAM_TYPE_INT32,
+	PARAM_TYPE_FLOAT
+} param_type_t;
+
+param_t param_find(const char *name);
+unsigned param_count();
+const char *param_name(param_t param);
+param_type_t param_type(param_t param);
+int param_get(param_t param, void *val);
+
+/**
+ * Set a parameter value and notify the system through parameter_update.
+ */
+int param_set(param_t param, const void *val);
+int param_set_no_notification(param_t param, const void *val);
+void param_notify_changes();
+void param_reset_all();
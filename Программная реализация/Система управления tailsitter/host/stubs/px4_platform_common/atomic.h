@@ -0,0 +1,31 @@
+/**
+ * @file atomic.h
+ * @brief Host stand-in for px4::atomic (thin wrapper around the GCC builtins).
+ */
+
+#pragma once
+
+namespace px4
+{
+
+template<typename T>
+class atomic
+{
+public:
+	atomic() = default;
+	explicit atomic(T value) : _value(value) {}
+
+	T load() const { return __atomic_load_n(&_value, __ATOMIC_SEQ_CST); }
+	void store(T value) { __atomic_store_n(&_value, value, __ATOMIC_SEQ_CST); }
+	T fetch_add(T num) { return __atomic_fetch_add(&_value, num, __ATOMIC_SEQ_CST); }
+	T fetch_sub(T num) { return __atomic_fetch_sub(&_value, num, __ATOMIC_SEQ_CST); }
+	bool compare_exchange(T *expected, T desired)
+	{
+		return __atomic_compare_exchange(&_value, expected, &desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	}
+
+private:
+	T _value{};
+};
+
+} // namespace px4
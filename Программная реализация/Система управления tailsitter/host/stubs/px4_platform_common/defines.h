@@ -0,0 +1,32 @@
+/**
+ * @file defines.h
+ * @brief Host stand-in for px4_platform_common/defines.h.
+ */
+
+#pragma once
+
+#include <math.h>
+
+#define PX4_OK 0
+#define PX4_ERROR (-1)
+
+#define PX4_ISFINITE(x) std::isfinite(x)
+
+#ifndef M_PI_F
+#define M_PI_F 3.14159265358979323846f
+#endif
+#ifndef M_PI_2_F
+#define M_PI_2_F 1.57079632679489661923f
+#endif
+#ifndef M_TWOPI_F
+#define M_TWOPI_F 6.28318530717958647692f
+#endif
+
+#ifndef __EXPORT
+#define __EXPORT __attribute__((visibility("default")))
+#endif
+
+#include <cmath>
+
+#define PX4_ROOTFSDIR "."
+#define PX4_STORAGEDIR PX4_ROOTFSDIR
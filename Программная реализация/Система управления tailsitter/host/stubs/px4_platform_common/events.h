@@ -0,0 +1,45 @@
+/**
+ * @file events.h
+ * @brief Host stand-in for the PX4 events interface.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+namespace events
+{
+
+enum class Log : uint8_t {
+	Emergency,
+	Alert,
+	Critical,
+	Error,
+	Warning,
+	Notice,
+	Info,
+	Debug,
+};
+
+constexpr uint32_t ID(const char *name)
+{
+	// FNV-1a, only used to give each event a stable identifier on the host
+	uint32_t hash = 2166136261u;
+
+	while (*name) {
+		hash = (hash ^ static_cast<uint8_t>(*name++)) * 16777619u;
+	}
+
+	return hash;
+}
+
+template<typename... Args>
+inline void send(uint32_t id, Log level, const char *message, Args... args)
+{
+	(void)id;
+	(void)level;
+	printf("EVENT %s\n", message);
+}
+
+} // namespace events
@@ -0,0 +1,14 @@
+/**
+ * @file log.h
+ * @brief Host stand-in for the PX4 logging macros.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#define PX4_INFO(fmt, ...) printf("INFO  [" MODULE_NAME "] " fmt "\n", ##__VA_ARGS__)
+#define PX4_WARN(fmt, ...) printf("WARN  [" MODULE_NAME "] " fmt "\n", ##__VA_ARGS__)
+#define PX4_ERR(fmt, ...) printf("ERROR [" MODULE_NAME "] " fmt "\n", ##__VA_ARGS__)
+#define PX4_DEBUG(fmt, ...) do {} while (0)
+#define PX4_INFO_RAW(fmt, ...) printf(fmt, ##__VA_ARGS__)
@@ -0,0 +1,117 @@
+/**
+ * @file module.h
+ * @brief Host stand-in for the PX4 module base class and usage printing.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/defines.h>
+#include <px4_platform_common/log.h>
+
+#define PRINT_MODULE_DESCRIPTION(d) printf("%s\n", d)
+#define PRINT_MODULE_USAGE_NAME(executable_name, category) printf("Usage: %s <command> [arguments...]\n", executable_name)
+#define PRINT_MODULE_USAGE_NAME_SIMPLE(executable_name, category) printf("Usage: %s [arguments...]\n", executable_name)
+#define PRINT_MODULE_USAGE_COMMAND(name) printf("  %s\n", name)
+#define PRINT_MODULE_USAGE_COMMAND_DESCR(name, description) printf("  %-16s %s\n", name, description)
+#define PRINT_MODULE_USAGE_DEFAULT_COMMANDS() printf("  stop\n  status\n")
+#define PRINT_MODULE_USAGE_ARG(values, description, is_optional) printf("    %-14s %s\n", values, description)
+#define PRINT_MODULE_USAGE_PARAM_INT(option_char, default_val, min_val, max_val, description, is_optional) \
+	printf("    -%c <val>      %s (default %d)\n", option_char, description, default_val)
+#define PRINT_MODULE_USAGE_PARAM_FLOAT(option_char, default_val, min_val, max_val, description, is_optional) \
+	printf("    -%c <val>      %s (default %.1f)\n", option_char, description, (double)default_val)
+
+static constexpr int task_id_is_work_queue = -2;
+
+template<class T>
+class ModuleBase
+{
+public:
+	ModuleBase() = default;
+	virtual ~ModuleBase() = default;
+
+	static int main(int argc, char *argv[])
+	{
+		if (argc <= 1 || strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "help") == 0) {
+			return T::print_usage();
+		}
+
+		if (strcmp(argv[1], "start") == 0) {
+			if (is_running()) {
+				PX4_ERR("already running");
+				return 1;
+			}
+
+			return T::task_spawn(argc - 1, argv + 1);
+		}
+
+		if (strcmp(argv[1], "status") == 0) {
+			if (is_running() && _object.load()) {
+				return _object.load()->print_status();
+			}
+
+			PX4_INFO("not running");
+			return 1;
+		}
+
+		if (strcmp(argv[1], "stop") == 0) {
+			return stop_command();
+		}
+
+		return T::custom_command(argc - 1, argv + 1);
+	}
+
+	static bool is_running() { return _task_id != -1; }
+
+	static T *get_instance() { return _object.load(); }
+
+	virtual int print_status()
+	{
+		PX4_INFO("running");
+		return 0;
+	}
+
+	virtual void request_stop() { _task_should_exit.store(true); }
+
+	static int stop_command()
+	{
+		if (!is_running()) {
+			PX4_WARN("not running");
+			return 1;
+		}
+
+		T *object = _object.load();
+
+		if (object) {
+			object->request_stop();
+		}
+
+		return 0;
+	}
+
+protected:
+	bool should_exit() const { return _task_should_exit.load(); }
+
+	static void exit_and_cleanup()
+	{
+		T *object = _object.load();
+		_object.store(nullptr);
+		_task_id = -1;
+		delete object;
+	}
+
+	static px4::atomic<T *> _object;
+	static int _task_id;
+
+private:
+	px4::atomic<bool> _task_should_exit{false};
+};
+
+template<class T>
+px4::atomic<T *> ModuleBase<T>::_object{nullptr};
+
+template<class T>
+int ModuleBase<T>::_task_id = -1;
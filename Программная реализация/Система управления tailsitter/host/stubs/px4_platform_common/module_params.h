@@ -0,0 +1,258 @@
+/**
+ * @file module_params.h
+ * @brief Host stand-in for ModuleParams and the DEFINE_PARAMETERS macros.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <parameters/param.h>
+#include <parameters/px4_parameters.hpp>
+
+namespace px4
+{
+
+static inline param_t param_handle(params p)
+{
+	return static_cast<param_t>(p);
+}
+
+} // namespace px4
+
+template<typename T, px4::params p>
+class Param;
+
+template<px4::params p>
+class Param<float, p>
+{
+public:
+	Param() { update(); }
+
+	float get() const { return _val; }
+	const float &reference() const { return _val; }
+
+	/// Store the parameter value to the parameter storage (@see param_set())
+	bool commit() const { return param_set(handle(), &_val) == 0; }
+
+	/// Store the parameter value to the parameter storage, w/o notifying the system (@see param_set_no_notification())
+	bool commit_no_notification() const { return param_set_no_notification(handle(), &_val) == 0; }
+
+	void set(float val) { _val = val; }
+
+	bool update() { return param_get(handle(), &_val) == 0; }
+
+	param_t handle() const { return px4::param_handle(p); }
+
+private:
+	float _val{0.f};
+};
+
+template<px4::params p>
+class Param<int32_t, p>
+{
+public:
+	Param() { update(); }
+
+	int32_t get() const { return _val; }
+	const int32_t &reference() const { return _val; }
+
+	bool commit() const { return param_set(handle(), &_val) == 0; }
+	bool commit_no_notification() const { return param_set_no_notification(handle(), &_val) == 0; }
+
+	void set(int32_t val) { _val = val; }
+
+	bool update() { return param_get(handle(), &_val) == 0; }
+
+	param_t handle() const { return px4::param_handle(p); }
+
+private:
+	int32_t _val{0};
+};
+
+template<px4::params p>
+class Param<bool, p>
+{
+public:
+	Param() { update(); }
+
+	bool get() const { return _val; }
+	const bool &reference() const { return _val; }
+
+	bool commit() const
+	{
+		const int32_t value_int = static_cast<int32_t>(_val);
+		return param_set(handle(), &value_int) == 0;
+	}
+
+	void set(bool val) { _val = val; }
+
+	bool update()
+	{
+		int32_t value_int;
+
+		if (param_get(handle(), &value_int) == 0) {
+			_val = value_int != 0;
+			return true;
+		}
+
+		return false;
+	}
+
+	param_t handle() const { return px4::param_handle(p); }
+
+private:
+	bool _val{false};
+};
+
+template <px4::params p>
+using ParamFloat = Param<float, p>;
+
+template <px4::params p>
+using ParamInt = Param<int32_t, p>;
+
+template <px4::params p>
+using ParamBool = Param<bool, p>;
+
+class ModuleParams
+{
+public:
+	ModuleParams(ModuleParams *parent) { setParent(parent); }
+
+	virtual ~ModuleParams()
+	{
+		if (_parent) {
+			_parent->removeChild(this);
+		}
+	}
+
+	ModuleParams(const ModuleParams &) = delete;
+	ModuleParams &operator=(const ModuleParams &) = delete;
+
+	void setParent(ModuleParams *parent)
+	{
+		if (parent) {
+			parent->addChild(this);
+		}
+
+		_parent = parent;
+	}
+
+protected:
+	/**
+	 * Call this whenever the module gets a parameter change notification. It will automatically
+	 * call updateParams() for all children, which then call updateParamsImpl().
+	 */
+	virtual void updateParams()
+	{
+		for (size_t i = 0; i < _num_children; i++) {
+			_children[i]->updateParams();
+		}
+
+		updateParamsImpl();
+	}
+
+	/**
+	 * The implementation for this is generated with the macro DEFINE_PARAMETERS()
+	 */
+	virtual void updateParamsImpl() {}
+
+private:
+	static constexpr size_t kMaxChildren = 8;
+
+	void addChild(ModuleParams *child)
+	{
+		if (_num_children < kMaxChildren) {
+			_children[_num_children++] = child;
+		}
+	}
+
+	void removeChild(ModuleParams *child)
+	{
+		for (size_t i = 0; i < _num_children; i++) {
+			if (_children[i] == child) {
+				_children[i] = _children[--_num_children];
+				return;
+			}
+		}
+	}
+
+	ModuleParams *_children[kMaxChildren] {};
+	size_t _num_children{0};
+	ModuleParams *_parent{nullptr};
+};
+
+// Each DEFINE_PARAMETERS entry has the form (ParamType<px4::params::NAME>) _member
+#define _PARAM_REMOVE_PARENS(...) __VA_ARGS__
+#define _PARAM_EAT(...)
+#define _PARAM_DECLARE(x) _PARAM_REMOVE_PARENS x;
+#define _PARAM_UPDATE(x) _PARAM_EAT x .update();
+
+#define _PARAM_APPLY_1(m, x) m(x)
+#define _PARAM_APPLY_2(m, x, ...) m(x) _PARAM_APPLY_1(m, __VA_ARGS__)
+#define _PARAM_APPLY_3(m, x, ...) m(x) _PARAM_APPLY_2(m, __VA_ARGS__)
+#define _PARAM_APPLY_4(m, x, ...) m(x) _PARAM_APPLY_3(m, __VA_ARGS__)
+#define _PARAM_APPLY_5(m, x, ...) m(x) _PARAM_APPLY_4(m, __VA_ARGS__)
+#define _PARAM_APPLY_6(m, x, ...) m(x) _PARAM_APPLY_5(m, __VA_ARGS__)
+#define _PARAM_APPLY_7(m, x, ...) m(x) _PARAM_APPLY_6(m, __VA_ARGS__)
+#define _PARAM_APPLY_8(m, x, ...) m(x) _PARAM_APPLY_7(m, __VA_ARGS__)
+#define _PARAM_APPLY_9(m, x, ...) m(x) _PARAM_APPLY_8(m, __VA_ARGS__)
+#define _PARAM_APPLY_10(m, x, ...) m(x) _PARAM_APPLY_9(m, __VA_ARGS__)
+#define _PARAM_APPLY_11(m, x, ...) m(x) _PARAM_APPLY_10(m, __VA_ARGS__)
+#define _PARAM_APPLY_12(m, x, ...) m(x) _PARAM_APPLY_11(m, __VA_ARGS__)
+#define _PARAM_APPLY_13(m, x, ...) m(x) _PARAM_APPLY_12(m, __VA_ARGS__)
+#define _PARAM_APPLY_14(m, x, ...) m(x) _PARAM_APPLY_13(m, __VA_ARGS__)
+#define _PARAM_APPLY_15(m, x, ...) m(x) _PARAM_APPLY_14(m, __VA_ARGS__)
+#define _PARAM_APPLY_16(m, x, ...) m(x) _PARAM_APPLY_15(m, __VA_ARGS__)
+#define _PARAM_APPLY_17(m, x, ...) m(x) _PARAM_APPLY_16(m, __VA_ARGS__)
+#define _PARAM_APPLY_18(m, x, ...) m(x) _PARAM_APPLY_17(m, __VA_ARGS__)
+#define _PARAM_APPLY_19(m, x, ...) m(x) _PARAM_APPLY_18(m, __VA_ARGS__)
+#define _PARAM_APPLY_20(m, x, ...) m(x) _PARAM_APPLY_19(m, __VA_ARGS__)
+#define _PARAM_APPLY_21(m, x, ...) m(x) _PARAM_APPLY_20(m, __VA_ARGS__)
+#define _PARAM_APPLY_22(m, x, ...) m(x) _PARAM_APPLY_21(m, __VA_ARGS__)
+#define _PARAM_APPLY_23(m, x, ...) m(x) _PARAM_APPLY_22(m, __VA_ARGS__)
+#define _PARAM_APPLY_24(m, x, ...) m(x) _PARAM_APPLY_23(m, __VA_ARGS__)
+#define _PARAM_APPLY_25(m, x, ...) m(x) _PARAM_APPLY_24(m, __VA_ARGS__)
+#define _PARAM_APPLY_26(m, x, ...) m(x) _PARAM_APPLY_25(m, __VA_ARGS__)
+#define _PARAM_APPLY_27(m, x, ...) m(x) _PARAM_APPLY_26(m, __VA_ARGS__)
+#define _PARAM_APPLY_28(m, x, ...) m(x) _PARAM_APPLY_27(m, __VA_ARGS__)
+#define _PARAM_APPLY_29(m, x, ...) m(x) _PARAM_APPLY_28(m, __VA_ARGS__)
+#define _PARAM_APPLY_30(m, x, ...) m(x) _PARAM_APPLY_29(m, __VA_ARGS__)
+#define _PARAM_APPLY_31(m, x, ...) m(x) _PARAM_APPLY_30(m, __VA_ARGS__)
+#define _PARAM_APPLY_32(m, x, ...) m(x) _PARAM_APPLY_31(m, __VA_ARGS__)
+#define _PARAM_APPLY_33(m, x, ...) m(x) _PARAM_APPLY_32(m, __VA_ARGS__)
+#define _PARAM_APPLY_34(m, x, ...) m(x) _PARAM_APPLY_33(m, __VA_ARGS__)
+#define _PARAM_APPLY_35(m, x, ...) m(x) _PARAM_APPLY_34(m, __VA_ARGS__)
+#define _PARAM_APPLY_36(m, x, ...) m(x) _PARAM_APPLY_35(m, __VA_ARGS__)
+#define _PARAM_APPLY_37(m, x, ...) m(x) _PARAM_APPLY_36(m, __VA_ARGS__)
+#define _PARAM_APPLY_38(m, x, ...) m(x) _PARAM_APPLY_37(m, __VA_ARGS__)
+#define _PARAM_APPLY_39(m, x, ...) m(x) _PARAM_APPLY_38(m, __VA_ARGS__)
+#define _PARAM_APPLY_40(m, x, ...) m(x) _PARAM_APPLY_39(m, __VA_ARGS__)
+#define _PARAM_APPLY_41(m, x, ...) m(x) _PARAM_APPLY_40(m, __VA_ARGS__)
+#define _PARAM_APPLY_42(m, x, ...) m(x) _PARAM_APPLY_41(m, __VA_ARGS__)
+#define _PARAM_APPLY_43(m, x, ...) m(x) _PARAM_APPLY_42(m, __VA_ARGS__)
+#define _PARAM_APPLY_44(m, x, ...) m(x) _PARAM_APPLY_43(m, __VA_ARGS__)
+#define _PARAM_APPLY_45(m, x, ...) m(x) _PARAM_APPLY_44(m, __VA_ARGS__)
+#define _PARAM_APPLY_46(m, x, ...) m(x) _PARAM_APPLY_45(m, __VA_ARGS__)
+#define _PARAM_APPLY_47(m, x, ...) m(x) _PARAM_APPLY_46(m, __VA_ARGS__)
+#define _PARAM_APPLY_48(m, x, ...) m(x) _PARAM_APPLY_47(m, __VA_ARGS__)
+
+#define _PARAM_COUNT(...) _PARAM_COUNT_IMPL(__VA_ARGS__, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, \
+	32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)
+#define _PARAM_COUNT_IMPL(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, \
+	_21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, _33, _34, _35, _36, _37, _38, _39, _40, _41, _42, _43, \
+	_44, _45, _46, _47, _48, N, ...) N
+#define _PARAM_CONCAT(a, b) _PARAM_CONCAT_IMPL(a, b)
+#define _PARAM_CONCAT_IMPL(a, b) a##b
+#define _PARAM_APPLY_ALL(m, ...) _PARAM_CONCAT(_PARAM_APPLY_, _PARAM_COUNT(__VA_ARGS__))(m, __VA_ARGS__)
+
+#define DEFINE_PARAMETERS_CUSTOM_PARENT(parent_class, ...) \
+	_PARAM_APPLY_ALL(_PARAM_DECLARE, __VA_ARGS__) \
+	void updateParamsImpl() override \
+	{ \
+		parent_class::updateParamsImpl(); \
+		_PARAM_APPLY_ALL(_PARAM_UPDATE, __VA_ARGS__) \
+	}
+
+#define DEFINE_PARAMETERS(...) DEFINE_PARAMETERS_CUSTOM_PARENT(ModuleParams, __VA_ARGS__)
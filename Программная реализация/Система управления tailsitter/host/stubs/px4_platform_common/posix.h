@@ -0,0 +1,10 @@
+/**
+ * @file posix.h
+ * @brief Host stand-in for px4_platform_common/posix.h.
+ */
+
+#pragma once
+
+#include <unistd.h>
+
+int px4_usleep(unsigned usec);
@@ -0,0 +1,6 @@
+/**
+ * @file px4_config.h
+ * @brief Host stand-in for the board configuration header.
+ */
+
+#pragma once
@@ -0,0 +1,48 @@
+/**
+ * @file ScheduledWorkItem.hpp
+ * @brief Host stand-in for px4::ScheduledWorkItem.
+ */
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+
+namespace px4
+{
+
+class ScheduledWorkItem : public WorkItem
+{
+public:
+	bool Scheduled() const { return _next_run != 0; }
+
+	/**
+	 * Schedule next run with a delay in microseconds.
+	 */
+	void ScheduleDelayed(uint32_t delay_us);
+
+	/**
+	 * Schedule repeating run with optional delay.
+	 */
+	void ScheduleOnInterval(uint32_t interval_us, uint32_t delay_us = 0);
+
+	/**
+	 * Clear any scheduled work.
+	 */
+	void ScheduleClear();
+
+	/**
+	 * Host scheduler: mark the item pending if its deadline has passed.
+	 */
+	void CheckDeadline(hrt_abstime now);
+
+protected:
+	ScheduledWorkItem(const char *name, const wq_config_t &config) : WorkItem(name, config) {}
+	~ScheduledWorkItem() override;
+
+private:
+	hrt_abstime _next_run{0};
+	uint32_t _interval_us{0};
+};
+
+} // namespace px4
@@ -0,0 +1,52 @@
+/**
+ * @file WorkItem.hpp
+ * @brief Host stand-in for px4::WorkItem.
+ *
+ * Items are not run on threads. ScheduleNow() marks the item pending and
+ * px4::work_queue_run_pending() runs it on the caller's thread.
+ */
+
+#pragma once
+
+#include <px4_platform_common/px4_work_queue/WorkQueueManager.hpp>
+
+namespace px4
+{
+
+class WorkItem
+{
+public:
+	WorkItem() = delete;
+	WorkItem(const WorkItem &) = delete;
+	WorkItem &operator=(const WorkItem &) = delete;
+
+	void ScheduleNow();
+	void ScheduleClear();
+
+	const char *ItemName() const { return _item_name; }
+	const wq_config_t &WorkQueueConfig() const { return _config; }
+
+	bool pending() const { return _pending; }
+	uint32_t RunCount() const { return _run_count; }
+
+	/**
+	 * Host scheduler entry point, runs the item once.
+	 */
+	void RunPreamble();
+
+protected:
+	WorkItem(const char *name, const wq_config_t &config);
+	virtual ~WorkItem();
+
+	bool Init(const wq_config_t &config);
+	void Deinit();
+
+	virtual void Run() = 0;
+
+	const char *_item_name;
+	wq_config_t _config;
+	bool _pending{false};
+	uint32_t _run_count{0};
+};
+
+} // namespace px4
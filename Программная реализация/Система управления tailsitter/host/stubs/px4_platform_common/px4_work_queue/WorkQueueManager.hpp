@@ -0,0 +1,35 @@
+/**
+ * @file WorkQueueManager.hpp
+ * @brief Host stand-in for the PX4 work queue configurations and the host scheduler.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace px4
+{
+
+struct wq_config_t {
+	const char *name;
+	uint16_t stacksize;
+	int8_t relative_priority; // relative to max
+};
+
+namespace wq_configurations
+{
+static constexpr wq_config_t rate_ctrl{"wq:rate_ctrl", 3150, 0};
+static constexpr wq_config_t nav_and_controllers{"wq:nav_and_controllers", 2240, -13};
+static constexpr wq_config_t hp_default{"wq:hp_default", 2800, -18};
+static constexpr wq_config_t lp_default{"wq:lp_default", 1920, -50};
+} // namespace wq_configurations
+
+/**
+ * Run every work item that is due at the current hrt time, highest work queue
+ * priority first, until no item is pending anymore.
+ *
+ * @return number of Run() calls
+ */
+unsigned work_queue_run_pending();
+
+} // namespace px4
@@ -0,0 +1,13 @@
+/**
+ * @file mavlink_log.h
+ * @brief Host stand-in for the mavlink log helpers.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include <uORB/uORB.h>
+
+#define mavlink_log_critical(_pub, _text, ...) do { (void)(_pub); printf("CRIT  " _text "\n", ##__VA_ARGS__); } while (0)
+#define mavlink_log_info(_pub, _text, ...) do { (void)(_pub); printf("INFO  " _text "\n", ##__VA_ARGS__); } while (0)
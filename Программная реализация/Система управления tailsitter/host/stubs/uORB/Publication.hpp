@@ -0,0 +1,42 @@
+/**
+ * @file Publication.hpp
+ * @brief Host stand-in for uORB::Publication.
+ */
+
+#pragma once
+
+#include <uORB/uORB.h>
+
+namespace uORB
+{
+
+template<typename T>
+class Publication
+{
+public:
+	Publication(const orb_metadata *meta) : _meta(meta) {}
+
+	bool advertise()
+	{
+		if (_instance < 0) {
+			_instance = uORB::advertise(_meta, false, 0);
+		}
+
+		return _instance >= 0;
+	}
+
+	bool advertised() const { return _instance >= 0; }
+
+	bool publish(const T &data)
+	{
+		return advertise() && uORB::publish(_meta, static_cast<uint8_t>(_instance), &data);
+	}
+
+	int get_instance() const { return _instance; }
+
+protected:
+	const orb_metadata *_meta;
+	int _instance{-1};
+};
+
+} // namespace uORB
@@ -0,0 +1,42 @@
+/**
+ * @file PublicationMulti.hpp
+ * @brief Host stand-in for uORB::PublicationMulti.
+ */
+
+#pragma once
+
+#include <uORB/Publication.hpp>
+
+namespace uORB
+{
+
+template<typename T>
+class PublicationMulti
+{
+public:
+	PublicationMulti(const orb_metadata *meta) : _meta(meta) {}
+
+	bool advertise()
+	{
+		if (_instance < 0) {
+			_instance = uORB::advertise(_meta, true, -1);
+		}
+
+		return _instance >= 0;
+	}
+
+	bool advertised() const { return _instance >= 0; }
+
+	bool publish(const T &data)
+	{
+		return advertise() && uORB::publish(_meta, static_cast<uint8_t>(_instance), &data);
+	}
+
+	int get_instance() const { return _instance; }
+
+protected:
+	const orb_metadata *_meta;
+	int _instance{-1};
+};
+
+} // namespace uORB
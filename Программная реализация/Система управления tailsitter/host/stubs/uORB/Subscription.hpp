@@ -0,0 +1,70 @@
+/**
+ * @file Subscription.hpp
+ * @brief Host stand-in for uORB::Subscription.
+ */
+
+#pragma once
+
+#include <uORB/uORB.h>
+
+namespace uORB
+{
+
+class Subscription
+{
+public:
+	Subscription(const orb_metadata *meta, uint8_t instance = 0) : _meta(meta), _instance(instance) {}
+	virtual ~Subscription() = default;
+
+	bool subscribe()
+	{
+		if (_node == nullptr) {
+			_node = get_node(_meta, _instance);
+		}
+
+		return _node != nullptr;
+	}
+
+	bool advertised()
+	{
+		return subscribe() && node_advertised(_node);
+	}
+
+	/**
+	 * Check if there is a new update.
+	 */
+	bool updated()
+	{
+		return subscribe() && generation(_node) != _last_generation;
+	}
+
+	/**
+	 * Update the struct
+	 * @param dst The uORB message struct we are updating.
+	 */
+	bool update(void *dst)
+	{
+		return subscribe() && uORB::copy(_node, dst, _last_generation, true);
+	}
+
+	/**
+	 * Copy the struct
+	 * @param dst The uORB message struct we are updating.
+	 */
+	bool copy(void *dst)
+	{
+		return subscribe() && uORB::copy(_node, dst, _last_generation, false);
+	}
+
+	unsigned get_last_generation() const { return _last_generation; }
+	orb_id_t get_topic() const { return _meta; }
+	uint8_t get_instance() const { return _instance; }
+
+protected:
+	DeviceNode *_node{nullptr};
+	const orb_metadata *_meta{nullptr};
+	uint8_t _instance{0};
+	unsigned _last_generation{0};
+};
+
+} // namespace uORB
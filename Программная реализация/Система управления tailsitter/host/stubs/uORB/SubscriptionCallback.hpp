@@ -0,0 +1,51 @@
+/**
+ * @file SubscriptionCallback.hpp
+ * @brief Host stand-in for uORB::SubscriptionCallbackWorkItem.
+ */
+
+#pragma once
+
+#include <px4_platform_common/px4_work_queue/WorkItem.hpp>
+#include <uORB/Subscription.hpp>
+#include <uORB/SubscriptionInterval.hpp>
+
+namespace uORB
+{
+
+class SubscriptionCallbackWorkItem : public Subscription
+{
+public:
+	SubscriptionCallbackWorkItem(px4::WorkItem *work_item, const orb_metadata *meta, uint8_t instance = 0) :
+		Subscription(meta, instance),
+		_work_item(work_item)
+	{}
+
+	~SubscriptionCallbackWorkItem() override
+	{
+		unregisterCallback();
+	}
+
+	bool registerCallback()
+	{
+		if (!_registered && subscribe()) {
+			register_callback(_node, _work_item);
+			_registered = true;
+		}
+
+		return _registered;
+	}
+
+	void unregisterCallback()
+	{
+		if (_registered) {
+			unregister_callback(_node, _work_item);
+			_registered = false;
+		}
+	}
+
+private:
+	px4::WorkItem *_work_item;
+	bool _registered{false};
+};
+
+} // namespace uORB
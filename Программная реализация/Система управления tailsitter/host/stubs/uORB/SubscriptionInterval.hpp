@@ -0,0 +1,58 @@
+/**
+ * @file SubscriptionInterval.hpp
+ * @brief Host stand-in for uORB::SubscriptionInterval.
+ */
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+#include <uORB/Subscription.hpp>
+
+namespace uORB
+{
+
+class SubscriptionInterval
+{
+public:
+	SubscriptionInterval(const orb_metadata *meta, uint32_t interval_us = 0, uint8_t instance = 0) :
+		_subscription{meta, instance},
+		_interval_us(interval_us)
+	{}
+
+	bool updated()
+	{
+		if (_subscription.updated()) {
+			return _last_update == 0 || hrt_elapsed_time(&_last_update) >= _interval_us;
+		}
+
+		return false;
+	}
+
+	bool update(void *dst)
+	{
+		if (updated()) {
+			return copy(dst);
+		}
+
+		return false;
+	}
+
+	bool copy(void *dst)
+	{
+		if (_subscription.copy(dst)) {
+			_last_update = hrt_absolute_time();
+			return true;
+		}
+
+		return false;
+	}
+
+	void set_interval_us(uint32_t interval) { _interval_us = interval; }
+
+protected:
+	Subscription _subscription;
+	hrt_abstime _last_update{0};
+	uint32_t _interval_us{0};
+};
+
+} // namespace uORB
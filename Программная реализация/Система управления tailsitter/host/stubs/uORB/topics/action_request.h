@@ -0,0 +1,27 @@
+/**
+ * @file action_request.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct action_request_s {
+	uint64_t timestamp;
+	uint8_t action;
+	uint8_t source;
+	uint8_t mode;
+
+	static constexpr uint8_t ACTION_DISARM = 0;
+	static constexpr uint8_t ACTION_ARM = 1;
+	static constexpr uint8_t ACTION_TOGGLE_ARMING = 2;
+	static constexpr uint8_t ACTION_UNKILL = 3;
+	static constexpr uint8_t ACTION_KILL = 4;
+	static constexpr uint8_t ACTION_SWITCH_MODE = 5;
+	static constexpr uint8_t ACTION_VTOL_TRANSITION_TO_MULTICOPTER = 6;
+	static constexpr uint8_t ACTION_VTOL_TRANSITION_TO_FIXEDWING = 7;
+};
+
+ORB_DECLARE(action_request);
@@ -0,0 +1,25 @@
+/**
+ * @file airspeed_validated.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct airspeed_validated_s {
+	uint64_t timestamp;
+	float indicated_airspeed_m_s;
+	float calibrated_airspeed_m_s;
+	float true_airspeed_m_s;
+	float calibrated_ground_minus_wind_m_s;
+	float true_ground_minus_wind_m_s;
+	bool airspeed_sensor_measurement_valid;
+	int8_t selected_airspeed_index;
+	float airspeed_derivative_filtered;
+	float throttle_filtered;
+	float pitch_filtered;
+};
+
+ORB_DECLARE(airspeed_validated);
@@ -0,0 +1,29 @@
+/**
+ * @file home_position.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct home_position_s {
+	uint64_t timestamp;
+	double lat;
+	double lon;
+	float alt;
+	float x;
+	float y;
+	float z;
+	float roll;
+	float pitch;
+	float yaw;
+	bool valid_alt;
+	bool valid_hpos;
+	bool valid_lpos;
+	bool manual_home;
+	uint32_t update_count;
+};
+
+ORB_DECLARE(home_position);
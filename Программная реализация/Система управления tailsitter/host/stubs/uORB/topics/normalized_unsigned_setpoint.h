@@ -0,0 +1,18 @@
+/**
+ * @file normalized_unsigned_setpoint.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct normalized_unsigned_setpoint_s {
+	uint64_t timestamp;
+	float normalized_setpoint;
+};
+
+ORB_DECLARE(normalized_unsigned_setpoint);
+ORB_DECLARE(flaps_setpoint);
+ORB_DECLARE(spoilers_setpoint);
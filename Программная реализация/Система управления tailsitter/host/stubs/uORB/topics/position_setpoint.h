@@ -0,0 +1,41 @@
+/**
+ * @file position_setpoint.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct position_setpoint_s {
+	uint64_t timestamp;
+	bool valid;
+	uint8_t type;
+	float vx;
+	float vy;
+	float vz;
+	double lat;
+	double lon;
+	float alt;
+	float yaw;
+	bool yaw_valid;
+	float yawspeed;
+	bool yawspeed_valid;
+	float loiter_radius;
+	int8_t loiter_direction;
+	float acceptance_radius;
+	float cruising_speed;
+	bool gliding_enabled;
+	float cruising_throttle;
+	bool disable_weather_vane;
+
+	static constexpr uint8_t SETPOINT_TYPE_POSITION = 0;
+	static constexpr uint8_t SETPOINT_TYPE_VELOCITY = 1;
+	static constexpr uint8_t SETPOINT_TYPE_LOITER = 2;
+	static constexpr uint8_t SETPOINT_TYPE_TAKEOFF = 3;
+	static constexpr uint8_t SETPOINT_TYPE_LAND = 4;
+	static constexpr uint8_t SETPOINT_TYPE_IDLE = 5;
+};
+
+ORB_DECLARE(position_setpoint);
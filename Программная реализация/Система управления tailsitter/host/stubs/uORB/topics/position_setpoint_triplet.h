@@ -0,0 +1,19 @@
+/**
+ * @file position_setpoint_triplet.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+#include <uORB/topics/position_setpoint.h>
+
+struct position_setpoint_triplet_s {
+	uint64_t timestamp;
+	position_setpoint_s previous;
+	position_setpoint_s current;
+	position_setpoint_s next;
+};
+
+ORB_DECLARE(position_setpoint_triplet);
@@ -0,0 +1,38 @@
+/**
+ * @file tecs_status.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct tecs_status_s {
+	uint64_t timestamp;
+	float altitude_sp;
+	float altitude_reference;
+	float height_rate_reference;
+	float height_rate_direct;
+	float height_rate_setpoint;
+	float height_rate;
+	float equivalent_airspeed_sp;
+	float true_airspeed_sp;
+	float true_airspeed_filtered;
+	float true_airspeed_derivative_sp;
+	float true_airspeed_derivative;
+	float true_airspeed_derivative_raw;
+	float total_energy_rate_sp;
+	float total_energy_rate;
+	float total_energy_balance_rate_sp;
+	float total_energy_balance_rate;
+	float throttle_integ;
+	float pitch_integ;
+	float throttle_sp;
+	float pitch_sp_rad;
+	float throttle_trim;
+	float underspeed_ratio;
+	float fast_descend_ratio;
+};
+
+ORB_DECLARE(tecs_status);
@@ -0,0 +1,17 @@
+/**
+ * @file tiltrotor_extra_controls.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct tiltrotor_extra_controls_s {
+	uint64_t timestamp;
+	float collective_tilt_normalized_setpoint;
+	float collective_thrust_normalized_setpoint;
+};
+
+ORB_DECLARE(tiltrotor_extra_controls);
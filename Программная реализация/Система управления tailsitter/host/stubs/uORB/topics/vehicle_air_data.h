@@ -0,0 +1,23 @@
+/**
+ * @file vehicle_air_data.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct vehicle_air_data_s {
+	uint64_t timestamp;
+	uint64_t timestamp_sample;
+	uint32_t baro_device_id;
+	float baro_alt_meter;
+	float baro_temp_celcius;
+	float baro_pressure_pa;
+	float rho;
+	float eas2tas;
+	uint8_t calibration_count;
+};
+
+ORB_DECLARE(vehicle_air_data);
@@ -0,0 +1,22 @@
+/**
+ * @file vehicle_attitude_setpoint.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct vehicle_attitude_setpoint_s {
+	uint64_t timestamp;
+	float yaw_sp_move_rate;
+	float q_d[4];
+	float thrust_body[3];
+	bool reset_integral;
+	bool fw_control_yaw_wheel;
+};
+
+ORB_DECLARE(vehicle_attitude_setpoint);
+ORB_DECLARE(mc_virtual_attitude_setpoint);
+ORB_DECLARE(fw_virtual_attitude_setpoint);
@@ -0,0 +1,31 @@
+/**
+ * @file vehicle_command.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct vehicle_command_s {
+	uint64_t timestamp;
+	float param1;
+	float param2;
+	float param3;
+	float param4;
+	double param5;
+	double param6;
+	float param7;
+	uint32_t command;
+	uint8_t target_system;
+	uint8_t target_component;
+	uint8_t source_system;
+	uint16_t source_component;
+	uint8_t confirmation;
+	bool from_external;
+
+	static constexpr uint32_t VEHICLE_CMD_DO_VTOL_TRANSITION = 3000;
+};
+
+ORB_DECLARE(vehicle_command);
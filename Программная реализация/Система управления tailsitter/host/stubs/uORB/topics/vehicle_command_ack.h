@@ -0,0 +1,28 @@
+/**
+ * @file vehicle_command_ack.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct vehicle_command_ack_s {
+	uint64_t timestamp;
+	uint32_t command;
+	uint8_t result;
+	uint8_t result_param1;
+	int32_t result_param2;
+	uint8_t target_system;
+	uint16_t target_component;
+	bool from_external;
+
+	static constexpr uint8_t VEHICLE_CMD_RESULT_ACCEPTED = 0;
+	static constexpr uint8_t VEHICLE_CMD_RESULT_TEMPORARILY_REJECTED = 1;
+	static constexpr uint8_t VEHICLE_CMD_RESULT_DENIED = 2;
+	static constexpr uint8_t VEHICLE_CMD_RESULT_UNSUPPORTED = 3;
+	static constexpr uint8_t VEHICLE_CMD_RESULT_FAILED = 4;
+};
+
+ORB_DECLARE(vehicle_command_ack);
@@ -0,0 +1,60 @@
+/**
+ * @file vehicle_local_position.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct vehicle_local_position_s {
+	uint64_t timestamp;
+	uint64_t timestamp_sample;
+	bool xy_valid;
+	bool z_valid;
+	bool v_xy_valid;
+	bool v_z_valid;
+	float x;
+	float y;
+	float z;
+	float delta_xy[2];
+	uint8_t xy_reset_counter;
+	float delta_z;
+	uint8_t z_reset_counter;
+	float vx;
+	float vy;
+	float vz;
+	float z_deriv;
+	float delta_vxy[2];
+	uint8_t vxy_reset_counter;
+	float delta_vz;
+	uint8_t vz_reset_counter;
+	float ax;
+	float ay;
+	float az;
+	float heading;
+	float delta_heading;
+	uint8_t heading_reset_counter;
+	bool heading_good_for_control;
+	bool xy_global;
+	bool z_global;
+	uint64_t ref_timestamp;
+	double ref_lat;
+	double ref_lon;
+	float ref_alt;
+	float dist_bottom;
+	bool dist_bottom_valid;
+	uint8_t dist_bottom_sensor_bitfield;
+	float eph;
+	float epv;
+	float evh;
+	float evv;
+	bool dead_reckoning;
+	float vxy_max;
+	float vz_max;
+	float hagl_min;
+	float hagl_max;
+};
+
+ORB_DECLARE(vehicle_local_position);
@@ -0,0 +1,25 @@
+/**
+ * @file vehicle_local_position_setpoint.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct vehicle_local_position_setpoint_s {
+	uint64_t timestamp;
+	float x;
+	float y;
+	float z;
+	float vx;
+	float vy;
+	float vz;
+	float acceleration[3];
+	float thrust[3];
+	float yaw;
+	float yawspeed;
+};
+
+ORB_DECLARE(vehicle_local_position_setpoint);
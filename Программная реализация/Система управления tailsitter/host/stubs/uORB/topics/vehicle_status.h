@@ -0,0 +1,69 @@
+/**
+ * @file vehicle_status.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct vehicle_status_s {
+	uint64_t timestamp;
+	uint64_t armed_time;
+	uint64_t takeoff_time;
+	uint8_t arming_state;
+	uint8_t latest_arming_reason;
+	uint8_t latest_disarming_reason;
+	uint64_t nav_state_timestamp;
+	uint8_t nav_state_user_intention;
+	uint8_t nav_state;
+	uint8_t failure_detector_status;
+	uint8_t hil_state;
+	uint8_t vehicle_type;
+	bool failsafe;
+	bool failsafe_and_user_took_over;
+	bool gcs_connection_lost;
+	uint8_t gcs_connection_lost_counter;
+	bool high_latency_data_link_lost;
+	bool is_vtol;
+	bool is_vtol_tailsitter;
+	bool in_transition_mode;
+	bool in_transition_to_fw;
+	uint8_t system_type;
+	uint8_t system_id;
+	uint8_t component_id;
+	bool safety_button_available;
+	bool safety_off;
+	bool power_input_valid;
+	bool usb_connected;
+	bool open_drone_id_system_present;
+	bool open_drone_id_system_healthy;
+	bool parachute_system_present;
+	bool parachute_system_healthy;
+	bool avoidance_system_required;
+	bool avoidance_system_valid;
+	bool rc_calibration_in_progress;
+	bool calibration_enabled;
+	bool pre_flight_checks_pass;
+
+	static constexpr uint8_t NAVIGATION_STATE_MANUAL = 0;
+	static constexpr uint8_t NAVIGATION_STATE_ALTCTL = 1;
+	static constexpr uint8_t NAVIGATION_STATE_POSCTL = 2;
+	static constexpr uint8_t NAVIGATION_STATE_AUTO_MISSION = 3;
+	static constexpr uint8_t NAVIGATION_STATE_AUTO_LOITER = 4;
+	static constexpr uint8_t NAVIGATION_STATE_AUTO_RTL = 5;
+	static constexpr uint8_t NAVIGATION_STATE_ACRO = 10;
+	static constexpr uint8_t NAVIGATION_STATE_DESCEND = 12;
+	static constexpr uint8_t NAVIGATION_STATE_TERMINATION = 13;
+	static constexpr uint8_t NAVIGATION_STATE_OFFBOARD = 14;
+	static constexpr uint8_t NAVIGATION_STATE_STAB = 15;
+	static constexpr uint8_t NAVIGATION_STATE_AUTO_TAKEOFF = 17;
+	static constexpr uint8_t NAVIGATION_STATE_AUTO_LAND = 18;
+	static constexpr uint8_t NAVIGATION_STATE_AUTO_FOLLOW_TARGET = 19;
+	static constexpr uint8_t NAVIGATION_STATE_AUTO_PRECLAND = 20;
+	static constexpr uint8_t NAVIGATION_STATE_ORBIT = 21;
+	static constexpr uint8_t NAVIGATION_STATE_AUTO_VTOL_TAKEOFF = 22;
+};
+
+ORB_DECLARE(vehicle_status);
@@ -0,0 +1,19 @@
+/**
+ * @file vehicle_torque_setpoint.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct vehicle_torque_setpoint_s {
+	uint64_t timestamp;
+	uint64_t timestamp_sample;
+	float xyz[3];
+};
+
+ORB_DECLARE(vehicle_torque_setpoint);
+ORB_DECLARE(vehicle_torque_setpoint_virtual_fw);
+ORB_DECLARE(vehicle_torque_setpoint_virtual_mc);
@@ -0,0 +1,23 @@
+/**
+ * @file vtol_vehicle_status.h
+ * @brief Host stand-in for the generated uORB message header.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <uORB/uORB.h>
+
+struct vtol_vehicle_status_s {
+	uint64_t timestamp;
+	uint8_t vehicle_vtol_state;
+	bool fixed_wing_system_failure;
+
+	static constexpr uint8_t VEHICLE_VTOL_STATE_UNDEFINED = 0;
+	static constexpr uint8_t VEHICLE_VTOL_STATE_TRANSITION_TO_FW = 1;
+	static constexpr uint8_t VEHICLE_VTOL_STATE_TRANSITION_TO_MC = 2;
+	static constexpr uint8_t VEHICLE_VTOL_STATE_MC = 3;
+	static constexpr uint8_t VEHICLE_VTOL_STATE_FW = 4;
+};
+
+ORB_DECLARE(vtol_vehicle_status);
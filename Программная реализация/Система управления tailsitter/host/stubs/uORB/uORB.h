@@ -0,0 +1,87 @@
+/**
+ * @file uORB.h
+ * @brief Host stand-in for the uORB core: topic metadata and the in-process broker.
+ *
+ * All topics live in a single process. A publication copies the message into the
+ * topic buffer, bumps the generation and schedules every registered callback
+ * work item, which matches what the controller sees on a real vehicle.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct orb_metadata {
+	const char *o_name;
+	const uint16_t o_size;
+	const uint16_t o_size_no_padding;
+};
+
+typedef const struct orb_metadata *orb_id_t;
+typedef void *orb_advert_t;
+
+#define ORB_MULTI_MAX_INSTANCES 4
+
+#define ORB_ID(_name) &__orb_##_name
+
+#define ORB_DECLARE(_name) extern "C" const struct orb_metadata __orb_##_name __attribute__((visibility("default")))
+
+#define ORB_DEFINE(_name, _struct) \
+	extern "C" const struct orb_metadata __orb_##_name = { #_name, sizeof(_struct), sizeof(_struct) }
+
+namespace px4
+{
+class WorkItem;
+}
+
+namespace uORB
+{
+
+class DeviceNode;
+
+/**
+ * Find (or create) the broker node of a topic instance.
+ */
+DeviceNode *get_node(const orb_metadata *meta, uint8_t instance);
+
+/**
+ * @return True if the topic instance has been advertised.
+ */
+bool node_advertised(const DeviceNode *node);
+
+/**
+ * Advertise a topic instance. For multi-instance topics the first free instance is taken.
+ *
+ * @return the advertised instance, or -1 if all instances are in use
+ */
+int advertise(const orb_metadata *meta, bool multi, int instance);
+
+/**
+ * Copy new data into the topic buffer and notify all subscribers.
+ */
+bool publish(const orb_metadata *meta, uint8_t instance, const void *data);
+
+/**
+ * Copy the latest data of a topic instance.
+ *
+ * @param generation in: last generation seen by the caller, out: generation copied
+ * @param only_if_updated skip the copy if the caller has already seen the latest generation
+ * @return true if data was copied
+ */
+bool copy(DeviceNode *node, void *dst, unsigned &generation, bool only_if_updated);
+
+/**
+ * @return The latest generation of a topic instance, 0 if never published.
+ */
+unsigned generation(const DeviceNode *node);
+
+void register_callback(DeviceNode *node, px4::WorkItem *item);
+void unregister_callback(DeviceNode *node, px4::WorkItem *item);
+
+/**
+ * Forget all topic data, advertisements and callbacks (between host runs).
+ */
+void reset_all();
+
+} // namespace uORB
@@ -0,0 +1,28 @@
+# Runs the scripted flight twice on the ManualClock and requires identical state transitions and
+# output checksums.
+#
+#   cmake -DHOST_BIN=<vtol_att_control_host_bin> -DVT_TYPE=<0|1|2> -P deterministic_replay.cmake
+
+foreach(run 1 2)
+	execute_process(
+		COMMAND ${HOST_BIN} ${VT_TYPE} 30 --trace
+		OUTPUT_VARIABLE output
+		RESULT_VARIABLE result
+	)
+
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "run ${run} failed (${result}):\n${output}")
+	endif()
+
+	string(REGEX MATCHALL "t=[^\n]*|checksum [0-9a-f]+" trace_${run} "${output}")
+
+	if(NOT trace_${run})
+		message(FATAL_ERROR "run ${run} printed no trace:\n${output}")
+	endif()
+endforeach()
+
+if(NOT trace_1 STREQUAL trace_2)
+	message(FATAL_ERROR "runs differ:\n${trace_1}\n---\n${trace_2}")
+endif()
+
+message(STATUS "identical runs: ${trace_1}")
@@ -0,0 +1,27 @@
+# Flies the scripted flight as an auto mission with a short fixed-wing phase and requires the
+# controller to publish its neutral flaps setpoint in the cycle the back transition starts,
+# replacing the deflection of the FW position controller.
+#
+#   cmake -DHOST_BIN=<vtol_att_control_host_bin> -DVT_TYPE=<0|1|2> -P flaps_after_back_transition.cmake
+
+# fixed-wing for less than VT_PUB_HB after the last flaps publication of the controller
+execute_process(
+	COMMAND ${HOST_BIN} ${VT_TYPE} 12 --trace --auto --back-transition 9 VT_PUB_HB=10
+	OUTPUT_VARIABLE output
+	RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "run failed (${result}):\n${output}")
+endif()
+
+# vtol_vehicle_status VEHICLE_VTOL_STATE_TRANSITION_TO_MC
+if(NOT output MATCHES "t=([0-9]+)\\.([0-9]+) vtol_state=2 ")
+	message(FATAL_ERROR "no back transition:\n${output}")
+endif()
+
+set(back_transition "t=${CMAKE_MATCH_1}\\.${CMAKE_MATCH_2}")
+
+if(NOT output MATCHES "${back_transition} flaps=0\\.00")
+	message(FATAL_ERROR "flaps not neutral in the first back transition cycle:\n${output}")
+endif()
@@ -0,0 +1,211 @@
+/**
+ * @file pusher_assist.cpp
+ * @brief VtolType::pusher_assist_limit_pitch() against the Euler/DCM implementation it replaced.
+ *
+ * Runs random attitude and setpoint pairs through the quaternion kernel, through the previous
+ * implementation (Euler angles and DCMs, float, fast_trig) and through the previous implementation
+ * in double with libm, and fails if
+ * - the kernel and the previous implementation disagree on whether the pitch is limited,
+ * - for hover-like attitudes, the forward thrust or setpoint deviate from the previous
+ *   implementation by more than kMaxThrustDeviation / kMaxAttitudeDeviation,
+ * - for arbitrary attitudes (pitch up to 88.9 deg), the largest deviation of the kernel from the
+ *   double evaluation exceeds that of the previous implementation by more than kMaxAttitudeDeviation.
+ *   Both are ill-conditioned there in float, so only the worst cases are compared.
+ *
+ * Usage: pusher_assist_test
+ */
+
+#include <vtol_fast_trig.h>
+#include <vtol_type.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+using namespace matrix;
+
+namespace
+{
+
+static constexpr int kCases = 400000;
+static constexpr float kThrustScale = 0.7f;
+static constexpr double kMaxThrustDeviation = 1e-6;
+static constexpr double kMaxAttitudeDeviation = 5e-6;	// [rad]
+
+// pitch beyond which the Euler decomposition is ill-conditioned in float, excluded from the comparison
+static constexpr float kMaxPitch = 1.552f;		// [rad] 88.9 deg
+// cases closer to the pitch limit are excluded, both may round to either side
+static constexpr double kLimitMargin = 1e-5;		// [rad]
+
+uint32_t _random_state = 1;
+
+// uniform in [min, max), fixed sequence so failures reproduce
+float random_uniform(float min, float max)
+{
+	_random_state = _random_state * 1664525u + 1013904223u;
+	return min + (max - min) * static_cast<float>(_random_state >> 8) * (1.f / 16777216.f);
+}
+
+float trig_sin(float x) { return fast_trig::sin(x); }
+float trig_asin(float x) { return fast_trig::asin(x); }
+float trig_atan2(float y, float x) { return fast_trig::atan2(y, x); }
+double trig_sin(double x) { return sin(x); }
+double trig_asin(double x) { return asin(x); }
+double trig_atan2(double y, double x) { return atan2(y, x); }
+
+/**
+ * Pitch limiting part of VtolType::pusher_assist() before the quaternion kernel.
+ *
+ * @param pitch_setpoint Set to the setpoint pitch in the heading frame
+ */
+template<typename T>
+float previous_limit_pitch(const Quatf &q_f, float q_d[4], float pitch_setpoint_min_f, float thrust_scale,
+			   T &pitch_setpoint)
+{
+	const T pitch_setpoint_min = pitch_setpoint_min_f;
+	const Quaternion<T> q(q_f(0), q_f(1), q_f(2), q_f(3));
+	const Dcm<T> R_sp(Quaternion<T>(q_d[0], q_d[1], q_d[2], q_d[3]));
+	const Euler<T> euler{Dcm<T>(q)};
+	const Euler<T> euler_sp(R_sp);
+
+	Vector3<T> body_z_sp(R_sp(0, 2), R_sp(1, 2), R_sp(2, 2));
+	const Dcm<T> R_yaw = Euler<T>(0, 0, -euler(2));
+	body_z_sp = R_yaw * body_z_sp;
+	body_z_sp.normalize();
+
+	pitch_setpoint = trig_atan2(body_z_sp(0), body_z_sp(2));
+
+	T forward_thrust = 0;
+
+	if (pitch_setpoint < pitch_setpoint_min) {
+		const T roll_new = -trig_asin(body_z_sp(1));
+		const T sin_pitch_setpoint = body_z_sp(0) / sqrt(body_z_sp(0) * body_z_sp(0) + body_z_sp(2) * body_z_sp(2));
+
+		forward_thrust = (trig_sin(pitch_setpoint_min) - sin_pitch_setpoint) * thrust_scale;
+		forward_thrust = math::constrain(forward_thrust, T(0), T(0.9));
+
+		const T pitch_new = pitch_setpoint_min > 0 ? pitch_setpoint_min : T(0);
+
+		const Dcm<T> R_tmp = Euler<T>(roll_new, pitch_new, 0);
+		Vector3<T> tilt_new(R_tmp(0, 2), R_tmp(1, 2), R_tmp(2, 2));
+
+		const T yaw_error = wrap_pi(euler_sp(2) - euler(2));
+		const Dcm<T> R_yaw_correction = Euler<T>(0, 0, -yaw_error);
+		tilt_new = R_yaw_correction * tilt_new;
+
+		const T pitch_body = trig_atan2(tilt_new(0), tilt_new(2));
+		const T roll_body = -trig_asin(tilt_new(1));
+
+		const Quaternion<T> q_sp(Euler<T>(roll_body, pitch_body, euler_sp(2)));
+
+		for (int i = 0; i < 4; i++) {
+			q_d[i] = q_sp(i);
+		}
+	}
+
+	return forward_thrust;
+}
+
+/**
+ * @return Rotation angle between two attitudes [rad], in double to resolve small deviations
+ */
+double attitude_deviation(const float a[4], const float b[4])
+{
+	const double w = (double)a[0] * b[0] + (double)a[1] * b[1] + (double)a[2] * b[2] + (double)a[3] * b[3];
+	const double x = (double)a[0] * b[1] - (double)a[1] * b[0] - (double)a[2] * b[3] + (double)a[3] * b[2];
+	const double y = (double)a[0] * b[2] + (double)a[1] * b[3] - (double)a[2] * b[0] - (double)a[3] * b[1];
+	const double z = (double)a[0] * b[3] - (double)a[1] * b[2] + (double)a[2] * b[1] - (double)a[3] * b[0];
+	return 2.0 * atan2(sqrt(x * x + y * y + z * z), fabs(w));
+}
+
+Quatf random_attitude(bool hover)
+{
+	if (hover) {
+		return Quatf(Eulerf(random_uniform(-0.6f, 0.6f), random_uniform(-0.6f, 0.6f), random_uniform(-M_PI_F, M_PI_F)));
+	}
+
+	return Quatf(Eulerf(random_uniform(-M_PI_F, M_PI_F), random_uniform(-kMaxPitch, kMaxPitch),
+			    random_uniform(-M_PI_F, M_PI_F)));
+}
+
+struct Deviation {
+	int cases;
+	int limited;
+	double thrust;		// kernel against the previous implementation
+	double attitude;	// [rad] kernel against the previous implementation
+	double error;		// [rad] kernel against the double evaluation
+	double error_previous;	// [rad] previous implementation against the double evaluation
+};
+
+} // namespace
+
+int main()
+{
+	Deviation deviation[2] {};	// hover-like, arbitrary
+	int mismatches = 0;
+
+	for (int i = 0; i < kCases; i++) {
+		const bool hover = (i % 2) == 0;
+		const Quatf q = random_attitude(hover);
+		const Quatf q_sp = random_attitude(hover);
+		const float pitch_setpoint_min = random_uniform(-0.3f, 0.5f);
+
+		float q_d[4], q_d_previous[4], q_d_double[4];
+		q_sp.copyTo(q_d);
+		q_sp.copyTo(q_d_previous);
+		q_sp.copyTo(q_d_double);
+
+		float pitch_previous;
+		double pitch_double;
+		const float thrust = VtolType::pusher_assist_limit_pitch(q, q_d, pitch_setpoint_min, kThrustScale);
+		const float thrust_previous = previous_limit_pitch(q, q_d_previous, pitch_setpoint_min, kThrustScale, pitch_previous);
+		previous_limit_pitch(q, q_d_double, pitch_setpoint_min, kThrustScale, pitch_double);
+
+		if (fabs(pitch_double - pitch_setpoint_min) < kLimitMargin) {
+			continue;
+		}
+
+		const bool limited = q_d[0] != q_sp(0) || q_d[1] != q_sp(1) || q_d[2] != q_sp(2) || q_d[3] != q_sp(3);
+		const bool limited_previous = pitch_previous < pitch_setpoint_min;
+
+		if (limited != limited_previous) {
+			mismatches++;
+			continue;
+		}
+
+		Deviation &d = deviation[hover ? 0 : 1];
+		d.cases++;
+		d.limited += limited;
+		d.thrust = fmax(d.thrust, fabs((double)thrust - thrust_previous));
+		d.attitude = fmax(d.attitude, attitude_deviation(q_d, q_d_previous));
+		d.error = fmax(d.error, attitude_deviation(q_d, q_d_double));
+		d.error_previous = fmax(d.error_previous, attitude_deviation(q_d_previous, q_d_double));
+	}
+
+	static const char *const names[2] {"hover-like", "arbitrary"};
+
+	for (int k = 0; k < 2; k++) {
+		printf("%-10s %d cases, %d limited: thrust %.3g, attitude %.3g rad, error against double %.3g rad (previous %.3g)\n",
+		       names[k], deviation[k].cases, deviation[k].limited, deviation[k].thrust, deviation[k].attitude,
+		       deviation[k].error, deviation[k].error_previous);
+	}
+
+	bool passed = true;
+
+	if (mismatches > 0) {
+		printf("FAIL: %d cases limited by one implementation only\n", mismatches);
+		passed = false;
+	}
+
+	if (!(deviation[0].thrust <= kMaxThrustDeviation && deviation[0].attitude <= kMaxAttitudeDeviation)) {
+		printf("FAIL: hover-like deviation above %.3g / %.3g rad\n", kMaxThrustDeviation, kMaxAttitudeDeviation);
+		passed = false;
+	}
+
+	if (!(deviation[1].error <= deviation[1].error_previous + kMaxAttitudeDeviation)) {
+		printf("FAIL: arbitrary attitudes less accurate than before by more than %.3g rad\n", kMaxAttitudeDeviation);
+		passed = false;
+	}
+
+	return passed ? 0 : 1;
+}
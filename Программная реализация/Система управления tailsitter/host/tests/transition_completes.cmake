@@ -0,0 +1,25 @@
+# Flies the scripted flight with the given parameters and requires the front transition to reach
+# fixed-wing without a quadchute.
+#
+#   cmake -DHOST_BIN=<vtol_att_control_host_bin> -DVT_TYPE=<0|1|2> -DPARAMS=NAME=value,... -P transition_completes.cmake
+
+string(REPLACE "," ";" params "${PARAMS}")
+
+execute_process(
+	COMMAND ${HOST_BIN} ${VT_TYPE} 30 --trace ${params}
+	OUTPUT_VARIABLE output
+	RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "run failed (${result}):\n${output}")
+endif()
+
+# vtol_vehicle_status VEHICLE_VTOL_STATE_FW
+if(NOT output MATCHES "vtol_state=4 fw_failure=0")
+	message(FATAL_ERROR "front transition did not complete with ${PARAMS}:\n${output}")
+endif()
+
+if(output MATCHES "fw_failure=1")
+	message(FATAL_ERROR "quadchute with ${PARAMS}:\n${output}")
+endif()
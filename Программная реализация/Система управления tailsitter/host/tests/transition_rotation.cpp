@@ -0,0 +1,147 @@
+/**
+ * @file transition_rotation.cpp
+ * @brief Tailsitter transition setpoint: incremental propagation against the closed form.
+ *
+ * Propagates the setpoint over full front and back transitions, as Tailsitter does, with
+ * random start attitudes, durations, shapes and jittered 2-6 ms control intervals plus
+ * occasional stalls, and fails if the setpoint deviates from the closed-form quaternion by more
+ * than kMaxDeviation at any step. Also reports the cost per update of both.
+ *
+ * Usage: transition_rotation_test
+ */
+
+#include <vtol_clock.h>
+#include <vtol_transition_rotation.h>
+#include <vtol_transition_schedule.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+using namespace matrix;
+
+namespace
+{
+
+static constexpr int kTransitions = 2000;
+static constexpr double kMaxDeviation = 1e-5;	// [rad]
+
+uint32_t _random_state = 1;
+
+// uniform in [min, max), fixed sequence so failures reproduce
+float random_uniform(float min, float max)
+{
+	_random_state = _random_state * 1664525u + 1013904223u;
+	return min + (max - min) * static_cast<float>(_random_state >> 8) * (1.f / 16777216.f);
+}
+
+/**
+ * @return Rotation angle between two attitudes [rad], in double to resolve small deviations
+ */
+double attitude_deviation(const Quatf &a, const Quatf &b)
+{
+	const double w = (double)a(0) * b(0) + (double)a(1) * b(1) + (double)a(2) * b(2) + (double)a(3) * b(3);
+	const double x = (double)a(0) * b(1) - (double)a(1) * b(0) - (double)a(2) * b(3) + (double)a(3) * b(2);
+	const double y = (double)a(0) * b(2) + (double)a(1) * b(3) - (double)a(2) * b(0) - (double)a(3) * b(1);
+	const double z = (double)a(0) * b(3) - (double)a(1) * b(2) + (double)a(2) * b(1) - (double)a(3) * b(0);
+	return 2.0 * atan2(sqrt(x * x + y * y + z * z), fabs(w));
+}
+
+struct Transition {
+	Quatf q_start;
+	Vector3f axis;
+	TransitionSchedule angle_schedule;
+	float duration;		// [s] until the setpoint is held
+};
+
+Transition random_transition()
+{
+	Transition transition;
+	transition.q_start = Quatf(Eulerf(random_uniform(-0.3f, 0.3f), random_uniform(-1.6f, 0.3f),
+					  random_uniform(-M_PI_F, M_PI_F)));
+	const float axis_heading = random_uniform(-M_PI_F, M_PI_F);
+	transition.axis = Vector3f(cosf(axis_heading), sinf(axis_heading), random_uniform(-0.2f, 0.2f));
+	transition.axis.normalize();
+
+	// as in Tailsitter: 0 to 90 deg over VT_F_TRANS_DUR / VT_B_TRANS_DUR, continued until the pitch limit
+	const float trans_dur = random_uniform(0.1f, 8.f);
+	transition.angle_schedule.build(0.f, trans_dur, 0.f, M_PI_2_F, random_uniform(-1.f, 1.f), true);
+	transition.duration = 1.3f * trans_dur;
+	return transition;
+}
+
+float random_interval()
+{
+	// 2-6 ms, with a stall of up to 100 ms on every 200th step on average
+	return random_uniform(0.f, 1.f) < 0.005f ? random_uniform(0.006f, 0.1f) : random_uniform(0.002f, 0.006f);
+}
+
+} // namespace
+
+int main()
+{
+	double max_deviation = 0.0;
+	double max_norm_error = 0.0;
+	int steps = 0;
+
+	for (int i = 0; i < kTransitions; i++) {
+		const Transition transition = random_transition();
+
+		TransitionRotation rotation;
+		rotation.start(transition.q_start, transition.axis);
+
+		for (float t = 0.f; t < transition.duration; t += random_interval()) {
+			const float angle = transition.angle_schedule.evaluate(t);
+			rotation.rotate_to(angle);
+
+			const Quatf closed_form = TransitionRotation::closed_form(rotation.start_attitude(), rotation.axis(), angle);
+			const double deviation = attitude_deviation(rotation.setpoint(), closed_form);
+
+			if (deviation > max_deviation) {
+				max_deviation = deviation;
+			}
+
+			const double norm_error = fabs((double)rotation.setpoint().norm() - 1.0);
+
+			if (norm_error > max_norm_error) {
+				max_norm_error = norm_error;
+			}
+
+			steps++;
+		}
+	}
+
+	// cost per update over one 5 s transition at 4 ms
+	const Transition transition = random_transition();
+	TransitionRotation rotation;
+	rotation.start(transition.q_start, transition.axis);
+	float sink = 0.f;
+
+	const uint64_t incremental_start = measurement_time_ns();
+
+	for (int i = 0; i < 1250; i++) {
+		rotation.rotate_to(transition.angle_schedule.evaluate(0.004f * i));
+		sink += rotation.setpoint()(0);
+	}
+
+	const uint64_t closed_form_start = measurement_time_ns();
+
+	for (int i = 0; i < 1250; i++) {
+		sink += TransitionRotation::closed_form(rotation.start_attitude(), rotation.axis(),
+							transition.angle_schedule.evaluate(0.004f * i))(0);
+	}
+
+	const uint64_t closed_form_end = measurement_time_ns();
+
+	printf("%d transitions, %d steps: max deviation %.3g rad (limit %.3g), max norm error %.3g\n",
+	       kTransitions, steps, max_deviation, kMaxDeviation, max_norm_error);
+	printf("per update: incremental %.1f ns, closed form %.1f ns (%g)\n",
+	       (closed_form_start - incremental_start) / 1250., (closed_form_end - closed_form_start) / 1250., (double)sink);
+
+	if (!(max_deviation <= kMaxDeviation)) {
+		printf("FAIL: setpoint deviates from the closed form\n");
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file transition_schedule.cpp
+ * @brief TransitionSchedule end values against thresholds on them.
+ *
+ * The transitions end when a schedule reaches its end value (e.g. the tiltrotor P1 tilt against
+ * VT_TILT_TRANS), so past x_end a schedule has to return its end value exactly, not 1 ulp below,
+ * and an extended ascending one at least that. Builds the schedules for every start/end pair on a
+ * 0.01 grid over [0, 1] (the VT_TILT_* range) and shapes on a 0.25 grid over [-1, 1].
+ *
+ * Usage: transition_schedule_test
+ */
+
+#include <vtol_transition_schedule.h>
+
+#include <stdio.h>
+
+int main()
+{
+	static constexpr float kDuration = 3.f;		// [s] VT_F_TRANS_DUR
+	static constexpr int kSteps = 100;
+
+	int schedules = 0;
+	int failures = 0;
+
+	for (int i = 0; i <= kSteps; i++) {
+		for (int j = i; j <= kSteps; j++) {
+			for (int k = -4; k <= 4; k++) {
+				const float start = i * (1.f / kSteps);
+				const float end = j * (1.f / kSteps);
+				const float shape = k * 0.25f;
+
+				for (int extend = 0; extend < 2; extend++) {
+					TransitionSchedule schedule;
+					schedule.build(0.f, kDuration, start, end, shape, extend);
+					schedules++;
+
+					// first control cycle past the end and well past it
+					const float past_end = schedule.evaluate(kDuration + 0.004f);
+					const float late = schedule.evaluate(kDuration + 1.f);
+					const bool reached = extend ? (past_end >= end && late >= end) : (past_end == end && late == end);
+
+					if (!reached && failures++ < 10) {
+						printf("start %.2f end %.2f shape %.2f extend %d: %.9g / %.9g against %.9g\n", (double)start,
+						       (double)end, (double)shape, extend, (double)past_end, (double)late, (double)end);
+					}
+				}
+			}
+		}
+	}
+
+	printf("%d schedules, %d not reaching their end value\n", schedules, failures);
+
+	if (failures > 0) {
+		printf("FAIL: schedule does not reach its end value\n");
+		return 1;
+	}
+
+	return 0;
+}
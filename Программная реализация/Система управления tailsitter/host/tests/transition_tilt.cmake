@@ -0,0 +1,29 @@
+# Flies the scripted flight with the given parameters and requires the attitude setpoint at the end
+# of the run to be tilted by MIN_TILT to MAX_TILT degrees from hover.
+#
+#   cmake -DHOST_BIN=<vtol_att_control_host_bin> -DVT_TYPE=<0|1|2> -DSECONDS=<s> -DPARAMS=NAME=value,...
+#         -DMIN_TILT=<deg> -DMAX_TILT=<deg> -P transition_tilt.cmake
+
+string(REPLACE "," ";" params "${PARAMS}")
+
+execute_process(
+	COMMAND ${HOST_BIN} ${VT_TYPE} ${SECONDS} --trace ${params}
+	OUTPUT_VARIABLE output
+	RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "run failed (${result}):\n${output}")
+endif()
+
+if(NOT output MATCHES "setpoint tilt ([-0-9.]+) deg")
+	message(FATAL_ERROR "no setpoint tilt printed:\n${output}")
+endif()
+
+set(tilt ${CMAKE_MATCH_1})
+
+if(tilt LESS MIN_TILT OR tilt GREATER MAX_TILT)
+	message(FATAL_ERROR "setpoint tilt ${tilt} deg outside [${MIN_TILT}, ${MAX_TILT}] with ${PARAMS}:\n${output}")
+endif()
+
+message(STATUS "setpoint tilt ${tilt} deg with ${PARAMS}")
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+Generate the host parameter table (parameters/px4_parameters.hpp) from the
+PARAM_DEFINE_INT32 / PARAM_DEFINE_FLOAT entries of the given *_params.c files.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+PARAM_RE = re.compile(r'^\s*PARAM_DEFINE_(INT32|FLOAT)\(\s*([A-Z0-9_]+)\s*,\s*([^)]+?)\s*\)\s*;', re.MULTILINE)
+
+
+def parse(files):
+    params = {}
+
+    for path in files:
+        with open(path, encoding='utf-8') as f:
+            for kind, name, default in PARAM_RE.findall(f.read()):
+                if name in params:
+                    sys.exit('duplicate parameter %s in %s' % (name, path))
+
+                params[name] = (kind, default.rstrip('fF') if kind == 'FLOAT' else default)
+
+    return sorted(params.items())
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--output', required=True)
+    parser.add_argument('inputs', nargs='+')
+    args = parser.parse_args()
+
+    params = parse(args.inputs)
+
+    lines = [
+        '// generated by px_generate_params.py, do not edit',
+        '#pragma once',
+        '',
+        '#include <parameters/param.h>',
+        '',
+        'namespace px4',
+        '{',
+        '',
+        'enum class params : uint16_t {',
+    ]
+    lines += ['\t%s,' % name for name, _ in params]
+    lines += [
+        '};',
+        '',
+        'struct param_info_s {',
+        '\tconst char *name;',
+        '\tparam_type_t type;',
+        '\tint32_t default_int;',
+        '\tfloat default_float;',
+        '};',
+        '',
+        'static constexpr param_info_s param_table[] = {',
+    ]
+
+    for name, (kind, default) in params:
+        if kind == 'FLOAT':
+            lines.append('\t{"%s", PARAM_TYPE_FLOAT, 0, %sf},' % (name, float(default)))
+        else:
+            lines.append('\t{"%s", PARAM_TYPE_INT32, %s, 0.f},' % (name, int(default, 0)))
+
+    lines += [
+        '};',
+        '',
+        'static constexpr unsigned param_table_size = sizeof(param_table) / sizeof(param_table[0]);',
+        '',
+        '} // namespace px4',
+        '',
+    ]
+
+    os.makedirs(os.path.dirname(args.output), exist_ok=True)
+
+    with open(args.output, 'w') as f:
+        f.write('\n'.join(lines))
+
+
+if __name__ == '__main__':
+    main()
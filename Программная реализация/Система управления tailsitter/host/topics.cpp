@@ -0,0 +1,58 @@
+/**
+ * @file topics.cpp
+ * @brief uORB metadata for the host stand-in topics.
+ */
+
+#include <uORB/topics/action_request.h>
+#include <uORB/topics/airspeed_validated.h>
+#include <uORB/topics/home_position.h>
+#include <uORB/topics/normalized_unsigned_setpoint.h>
+#include <uORB/topics/parameter_update.h>
+#include <uORB/topics/position_setpoint.h>
+#include <uORB/topics/position_setpoint_triplet.h>
+#include <uORB/topics/tecs_status.h>
+#include <uORB/topics/tiltrotor_extra_controls.h>
+#include <uORB/topics/vehicle_air_data.h>
+#include <uORB/topics/vehicle_attitude.h>
+#include <uORB/topics/vehicle_attitude_setpoint.h>
+#include <uORB/topics/vehicle_command.h>
+#include <uORB/topics/vehicle_command_ack.h>
+#include <uORB/topics/vehicle_control_mode.h>
+#include <uORB/topics/vehicle_land_detected.h>
+#include <uORB/topics/vehicle_local_position.h>
+#include <uORB/topics/vehicle_local_position_setpoint.h>
+#include <uORB/topics/vehicle_status.h>
+#include <uORB/topics/vehicle_thrust_setpoint.h>
+#include <uORB/topics/vehicle_torque_setpoint.h>
+#include <uORB/topics/vtol_vehicle_status.h>
+
+ORB_DEFINE(action_request, struct action_request_s);
+ORB_DEFINE(airspeed_validated, struct airspeed_validated_s);
+ORB_DEFINE(home_position, struct home_position_s);
+ORB_DEFINE(normalized_unsigned_setpoint, struct normalized_unsigned_setpoint_s);
+ORB_DEFINE(flaps_setpoint, struct normalized_unsigned_setpoint_s);
+ORB_DEFINE(spoilers_setpoint, struct normalized_unsigned_setpoint_s);
+ORB_DEFINE(parameter_update, struct parameter_update_s);
+ORB_DEFINE(position_setpoint, struct position_setpoint_s);
+ORB_DEFINE(position_setpoint_triplet, struct position_setpoint_triplet_s);
+ORB_DEFINE(tecs_status, struct tecs_status_s);
+ORB_DEFINE(tiltrotor_extra_controls, struct tiltrotor_extra_controls_s);
+ORB_DEFINE(vehicle_air_data, struct vehicle_air_data_s);
+ORB_DEFINE(vehicle_attitude, struct vehicle_attitude_s);
+ORB_DEFINE(vehicle_attitude_setpoint, struct vehicle_attitude_setpoint_s);
+ORB_DEFINE(mc_virtual_attitude_setpoint, struct vehicle_attitude_setpoint_s);
+ORB_DEFINE(fw_virtual_attitude_setpoint, struct vehicle_attitude_setpoint_s);
+ORB_DEFINE(vehicle_command, struct vehicle_command_s);
+ORB_DEFINE(vehicle_command_ack, struct vehicle_command_ack_s);
+ORB_DEFINE(vehicle_control_mode, struct vehicle_control_mode_s);
+ORB_DEFINE(vehicle_land_detected, struct vehicle_land_detected_s);
+ORB_DEFINE(vehicle_local_position, struct vehicle_local_position_s);
+ORB_DEFINE(vehicle_local_position_setpoint, struct vehicle_local_position_setpoint_s);
+ORB_DEFINE(vehicle_status, struct vehicle_status_s);
+ORB_DEFINE(vehicle_thrust_setpoint, struct vehicle_thrust_setpoint_s);
+ORB_DEFINE(vehicle_thrust_setpoint_virtual_fw, struct vehicle_thrust_setpoint_s);
+ORB_DEFINE(vehicle_thrust_setpoint_virtual_mc, struct vehicle_thrust_setpoint_s);
+ORB_DEFINE(vehicle_torque_setpoint, struct vehicle_torque_setpoint_s);
+ORB_DEFINE(vehicle_torque_setpoint_virtual_fw, struct vehicle_torque_setpoint_s);
+ORB_DEFINE(vehicle_torque_setpoint_virtual_mc, struct vehicle_torque_setpoint_s);
+ORB_DEFINE(vtol_vehicle_status, struct vtol_vehicle_status_s);
@@ -3,6 +3,10 @@
  * @brief Implementation of the Standard VTOL (Vertical Takeoff and Landing) attitude control.
  */
 
+#include "vtol_type_config.h"
+
+#if VTOL_ATT_CONTROL_HAS_STANDARD
+
 #include "standard.h"
 #include "vtol_att_control_main.h"
 
@@ -10,6 +14,7 @@
 
 using namespace matrix; 
 
+
 /**
  * @brief Constructor for the Standard class.
  * @param attc Pointer to the VTOL attitude control object.
@@ -33,12 +38,51 @@ Standard::parameters_update()
 	_param_vt_b_trans_ramp.set(math::min(_param_vt_b_trans_ramp.get(), _param_vt_b_trans_dur.get()));
 }
 
+/**
+ * @brief Rebuild the transition schedules.
+ *
+ * In the front transition the MC weight decreases from the blending to the transition airspeed,
+ * or without airspeed over the second half of the minimum transition time. In the back transition
+ * it increases over VT_B_TRANS_RAMP. The pusher ramp stays a slew rate limit, it starts from the
+ * pusher assist throttle at the transition start.
+ */
+
+void Standard::update_transition_schedules()
+{
+	VtolType::update_transition_schedules();
+
+	_front_weight_airspeed_schedule.build(getBlendAirspeed(), getTransitionAirspeed(), 1.f, 0.f,
+					      _param_vt_shape_weight.get());
+	_front_weight_time_schedule.build(0.5f * getMinimumFrontTransitionTime(), getMinimumFrontTransitionTime(), 1.f, 0.f,
+					  _param_vt_shape_weight.get());
+	_back_weight_schedule.build(0.f, _param_vt_b_trans_ramp.get(), 0.f, 1.f, _param_vt_shape_weight.get());
+}
+
+/**
+ * @brief Returns the name of the current standard flight mode.
+ */
+
+const char *Standard::get_vtol_mode_name() const
+{
+	switch (_vtol_mode) {
+	case vtol_mode::MC_MODE: return "MC";
+
+	case vtol_mode::TRANSITION_TO_FW: return "TRANSITION_TO_FW";
+
+	case vtol_mode::TRANSITION_TO_MC: return "TRANSITION_TO_MC";
+
+	case vtol_mode::FW_MODE: return "FW";
+	}
+
+	return "unknown";
+}
+
 /**
  * @brief Updates the current VTOL state, which includes managing the transition between
  * multicopter and fixed-wing modes, handling motor state changes, and engaging failsafe modes.
  */
 
-void Standard::update_vtol_state()
+void Standard::update_vtol_state(const VtolControlCycle &cycle)
 {
     /* After switching to FW mode, the vehicle will start the pusher motor, picking up
 	     * forward speed. After reaching enough speed, the rotors shut down.
@@ -62,7 +106,7 @@ void Standard::update_vtol_state()
 
 		} else if (_vtol_mode == vtol_mode::FW_MODE) {
 			// Regular backtransition
-			resetTransitionStates();
+			resetTransitionStates(cycle);
 			_vtol_mode = vtol_mode::TRANSITION_TO_MC;
 
 		} else if (_vtol_mode == vtol_mode::TRANSITION_TO_FW) {
@@ -75,13 +119,11 @@ void Standard::update_vtol_state()
 			// speed exit condition: use ground if valid, otherwise airspeed
 			bool exit_backtransition_speed_condition = false;
 
-			if (_local_pos->v_xy_valid) {
-				const Dcmf R_to_body(Quatf(_v_att->q).inversed());
-				const Vector3f vel = R_to_body * Vector3f(_local_pos->vx, _local_pos->vy, _local_pos->vz);
-				exit_backtransition_speed_condition = vel(0) < _param_mpc_xy_cruise.get();
+			if (_io->in.v_xy_valid) {
+				exit_backtransition_speed_condition = _attitude.velocity_body()(0) < _param_mpc_xy_cruise.get();
 
-			} else if (PX4_ISFINITE(_airspeed_validated->calibrated_airspeed_m_s)) {
-				exit_backtransition_speed_condition = _airspeed_validated->calibrated_airspeed_m_s < _param_mpc_xy_cruise.get();
+			} else if (PX4_ISFINITE(_io->in.calibrated_airspeed)) {
+				exit_backtransition_speed_condition = _io->in.calibrated_airspeed < _param_mpc_xy_cruise.get();
 			}
 
 			const bool exit_backtransition_time_condition = _time_since_trans_start > _param_vt_b_trans_dur.get();
@@ -97,7 +139,7 @@ void Standard::update_vtol_state()
 			// start transition to fw mode
 			/* NOTE: The failsafe transition to fixed-wing was removed because it can result in an
 			 * unsafe flying state. */
-			resetTransitionStates();
+			resetTransitionStates(cycle);
 			_vtol_mode = vtol_mode::TRANSITION_TO_FW;
 
 		} else if (_vtol_mode == vtol_mode::FW_MODE) {
@@ -111,7 +153,7 @@ void Standard::update_vtol_state()
 				_vtol_mode = vtol_mode::FW_MODE;
 
 				// don't set pusher throttle here as it's being ramped up elsewhere
-				_trans_finished_ts = hrt_absolute_time();
+				_trans_finished_ts = cycle.now;
 			}
 		}
 	}
@@ -145,12 +187,12 @@ void Standard::update_vtol_state()
  * @brief Updates the state during transitions between multicopter and fixed-wing modes.
  */
 
-void Standard::update_transition_state()
+void Standard::update_transition_state(const VtolControlCycle &cycle)
 {
-	const hrt_abstime now = hrt_absolute_time();
+	const hrt_abstime now = cycle.now;
 	float mc_weight = 1.0f;
 
-	VtolType::update_transition_state();
+	VtolType::update_transition_state(cycle);
 
 	const Eulerf attitude_setpoint_euler(Quatf(_v_att_sp->q_d));
 	float roll_body = attitude_setpoint_euler.phi();
@@ -159,7 +201,7 @@ void Standard::update_transition_state()
 
 	// we get attitude setpoint from a multirotor flighttask if climbrate is controlled.
 	// in any other case the fixed wing attitude controller publishes attitude setpoint from manual stick input.
-	if (_v_control_mode->flag_control_climb_rate_enabled) {
+	if (_io->in.climb_rate_control) {
 		// we need the incoming (virtual) attitude setpoints (both mc and fw) to be recent, otherwise return (means the previous setpoint stays active)
 		if (_mc_virtual_att_sp->timestamp < (now - 1_s) || _fw_virtual_att_sp->timestamp < (now - 1_s)) {
 			return;
@@ -192,23 +234,18 @@ void Standard::update_transition_state()
 			_last_time_pusher_transition_update = now;
 		}
 
-		_airspeed_trans_blend_margin = getTransitionAirspeed() - getBlendAirspeed();
-
 		// do blending of mc and fw controls if a blending airspeed has been provided and the minimum transition time has passed
-		if (_airspeed_trans_blend_margin > 0.0f &&
-		    PX4_ISFINITE(_airspeed_validated->calibrated_airspeed_m_s) &&
-		    _airspeed_validated->calibrated_airspeed_m_s > 0.0f &&
-		    _airspeed_validated->calibrated_airspeed_m_s >= getBlendAirspeed() &&
+		if (_derived.blend_airspeed_margin > 0.0f &&
+		    PX4_ISFINITE(_io->in.calibrated_airspeed) &&
+		    _io->in.calibrated_airspeed > 0.0f &&
+		    _io->in.calibrated_airspeed >= getBlendAirspeed() &&
 		    _time_since_trans_start > getMinimumFrontTransitionTime()) {
 
-			mc_weight = 1.0f - fabsf(_airspeed_validated->calibrated_airspeed_m_s - getBlendAirspeed()) /
-				    _airspeed_trans_blend_margin;
-			// time based blending when no airspeed sensor is set
-
-		} else if (!_param_fw_use_airspd.get() || !PX4_ISFINITE(_airspeed_validated->calibrated_airspeed_m_s)) {
-			mc_weight = 1.0f - _time_since_trans_start / getMinimumFrontTransitionTime();
-			mc_weight = math::constrain(2.0f * mc_weight, 0.0f, 1.0f);
+			mc_weight = _front_weight_airspeed_schedule.evaluate(_io->in.calibrated_airspeed);
 
+		} else if (!_param_fw_use_airspd.get() || !PX4_ISFINITE(_io->in.calibrated_airspeed)) {
+			// time based blending when no airspeed sensor is set
+			mc_weight = _front_weight_time_schedule.evaluate(_time_since_trans_start);
 		}
 
 		// ramp up FW_PSP_OFF
@@ -219,9 +256,9 @@ void Standard::update_transition_state()
 
 	} else if (_vtol_mode == vtol_mode::TRANSITION_TO_MC) {
 
-		if (_v_control_mode->flag_control_climb_rate_enabled) {
+		if (_io->in.climb_rate_control) {
 			// control backtransition deceleration using pitch.
-			pitch_body = update_and_get_backtransition_pitch_sp();
+			pitch_body = update_and_get_backtransition_pitch_sp(cycle.dt);
 		}
 
 		const Quatf q_sp(Eulerf(roll_body, pitch_body, yaw_body));
@@ -231,7 +268,7 @@ void Standard::update_transition_state()
 
 		// continually increase mc attitude control as we transition back to mc mode
 		if (_param_vt_b_trans_ramp.get() > FLT_EPSILON) {
-			mc_weight = _time_since_trans_start / _param_vt_b_trans_ramp.get();
+			mc_weight = _back_weight_schedule.evaluate(_time_since_trans_start);
 		}
 	}
 
@@ -243,9 +280,24 @@ void Standard::update_transition_state()
 	_mc_throttle_weight = mc_weight;
 }
 
-void Standard::update_mc_state()
+/**
+ * @brief Inputs of the standard VTOL, pusher assist in hover needs the attitude and the position setpoint.
+ */
+
+uint16_t Standard::get_input_set(mode vtol_mode) const
+{
+	uint16_t inputs = VtolType::get_input_set(vtol_mode);
+
+	if (vtol_mode == mode::ROTARY_WING) {
+		inputs |= INPUT_ATTITUDE | INPUT_POSITION_SETPOINT_TRIPLET;
+	}
+
+	return inputs;
+}
+
+void Standard::update_mc_state(const VtolControlCycle &cycle)
 {
-	VtolType::update_mc_state();
+	VtolType::update_mc_state(cycle);
 
 	_pusher_throttle = VtolType::pusher_assist();
 }
@@ -254,9 +306,9 @@ void Standard::update_mc_state()
  * @brief Updates the state when in fixed-wing mode.
  */
 
-void Standard::update_fw_state()
+void Standard::update_fw_state(const VtolControlCycle &cycle)
 {
-	VtolType::update_fw_state();
+	VtolType::update_fw_state(cycle);
 }
 
 /**
@@ -264,48 +316,44 @@ void Standard::update_fw_state()
  * blending between modes.
  */
 
-void Standard::fill_actuator_outputs()
+void Standard::fill_actuator_outputs(const VtolControlCycle &cycle)
 {
-	_torque_setpoint_0->timestamp = hrt_absolute_time();
-	_torque_setpoint_0->timestamp_sample = _vehicle_torque_setpoint_virtual_mc->timestamp_sample;
-	_torque_setpoint_0->xyz[0] = 0.f;
-	_torque_setpoint_0->xyz[1] = 0.f;
-	_torque_setpoint_0->xyz[2] = 0.f;
-
-	_torque_setpoint_1->timestamp = hrt_absolute_time();
-	_torque_setpoint_1->timestamp_sample = _vehicle_torque_setpoint_virtual_fw->timestamp_sample;
-	_torque_setpoint_1->xyz[0] = 0.f;
-	_torque_setpoint_1->xyz[1] = 0.f;
-	_torque_setpoint_1->xyz[2] = 0.f;
-
-	_thrust_setpoint_0->timestamp = hrt_absolute_time();
-	_thrust_setpoint_0->timestamp_sample = _vehicle_thrust_setpoint_virtual_mc->timestamp_sample;
-	_thrust_setpoint_0->xyz[0] = 0.f;
-	_thrust_setpoint_0->xyz[1] = 0.f;
-	_thrust_setpoint_0->xyz[2] = 0.f;
-
-	_thrust_setpoint_1->timestamp = hrt_absolute_time();
-	_thrust_setpoint_1->timestamp_sample = _vehicle_thrust_setpoint_virtual_fw->timestamp_sample;
-	_thrust_setpoint_1->xyz[0] = 0.f;
-	_thrust_setpoint_1->xyz[1] = 0.f;
-	_thrust_setpoint_1->xyz[2] = 0.f;
+	_io->out.torque_0.timestamp_sample = _io->in.mc_torque.timestamp_sample;
+	_io->out.torque_0.xyz[0] = 0.f;
+	_io->out.torque_0.xyz[1] = 0.f;
+	_io->out.torque_0.xyz[2] = 0.f;
+
+	_io->out.torque_1.timestamp_sample = _io->in.fw_torque.timestamp_sample;
+	_io->out.torque_1.xyz[0] = 0.f;
+	_io->out.torque_1.xyz[1] = 0.f;
+	_io->out.torque_1.xyz[2] = 0.f;
+
+	_io->out.thrust_0.timestamp_sample = _io->in.mc_thrust.timestamp_sample;
+	_io->out.thrust_0.xyz[0] = 0.f;
+	_io->out.thrust_0.xyz[1] = 0.f;
+	_io->out.thrust_0.xyz[2] = 0.f;
+
+	_io->out.thrust_1.timestamp_sample = _io->in.fw_thrust.timestamp_sample;
+	_io->out.thrust_1.xyz[0] = 0.f;
+	_io->out.thrust_1.xyz[1] = 0.f;
+	_io->out.thrust_1.xyz[2] = 0.f;
 
 	switch (_vtol_mode) {
 	case vtol_mode::MC_MODE:
 
 		// MC actuators:
-		_torque_setpoint_0->xyz[0] = _vehicle_torque_setpoint_virtual_mc->xyz[0];
-		_torque_setpoint_0->xyz[1] = _vehicle_torque_setpoint_virtual_mc->xyz[1];
-		_torque_setpoint_0->xyz[2] = _vehicle_torque_setpoint_virtual_mc->xyz[2];
-		_thrust_setpoint_0->xyz[2] = _vehicle_thrust_setpoint_virtual_mc->xyz[2];
+		_io->out.torque_0.xyz[0] = _io->in.mc_torque.xyz[0];
+		_io->out.torque_0.xyz[1] = _io->in.mc_torque.xyz[1];
+		_io->out.torque_0.xyz[2] = _io->in.mc_torque.xyz[2];
+		_io->out.thrust_0.xyz[2] = _io->in.mc_thrust.xyz[2];
 
 		// FW actuators:
 		if (!_param_vt_elev_mc_lock.get()) {
-			_torque_setpoint_1->xyz[0] = _vehicle_torque_setpoint_virtual_fw->xyz[0];
-			_torque_setpoint_1->xyz[1] = _vehicle_torque_setpoint_virtual_fw->xyz[1];
+			_io->out.torque_1.xyz[0] = _io->in.fw_torque.xyz[0];
+			_io->out.torque_1.xyz[1] = _io->in.fw_torque.xyz[1];
 		}
 
-		_thrust_setpoint_0->xyz[0] = _pusher_throttle;
+		_io->out.thrust_0.xyz[0] = _pusher_throttle;
 		break;
 
 	case vtol_mode::TRANSITION_TO_FW:
@@ -313,26 +361,26 @@ void Standard::fill_actuator_outputs()
 	// FALLTHROUGH
 	case vtol_mode::TRANSITION_TO_MC:
 		// MC actuators:
-		_torque_setpoint_0->xyz[0] = _vehicle_torque_setpoint_virtual_mc->xyz[0] * _mc_roll_weight;
-		_torque_setpoint_0->xyz[1] = _vehicle_torque_setpoint_virtual_mc->xyz[1] * _mc_pitch_weight;
-		_torque_setpoint_0->xyz[2] = _vehicle_torque_setpoint_virtual_mc->xyz[2] * _mc_yaw_weight;
-		_thrust_setpoint_0->xyz[2] = _vehicle_thrust_setpoint_virtual_mc->xyz[2] * _mc_throttle_weight;
+		_io->out.torque_0.xyz[0] = _io->in.mc_torque.xyz[0] * _mc_roll_weight;
+		_io->out.torque_0.xyz[1] = _io->in.mc_torque.xyz[1] * _mc_pitch_weight;
+		_io->out.torque_0.xyz[2] = _io->in.mc_torque.xyz[2] * _mc_yaw_weight;
+		_io->out.thrust_0.xyz[2] = _io->in.mc_thrust.xyz[2] * _mc_throttle_weight;
 
 		// FW actuators
-		_torque_setpoint_1->xyz[0] = _vehicle_torque_setpoint_virtual_fw->xyz[0];
-		_torque_setpoint_1->xyz[1] = _vehicle_torque_setpoint_virtual_fw->xyz[1];
-		_torque_setpoint_1->xyz[2] = _vehicle_torque_setpoint_virtual_fw->xyz[2];
-		_thrust_setpoint_0->xyz[0] = _pusher_throttle;
+		_io->out.torque_1.xyz[0] = _io->in.fw_torque.xyz[0];
+		_io->out.torque_1.xyz[1] = _io->in.fw_torque.xyz[1];
+		_io->out.torque_1.xyz[2] = _io->in.fw_torque.xyz[2];
+		_io->out.thrust_0.xyz[0] = _pusher_throttle;
 
 		break;
 
 	case vtol_mode::FW_MODE:
 
 		// FW actuators
-		_torque_setpoint_1->xyz[0] = _vehicle_torque_setpoint_virtual_fw->xyz[0];
-		_torque_setpoint_1->xyz[1] = _vehicle_torque_setpoint_virtual_fw->xyz[1];
-		_torque_setpoint_1->xyz[2] = _vehicle_torque_setpoint_virtual_fw->xyz[2];
-		_thrust_setpoint_0->xyz[0] = _vehicle_thrust_setpoint_virtual_fw->xyz[0];
+		_io->out.torque_1.xyz[0] = _io->in.fw_torque.xyz[0];
+		_io->out.torque_1.xyz[1] = _io->in.fw_torque.xyz[1];
+		_io->out.torque_1.xyz[2] = _io->in.fw_torque.xyz[2];
+		_io->out.thrust_0.xyz[0] = _io->in.fw_thrust.xyz[0];
 		break;
 	}
 }
@@ -349,3 +397,5 @@ void Standard::blendThrottleAfterFrontTransition(float scale)
 	const float tecs_throttle = _v_att_sp->thrust_body[0];
 	_v_att_sp->thrust_body[0] = scale * tecs_throttle + (1.0f - scale) * _pusher_throttle;
 }
+
+#endif // VTOL_ATT_CONTROL_HAS_STANDARD
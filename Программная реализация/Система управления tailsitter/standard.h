@@ -2,7 +2,7 @@
 #define STANDARD_H
 #include "vtol_type.h"
 
-class Standard : public VtolType
+class Standard final : public VtolType
 {
 
 public:
@@ -10,13 +10,17 @@ public:
 	Standard(VtolAttitudeControl *_att_controller);
 	~Standard() override = default;
 
-	void update_vtol_state() override;
-	void update_transition_state() override;
-	void update_fw_state() override;
-	void update_mc_state() override;
-	void fill_actuator_outputs() override;
+	void update_vtol_state(const VtolControlCycle &cycle) override;
+	void update_transition_state(const VtolControlCycle &cycle) override;
+	void update_fw_state(const VtolControlCycle &cycle) override;
+	void update_mc_state(const VtolControlCycle &cycle) override;
+	void fill_actuator_outputs(const VtolControlCycle &cycle) override;
 	void waiting_on_tecs() override;
 	void blendThrottleAfterFrontTransition(float scale) override;
+	const char *get_vtol_mode_name() const override;
+	bool uses_torque_setpoint_1() const override { return !(_param_vt_elev_mc_lock.get() && _vtol_mode == vtol_mode::MC_MODE); }
+	void parameters_update() override;
+	uint16_t get_input_set(mode vtol_mode) const override;
 
 private:
 
@@ -30,10 +34,15 @@ private:
 	vtol_mode _vtol_mode{vtol_mode::MC_MODE};			/**< vtol flight mode, defined by enum vtol_mode */
 
 	float _pusher_throttle{0.0f};
-	float _airspeed_trans_blend_margin{0.0f};
 	hrt_abstime _last_time_pusher_transition_update{0};
 
-	void parameters_update() override;
+	// MC weight profiles over calibrated airspeed or the time since the transition start
+	TransitionSchedule _front_weight_airspeed_schedule;
+	TransitionSchedule _front_weight_time_schedule;		// without airspeed
+	TransitionSchedule _back_weight_schedule;
+
+	void update_transition_schedules() override;
+
 
 	DEFINE_PARAMETERS_CUSTOM_PARENT(VtolType,
 					(ParamFloat<px4::params::VT_PSHER_SLEW>) _param_vt_psher_slew,
@@ -2,11 +2,16 @@
 
 
 
+#include "vtol_type_config.h"
+
+#if VTOL_ATT_CONTROL_HAS_TAILSITTER
+
 #include "tailsitter.h"
 #include "vtol_att_control_main.h"
 
 using namespace matrix;
 
+
 /**
  * @class Tailsitter
  * @brief Class for controlling the tailsitter VTOL type.
@@ -31,7 +36,46 @@ void
 Tailsitter::parameters_update()
 {
 	VtolType::updateParams();
+}
+
+/**
+ * @brief Rebuild the transition schedules.
+ *
+ * The setpoint rotates by 90 degrees over VT_F_TRANS_DUR and VT_B_TRANS_DUR (at least 0.1s) and keeps
+ * rotating at the final rate until the tilt limit is reached (90 degrees - FW_PSP_OFF for the front transition).
+ */
+
+void Tailsitter::update_transition_schedules()
+{
+	VtolType::update_transition_schedules();
+
+	_front_trans_angle_schedule.build(0.f, math::max(_param_vt_f_trans_dur.get(), 0.1f), 0.f, M_PI_2_F,
+					  _param_vt_shape_pitch.get(), true);
+	_back_trans_angle_schedule.build(0.f, math::max(_param_vt_b_trans_dur.get(), 0.1f), 0.f, M_PI_2_F,
+					 _param_vt_shape_pitch.get(), true);
+	_back_trans_thrust_schedule.build(0.f, B_TRANS_THRUST_BLENDING_DURATION, 0.f, 1.f, _param_vt_shape_thr.get());
+
+	// tilt < 90° - FW_PSP_OFF  <=>  cos(tilt) > sin(FW_PSP_OFF)
+	_cos_front_trans_tilt_max = sinf(math::radians(_param_fw_psp_off.get()));
+}
+
+/**
+ * @brief Returns the name of the current tailsitter flight mode.
+ */
+
+const char *Tailsitter::get_vtol_mode_name() const
+{
+	switch (_vtol_mode) {
+	case vtol_mode::MC_MODE: return "MC";
+
+	case vtol_mode::TRANSITION_FRONT_P1: return "TRANSITION_FRONT_P1";
+
+	case vtol_mode::TRANSITION_BACK: return "TRANSITION_BACK";
 
+	case vtol_mode::FW_MODE: return "FW";
+	}
+
+	return "unknown";
 }
 
 /**
@@ -41,7 +85,7 @@ Tailsitter::parameters_update()
  * or transitioning between the two, based on user input or system state.
  */
 
-void Tailsitter::update_vtol_state()
+void Tailsitter::update_vtol_state(const VtolControlCycle &cycle)
 {
 	/* simple logic using a two way switch to perform transitions.
 	 * after flipping the switch the vehicle will start tilting in MC control mode, picking up
@@ -53,7 +97,7 @@ void Tailsitter::update_vtol_state()
 	if (_vtol_vehicle_status->fixed_wing_system_failure) {
 		// Failsafe event, switch to MC mode immediately
 		if (_vtol_mode != vtol_mode::MC_MODE) {
-			_transition_start_timestamp = hrt_absolute_time();
+			_transition_start_timestamp = cycle.now;
 		}
 
 		_vtol_mode = vtol_mode::MC_MODE;
@@ -65,7 +109,7 @@ void Tailsitter::update_vtol_state()
 			break;
 
 		case vtol_mode::FW_MODE:
-			resetTransitionStates();
+			resetTransitionStates(cycle);
 			_vtol_mode = vtol_mode::TRANSITION_BACK;
 			break;
 
@@ -75,7 +119,7 @@ void Tailsitter::update_vtol_state()
 			break;
 
 		case vtol_mode::TRANSITION_BACK:
-			const float pitch = Eulerf(Quatf(_v_att->q)).theta();
+			const float pitch = _attitude.euler().theta();
 
 			// check if we have reached pitch angle to switch to MC mode
 			if (pitch >= PITCH_THRESHOLD_AUTO_TRANSITION_TO_MC || _time_since_trans_start > _param_vt_b_trans_dur.get()) {
@@ -91,7 +135,7 @@ void Tailsitter::update_vtol_state()
 		case vtol_mode::MC_MODE:
 			// initialise a front transition
 			_vtol_mode = vtol_mode::TRANSITION_FRONT_P1;
-			resetTransitionStates();
+			resetTransitionStates(cycle);
 			break;
 
 		case vtol_mode::FW_MODE:
@@ -101,7 +145,7 @@ void Tailsitter::update_vtol_state()
 
 				if (isFrontTransitionCompleted()) {
 					_vtol_mode = vtol_mode::FW_MODE;
-					_trans_finished_ts = hrt_absolute_time();
+					_trans_finished_ts = cycle.now;
 				}
 
 				break;
@@ -110,7 +154,7 @@ void Tailsitter::update_vtol_state()
 		case vtol_mode::TRANSITION_BACK:
 			// failsafe into fixed wing mode
 			_vtol_mode = vtol_mode::FW_MODE;
-			_trans_finished_ts = hrt_absolute_time();
+			_trans_finished_ts = cycle.now;
 			break;
 		}
 	}
@@ -144,11 +188,11 @@ void Tailsitter::update_vtol_state()
  * and fixed-wing modes, including setting attitude and thrust setpoints.
  */
 
-void Tailsitter::update_transition_state()
+void Tailsitter::update_transition_state(const VtolControlCycle &cycle)
 {
-	VtolType::update_transition_state();
+	VtolType::update_transition_state(cycle);
 
-	const hrt_abstime now = hrt_absolute_time();
+	const hrt_abstime now = cycle.now;
 
 	// we need the incoming (virtual) mc attitude setpoints to be recent, otherwise return (means the previous setpoint stays active)
 	if (_mc_virtual_att_sp->timestamp < (now - 1_s)) {
@@ -158,11 +202,13 @@ void Tailsitter::update_transition_state()
 	if (!_flag_was_in_trans_mode) {
 		_flag_was_in_trans_mode = true;
 
+		Quatf q_trans_start;
+		Vector3f trans_rot_axis;
+
 		if (_vtol_mode == vtol_mode::TRANSITION_BACK) {
 			// calculate rotation axis for transition.
-			_q_trans_start = Quatf(_v_att->q);
-			Vector3f z = -_q_trans_start.dcm_z();
-			_trans_rot_axis = z.cross(Vector3f(0.f, 0.f, -1.f));
+			Vector3f z = -_attitude.body_z();
+			trans_rot_axis = z.cross(Vector3f(0.f, 0.f, -1.f));
 
 			// as heading setpoint we choose the heading given by the direction the vehicle points
 			const float yaw_sp = atan2f(z(1), z(0));
@@ -172,67 +218,54 @@ void Tailsitter::update_transition_state()
 			// If for some reason the fw attitude setpoint is not recent then don't use it and assume 0 pitch
 			if (_fw_virtual_att_sp->timestamp > (now - 1_s)) {
 				const float pitch_body = Eulerf(Quatf(_fw_virtual_att_sp->q_d)).theta();
-				_q_trans_start = Eulerf(0.f, pitch_body, yaw_sp);
+				q_trans_start = Eulerf(0.f, pitch_body, yaw_sp);
 
 			} else {
-				_q_trans_start = Eulerf(0.f, 0.f, yaw_sp);
+				q_trans_start = Eulerf(0.f, 0.f, yaw_sp);
 			}
 
 			// attitude during transitions are controlled by mc attitude control so rotate the desired attitude to the
 			// multirotor frame
-			_q_trans_start = _q_trans_start * Quatf(Eulerf(0, -M_PI_2_F, 0));
+			q_trans_start = q_trans_start * Quatf(Eulerf(0, -M_PI_2_F, 0));
 
 		} else if (_vtol_mode == vtol_mode::TRANSITION_FRONT_P1) {
 			// initial attitude setpoint for the transition should be with wings level
 			const Eulerf setpoint_euler(Quatf(_mc_virtual_att_sp->q_d));
-			_q_trans_start = Eulerf(0.f, setpoint_euler.theta(), setpoint_euler.psi());
-			Vector3f x = Dcmf(Quatf(_v_att->q)) * Vector3f(1.f, 0.f, 0.f);
-			_trans_rot_axis = -x.cross(Vector3f(0.f, 0.f, -1.f));
+			q_trans_start = Eulerf(0.f, setpoint_euler.theta(), setpoint_euler.psi());
+			Vector3f x = _attitude.dcm().col(0);
+			trans_rot_axis = -x.cross(Vector3f(0.f, 0.f, -1.f));
 		}
 
-		_q_trans_sp = _q_trans_start;
+		_trans_rotation.start(q_trans_start, trans_rot_axis);
 	}
 
-	// ensure input quaternions are exactly normalized because acosf(1.00001) == NaN
-	_q_trans_sp.normalize();
-
-	// tilt angle (zero if vehicle nose points up (hover))
-	const float cos_tilt = math::constrain(_q_trans_sp(0) * _q_trans_sp(0) - _q_trans_sp(1) * _q_trans_sp(1) -
-					       _q_trans_sp(2) * _q_trans_sp(2) + _q_trans_sp(3) * _q_trans_sp(3), -1.f, 1.f);
-	const float tilt = acosf(cos_tilt);
+	// cosine of the tilt angle (tilt is zero if vehicle nose points up (hover)), the setpoint is kept normalized
+	const Quatf &q_trans_sp = _trans_rotation.setpoint();
+	const float cos_tilt = q_trans_sp(0) * q_trans_sp(0) - q_trans_sp(1) * q_trans_sp(1) -
+			       q_trans_sp(2) * q_trans_sp(2) + q_trans_sp(3) * q_trans_sp(3);
 
 	if (_vtol_mode == vtol_mode::TRANSITION_FRONT_P1) {
 
-		// calculate pitching rate - and constrain to at least 0.1s transition time
-		const float trans_pitch_rate = M_PI_2_F / math::max(_param_vt_f_trans_dur.get(), 0.1f);
-
-		if (tilt < M_PI_2_F - math::radians(_param_fw_psp_off.get())) {
-			_q_trans_sp = Quatf(AxisAnglef(_trans_rot_axis,
-						       _time_since_trans_start * trans_pitch_rate)) * _q_trans_start;
+		if (cos_tilt > _cos_front_trans_tilt_max) {
+			_trans_rotation.rotate_to(_front_trans_angle_schedule.evaluate(_time_since_trans_start));
 		}
 
 	} else if (_vtol_mode == vtol_mode::TRANSITION_BACK) {
 
-		// calculate pitching rate - and constrain to at least 0.1s transition time
-		const float trans_pitch_rate = M_PI_2_F / math::max(_param_vt_b_trans_dur.get(), 0.1f);
-
-		if (tilt > 0.01f) {
-			_q_trans_sp = Quatf(AxisAnglef(_trans_rot_axis,
-						       _time_since_trans_start * trans_pitch_rate)) * _q_trans_start;
+		if (cos_tilt < COS_TILT_BACK_TRANSITION_END) {
+			_trans_rotation.rotate_to(_back_trans_angle_schedule.evaluate(_time_since_trans_start));
 		}
 	}
 
 	_v_att_sp->thrust_body[2] = _mc_virtual_att_sp->thrust_body[2];
 
 	if (_vtol_mode == vtol_mode::TRANSITION_BACK) {
-		const float progress = math::constrain(_time_since_trans_start / B_TRANS_THRUST_BLENDING_DURATION, 0.f, 1.f);
-		blendThrottleBeginningBackTransition(progress);
+		blendThrottleBeginningBackTransition(_back_trans_thrust_schedule.evaluate(_time_since_trans_start));
 	}
 
-	_v_att_sp->timestamp = hrt_absolute_time();
+	_v_att_sp->timestamp = now;
 
-	const Eulerf euler_sp(_q_trans_sp);
-	_q_trans_sp.copyTo(_v_att_sp->q_d);
+	_trans_rotation.setpoint().copyTo(_v_att_sp->q_d);
 }
 
 /**
@@ -253,9 +286,9 @@ void Tailsitter::waiting_on_tecs()
  * This function is called when the vehicle is in fixed-wing mode to handle fixed-wing specific control.
  */
 
-void Tailsitter::update_fw_state()
+void Tailsitter::update_fw_state(const VtolControlCycle &cycle)
 {
-	VtolType::update_fw_state();
+	VtolType::update_fw_state(cycle);
 
 }
 
@@ -264,78 +297,74 @@ void Tailsitter::update_fw_state()
  *
  * This function writes the calculated torque and thrust setpoints to the actuator output topics, depending on the current mode.
  */
-void Tailsitter::fill_actuator_outputs()
+void Tailsitter::fill_actuator_outputs(const VtolControlCycle &cycle)
 {
-	_torque_setpoint_0->timestamp = hrt_absolute_time();
-	_torque_setpoint_0->timestamp_sample = _vehicle_torque_setpoint_virtual_mc->timestamp_sample;
-	_torque_setpoint_0->xyz[0] = 0.f;
-	_torque_setpoint_0->xyz[1] = 0.f;
-	_torque_setpoint_0->xyz[2] = 0.f;
-
-	_torque_setpoint_1->timestamp = hrt_absolute_time();
-	_torque_setpoint_1->timestamp_sample = _vehicle_torque_setpoint_virtual_fw->timestamp_sample;
-	_torque_setpoint_1->xyz[0] = 0.f;
-	_torque_setpoint_1->xyz[1] = 0.f;
-	_torque_setpoint_1->xyz[2] = 0.f;
-
-	_thrust_setpoint_0->timestamp = hrt_absolute_time();
-	_thrust_setpoint_0->timestamp_sample = _vehicle_thrust_setpoint_virtual_mc->timestamp_sample;
-	_thrust_setpoint_0->xyz[0] = 0.f;
-	_thrust_setpoint_0->xyz[1] = 0.f;
-	_thrust_setpoint_0->xyz[2] = 0.f;
-
-	_thrust_setpoint_1->timestamp = hrt_absolute_time();
-	_thrust_setpoint_1->timestamp_sample = _vehicle_thrust_setpoint_virtual_fw->timestamp_sample;
-	_thrust_setpoint_1->xyz[0] = 0.f;
-	_thrust_setpoint_1->xyz[1] = 0.f;
-	_thrust_setpoint_1->xyz[2] = 0.f;
+	_io->out.torque_0.timestamp_sample = _io->in.mc_torque.timestamp_sample;
+	_io->out.torque_0.xyz[0] = 0.f;
+	_io->out.torque_0.xyz[1] = 0.f;
+	_io->out.torque_0.xyz[2] = 0.f;
+
+	_io->out.torque_1.timestamp_sample = _io->in.fw_torque.timestamp_sample;
+	_io->out.torque_1.xyz[0] = 0.f;
+	_io->out.torque_1.xyz[1] = 0.f;
+	_io->out.torque_1.xyz[2] = 0.f;
+
+	_io->out.thrust_0.timestamp_sample = _io->in.mc_thrust.timestamp_sample;
+	_io->out.thrust_0.xyz[0] = 0.f;
+	_io->out.thrust_0.xyz[1] = 0.f;
+	_io->out.thrust_0.xyz[2] = 0.f;
+
+	_io->out.thrust_1.timestamp_sample = _io->in.fw_thrust.timestamp_sample;
+	_io->out.thrust_1.xyz[0] = 0.f;
+	_io->out.thrust_1.xyz[1] = 0.f;
+	_io->out.thrust_1.xyz[2] = 0.f;
 
 	// Motors
 	if (_vtol_mode == vtol_mode::FW_MODE) {
 
-		_thrust_setpoint_0->xyz[2] = -_vehicle_thrust_setpoint_virtual_fw->xyz[0];
+		_io->out.thrust_0.xyz[2] = -_io->in.fw_thrust.xyz[0];
 
 		/* allow differential thrust if enabled */
 		if (_param_vt_fw_difthr_en.get() & static_cast<int32_t>(VtFwDifthrEnBits::YAW_BIT)) {
-			_torque_setpoint_0->xyz[0] = _vehicle_torque_setpoint_virtual_fw->xyz[0] * _param_vt_fw_difthr_s_y.get();
+			_io->out.torque_0.xyz[0] = _io->in.fw_torque.xyz[0] * _param_vt_fw_difthr_s_y.get();
 		}
 
 		if (_param_vt_fw_difthr_en.get() & static_cast<int32_t>(VtFwDifthrEnBits::PITCH_BIT)) {
-			_torque_setpoint_0->xyz[1] = _vehicle_torque_setpoint_virtual_fw->xyz[1] * _param_vt_fw_difthr_s_p.get();
+			_io->out.torque_0.xyz[1] = _io->in.fw_torque.xyz[1] * _param_vt_fw_difthr_s_p.get();
 		}
 
 		if (_param_vt_fw_difthr_en.get() & static_cast<int32_t>(VtFwDifthrEnBits::ROLL_BIT)) {
-			_torque_setpoint_0->xyz[2] = _vehicle_torque_setpoint_virtual_fw->xyz[2] * _param_vt_fw_difthr_s_r.get();
+			_io->out.torque_0.xyz[2] = _io->in.fw_torque.xyz[2] * _param_vt_fw_difthr_s_r.get();
 		}
 
 		// for the short period after switching to FW where there is no thrust published yet from the FW controller,
 		// keep publishing the last MC thrust to keep the motors running
-		if (hrt_elapsed_time(&_trans_finished_ts) < 50_ms) {
-			_thrust_setpoint_0->xyz[2] = _last_thr_in_mc;
-			_torque_setpoint_0->xyz[0] = 0.f;
-			_torque_setpoint_0->xyz[1] = 0.f;
-			_torque_setpoint_0->xyz[2] = 0.f;
+		if (cycle.now - _trans_finished_ts < 50_ms) {
+			_io->out.thrust_0.xyz[2] = _last_thr_in_mc;
+			_io->out.torque_0.xyz[0] = 0.f;
+			_io->out.torque_0.xyz[1] = 0.f;
+			_io->out.torque_0.xyz[2] = 0.f;
 		}
 
 	} else {
-		_thrust_setpoint_0->xyz[2] = _vehicle_thrust_setpoint_virtual_mc->xyz[2];
+		_io->out.thrust_0.xyz[2] = _io->in.mc_thrust.xyz[2];
 
 		// for the short period after starting the backtransition where there is no thrust published yet from the MC controller,
 		// keep publishing the last FW thrust to keep the motors running
-		if (_vtol_mode != vtol_mode::TRANSITION_FRONT_P1 && hrt_elapsed_time(&_transition_start_timestamp) < 50_ms) {
-			_thrust_setpoint_0->xyz[2] = -_last_thr_in_fw_mode;
+		if (_vtol_mode != vtol_mode::TRANSITION_FRONT_P1 && cycle.now - _transition_start_timestamp < 50_ms) {
+			_io->out.thrust_0.xyz[2] = -_last_thr_in_fw_mode;
 		}
 
-		_torque_setpoint_0->xyz[0] = _vehicle_torque_setpoint_virtual_mc->xyz[0];
-		_torque_setpoint_0->xyz[1] = _vehicle_torque_setpoint_virtual_mc->xyz[1];
-		_torque_setpoint_0->xyz[2] = _vehicle_torque_setpoint_virtual_mc->xyz[2];
+		_io->out.torque_0.xyz[0] = _io->in.mc_torque.xyz[0];
+		_io->out.torque_0.xyz[1] = _io->in.mc_torque.xyz[1];
+		_io->out.torque_0.xyz[2] = _io->in.mc_torque.xyz[2];
 	}
 
 	// Control surfaces
 	if (!_param_vt_elev_mc_lock.get() || _vtol_mode != vtol_mode::MC_MODE) {
-		_torque_setpoint_1->xyz[0] = _vehicle_torque_setpoint_virtual_fw->xyz[0];
-		_torque_setpoint_1->xyz[1] = _vehicle_torque_setpoint_virtual_fw->xyz[1];
-		_torque_setpoint_1->xyz[2] = _vehicle_torque_setpoint_virtual_fw->xyz[2];
+		_io->out.torque_1.xyz[0] = _io->in.fw_torque.xyz[0];
+		_io->out.torque_1.xyz[1] = _io->in.fw_torque.xyz[1];
+		_io->out.torque_1.xyz[2] = _io->in.fw_torque.xyz[2];
 	}
 }
 
@@ -349,15 +378,15 @@ void Tailsitter::fill_actuator_outputs()
 
 bool Tailsitter::isFrontTransitionCompletedBase()
 {
-	const bool airspeed_triggers_transition = PX4_ISFINITE(_airspeed_validated->calibrated_airspeed_m_s)
+	const bool airspeed_triggers_transition = PX4_ISFINITE(_io->in.calibrated_airspeed)
 			&& _param_fw_use_airspd.get();
 
 	bool transition_to_fw = false;
-	const float pitch = Eulerf(Quatf(_v_att->q)).theta();
+	const float pitch = _attitude.euler().theta();
 
 	if (pitch <= PITCH_THRESHOLD_AUTO_TRANSITION_TO_FW) {
 		if (airspeed_triggers_transition) {
-			transition_to_fw = _airspeed_validated->calibrated_airspeed_m_s >= _param_vt_arsp_trans.get() ;
+			transition_to_fw = _io->in.calibrated_airspeed >= _param_vt_arsp_trans.get() ;
 
 		} else {
 			transition_to_fw = true;
@@ -377,3 +406,5 @@ void Tailsitter::blendThrottleBeginningBackTransition(float scale)
 {
 	_v_att_sp->thrust_body[2] = scale * _v_att_sp->thrust_body[2] + (1.f - scale) * (-_last_thr_in_fw_mode);
 }
+
+#endif // VTOL_ATT_CONTROL_HAS_TAILSITTER
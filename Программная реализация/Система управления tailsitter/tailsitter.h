@@ -3,6 +3,7 @@
 #ifndef TAILSITTER_H
 #define TAILSITTER_H
 
+#include "vtol_transition_rotation.h"
 #include "vtol_type.h"
 
 #include <parameters/param.h>
@@ -18,19 +19,25 @@ static constexpr float PITCH_THRESHOLD_AUTO_TRANSITION_TO_MC = -0.26f; // -15°
 // [s] Thrust blending duration from fixed-wing to back transition throttle
 static constexpr float B_TRANS_THRUST_BLENDING_DURATION = 0.5f;
 
-class Tailsitter : public VtolType
+// cosine of the tilt (0.01 rad) below which the back transition setpoint stops rotating
+static constexpr float COS_TILT_BACK_TRANSITION_END = 0.99995f;
+
+class Tailsitter final : public VtolType
 {
 
 public:
 	Tailsitter(VtolAttitudeControl *_att_controller);
 	~Tailsitter() override = default;
 
-	void update_vtol_state() override;
-	void update_transition_state() override;
-	void update_fw_state() override;
-	void fill_actuator_outputs() override;
+	void update_vtol_state(const VtolControlCycle &cycle) override;
+	void update_transition_state(const VtolControlCycle &cycle) override;
+	void update_fw_state(const VtolControlCycle &cycle) override;
+	void fill_actuator_outputs(const VtolControlCycle &cycle) override;
 	void waiting_on_tecs() override;
 	void blendThrottleAfterFrontTransition(float scale) override;
+	const char *get_vtol_mode_name() const override;
+	bool uses_torque_setpoint_1() const override { return !(_param_vt_elev_mc_lock.get() && _vtol_mode == vtol_mode::MC_MODE); }
+	void parameters_update() override;
 	void blendThrottleBeginningBackTransition(float scale);
 
 private:
@@ -45,16 +52,22 @@ private:
 
 	bool _flag_was_in_trans_mode = false;	// true if mode has just switched to transition
 
-	matrix::Quatf _q_trans_start;
-	matrix::Quatf _q_trans_sp;
-	matrix::Vector3f _trans_rot_axis;
+	TransitionRotation _trans_rotation;	// transition attitude setpoint
 
-	void parameters_update() override;
+	float _cos_front_trans_tilt_max{0.f};	// cosine of the tilt where the front transition setpoint stops rotating
+
+	// rotation angle of the transition setpoint over the time since the transition start [rad]
+	TransitionSchedule _front_trans_angle_schedule;
+	TransitionSchedule _back_trans_angle_schedule;
+	TransitionSchedule _back_trans_thrust_schedule;	// thrust blend scale at the beginning of the back transition
 
 	bool isFrontTransitionCompletedBase() override;
 
+	void update_transition_schedules() override;
+
 	DEFINE_PARAMETERS_CUSTOM_PARENT(VtolType,
-					(ParamFloat<px4::params::FW_PSP_OFF>) _param_fw_psp_off
+					(ParamFloat<px4::params::FW_PSP_OFF>) _param_fw_psp_off,
+					(ParamFloat<px4::params::VT_SHAPE_PITCH>) _param_vt_shape_pitch
 				       )
 
 
@@ -6,11 +6,16 @@ This file contains the control logic for a tiltrotor VTOL aircraft, which transi
 mode and fixed-wing mode by tilting its rotors. The transitions are controlled by various parameters
 and conditions such as speed, time, and tilt angle. */
 
+#include "vtol_type_config.h"
+
+#if VTOL_ATT_CONTROL_HAS_TILTROTOR
+
 #include "tiltrotor.h"
 #include "vtol_att_control_main.h"
 
 using namespace matrix;
 
+
 #define FRONTTRANS_THR_MIN 0.25f
 #define BACKTRANS_THROTTLE_DOWNRAMP_DUR_S 0.5f
 #define BACKTRANS_THROTTLE_UPRAMP_DUR_S 0.5f
@@ -37,6 +42,64 @@ Tiltrotor::parameters_update()
 	VtolType::updateParams();
 }
 
+/**
+ * @brief Rebuild the transition schedules.
+ *
+ * Tilt ramps from VT_TILT_MC to VT_TILT_TRANS over VT_F_TRANS_DUR, on to VT_TILT_FW over VT_TRANS_P2_DUR
+ * and back to VT_TILT_MC over VT_BT_TILT_DUR (at least 0.1s) once the throttle is down. The MC roll
+ * weight decreases from the blending to the transition airspeed, or without airspeed from the minimum
+ * to the open-loop transition time.
+ */
+
+void Tiltrotor::update_transition_schedules()
+{
+	VtolType::update_transition_schedules();
+
+	const float tilt_mc = _param_vt_tilt_mc.get();
+	const float tilt_trans = _param_vt_tilt_trans.get();
+	const float tilt_fw = _param_vt_tilt_fw.get();
+	const float shape_tilt = _param_vt_shape_tilt.get();
+
+	// P1 ends on VT_TILT_TRANS exactly (tilt_mc + (tilt_trans - tilt_mc) can round below it and the transition
+	// would never complete) and keeps tilting beyond it until the transition moves on to P2
+	const float tilt_p1_end = tilt_mc <= tilt_trans ? tilt_trans : 2.f * tilt_mc - tilt_trans;
+	_front_p1_tilt_schedule.build(0.f, _param_vt_f_trans_dur.get(), tilt_mc, tilt_p1_end, shape_tilt, true);
+	_front_p2_tilt_schedule.build(0.f, _param_vt_trans_p2_dur.get(), tilt_trans, tilt_trans + fabsf(tilt_fw - tilt_trans),
+				      shape_tilt);
+	_back_tilt_schedule.build(BACKTRANS_THROTTLE_DOWNRAMP_DUR_S,
+				  BACKTRANS_THROTTLE_DOWNRAMP_DUR_S + math::max(_param_vt_bt_tilt_dur.get(), 0.1f), tilt_fw, tilt_mc, shape_tilt);
+
+	_back_throttle_down_schedule.build(0.f, BACKTRANS_THROTTLE_DOWNRAMP_DUR_S, 0.f, 1.f, _param_vt_shape_thr.get());
+	_back_throttle_up_schedule.build(timeUntilMotorsAreUp(), timeUntilMotorsAreUp() + BACKTRANS_THROTTLE_UPRAMP_DUR_S,
+					 0.f, 1.f, _param_vt_shape_thr.get());
+
+	_roll_weight_airspeed_schedule.build(getBlendAirspeed(), getTransitionAirspeed(), 1.f, 0.f,
+					     _param_vt_shape_weight.get());
+	_roll_weight_time_schedule.build(getMinimumFrontTransitionTime(), getOpenLoopFrontTransitionTime(), 1.f, 0.f,
+					 _param_vt_shape_weight.get());
+}
+
+/**
+ * @brief Returns the name of the current tiltrotor flight mode.
+ */
+
+const char *Tiltrotor::get_vtol_mode_name() const
+{
+	switch (_vtol_mode) {
+	case vtol_mode::MC_MODE: return "MC";
+
+	case vtol_mode::TRANSITION_FRONT_P1: return "TRANSITION_FRONT_P1";
+
+	case vtol_mode::TRANSITION_FRONT_P2: return "TRANSITION_FRONT_P2";
+
+	case vtol_mode::TRANSITION_BACK: return "TRANSITION_BACK";
+
+	case vtol_mode::FW_MODE: return "FW";
+	}
+
+	return "unknown";
+}
+
 /**
 
 @brief Updates the VTOL state.
@@ -47,7 +110,7 @@ based on conditions such as user input, speed, and tilt angles. It also handles
 
 failsafe events that force immediate transitions. */
 
-void Tiltrotor::update_vtol_state()
+void Tiltrotor::update_vtol_state(const VtolControlCycle &cycle)
 {
 	/* simple logic using a two way switch to perform transitions.
 	 * after flipping the switch the vehicle will start tilting rotors, picking up
@@ -67,7 +130,7 @@ void Tiltrotor::update_vtol_state()
 			break;
 
 		case vtol_mode::FW_MODE:
-			resetTransitionStates();
+			resetTransitionStates(cycle);
 			_vtol_mode = vtol_mode::TRANSITION_BACK;
 			break;
 
@@ -87,13 +150,11 @@ void Tiltrotor::update_vtol_state()
 			// speed exit condition: use ground if valid, otherwise airspeed
 			bool exit_backtransition_speed_condition = false;
 
-			if (_local_pos->v_xy_valid) {
-				const Dcmf R_to_body(Quatf(_v_att->q).inversed());
-				const Vector3f vel = R_to_body * Vector3f(_local_pos->vx, _local_pos->vy, _local_pos->vz);
-				exit_backtransition_speed_condition = vel(0) < _param_mpc_xy_cruise.get() ;
+			if (_io->in.v_xy_valid) {
+				exit_backtransition_speed_condition = _attitude.velocity_body()(0) < _param_mpc_xy_cruise.get() ;
 
-			} else if (PX4_ISFINITE(_airspeed_validated->calibrated_airspeed_m_s)) {
-				exit_backtransition_speed_condition = _airspeed_validated->calibrated_airspeed_m_s < _param_mpc_xy_cruise.get() ;
+			} else if (PX4_ISFINITE(_io->in.calibrated_airspeed)) {
+				exit_backtransition_speed_condition = _io->in.calibrated_airspeed < _param_mpc_xy_cruise.get() ;
 			}
 
 			const bool exit_backtransition_time_condition = _time_since_trans_start > _param_vt_b_trans_dur.get() ;
@@ -110,7 +171,7 @@ void Tiltrotor::update_vtol_state()
 		switch (_vtol_mode) {
 		case vtol_mode::MC_MODE:
 			// initialise a front transition
-			resetTransitionStates();
+			resetTransitionStates(cycle);
 			_vtol_mode = vtol_mode::TRANSITION_FRONT_P1;
 			break;
 
@@ -120,8 +181,8 @@ void Tiltrotor::update_vtol_state()
 		case vtol_mode::TRANSITION_FRONT_P1: {
 				if (isFrontTransitionCompleted()) {
 					_vtol_mode = vtol_mode::TRANSITION_FRONT_P2;
-					_trans_finished_ts = hrt_absolute_time();
-					resetTransitionStates();
+					_trans_finished_ts = cycle.now;
+					resetTransitionStates(cycle);
 				}
 
 				break;
@@ -167,13 +228,28 @@ void Tiltrotor::update_vtol_state()
 
 /**
 
+@brief Inputs of the tiltrotor, pusher assist (motor tilt) in hover needs the attitude and the position setpoint. */
+
+uint16_t Tiltrotor::get_input_set(mode vtol_mode) const
+{
+	uint16_t inputs = VtolType::get_input_set(vtol_mode);
+
+	if (vtol_mode == mode::ROTARY_WING) {
+		inputs |= INPUT_ATTITUDE | INPUT_POSITION_SETPOINT_TRIPLET;
+	}
+
+	return inputs;
+}
+
+/**
+
 @brief Updates the multicopter state.
 
 Adjusts the control values specific to multicopter mode, such as yaw control and tilt angle. */
 
-void Tiltrotor::update_mc_state()
+void Tiltrotor::update_mc_state(const VtolControlCycle &cycle)
 {
-	VtolType::update_mc_state();
+	VtolType::update_mc_state(cycle);
 
 	_tilt_control = VtolType::pusher_assist() + _param_vt_tilt_mc.get();
 	_mc_yaw_weight = 1.0f;
@@ -185,9 +261,9 @@ void Tiltrotor::update_mc_state()
 
 Adjusts the control values specific to fixed-wing mode, such as throttle and tilt angle. */
 
-void Tiltrotor::update_fw_state()
+void Tiltrotor::update_fw_state(const VtolControlCycle &cycle)
 {
-	VtolType::update_fw_state();
+	VtolType::update_fw_state(cycle);
 
 	// this is needed to avoid a race condition when entering backtransition when the mc rate controller publishes
 	// a zero throttle value
@@ -203,11 +279,11 @@ void Tiltrotor::update_fw_state()
 
 Controls the transition process, including tilt angles, thrust adjustments, and blending of control weights. */
 
-void Tiltrotor::update_transition_state()
+void Tiltrotor::update_transition_state(const VtolControlCycle &cycle)
 {
-	VtolType::update_transition_state();
+	VtolType::update_transition_state(cycle);
 
-	const hrt_abstime now = hrt_absolute_time();
+	const hrt_abstime now = cycle.now;
 
 	const Eulerf attitude_setpoint_euler(Quatf(_v_att_sp->q_d));
 	float roll_body = attitude_setpoint_euler.phi();
@@ -216,7 +292,7 @@ void Tiltrotor::update_transition_state()
 
 	// we get attitude setpoint from a multirotor flighttask if altitude is controlled.
 	// in any other case the fixed wing attitude controller publishes attitude setpoint from manual stick input.
-	if (_v_control_mode->flag_control_climb_rate_enabled) {
+	if (_io->in.climb_rate_control) {
 		// we need the incoming (virtual) attitude setpoints (both mc and fw) to be recent, otherwise return (means the previous setpoint stays active)
 		if (_mc_virtual_att_sp->timestamp < (now - 1_s) || _fw_virtual_att_sp->timestamp < (now - 1_s)) {
 			return;
@@ -242,29 +318,23 @@ void Tiltrotor::update_transition_state()
 
 		// tilt rotors forward up to certain angle
 		if (_tilt_control <= _param_vt_tilt_trans.get()) {
-			const float ramped_up_tilt = _param_vt_tilt_mc.get() +
-						     fabsf(_param_vt_tilt_trans.get() - _param_vt_tilt_mc.get()) *
-						     _time_since_trans_start / _param_vt_f_trans_dur.get() ;
-
 			// only allow increasing tilt (tilt in hover can already be non-zero)
-			_tilt_control = math::max(_tilt_control, ramped_up_tilt);
+			_tilt_control = math::max(_tilt_control, _front_p1_tilt_schedule.evaluate(_time_since_trans_start));
 		}
 
 		// at low speeds give full weight to MC
 		_mc_roll_weight = 1.0f;
 		_mc_yaw_weight = 1.0f;
 
-		if (_param_fw_use_airspd.get()  && PX4_ISFINITE(_airspeed_validated->calibrated_airspeed_m_s) &&
-		    _airspeed_validated->calibrated_airspeed_m_s >= getBlendAirspeed()) {
-			_mc_roll_weight = 1.0f - (_airspeed_validated->calibrated_airspeed_m_s - getBlendAirspeed()) /
-					  (getTransitionAirspeed()  - getBlendAirspeed());
+		if (_param_fw_use_airspd.get()  && PX4_ISFINITE(_io->in.calibrated_airspeed) &&
+		    _io->in.calibrated_airspeed >= getBlendAirspeed()) {
+			_mc_roll_weight = _roll_weight_airspeed_schedule.evaluate(_io->in.calibrated_airspeed);
 		}
 
 		// without airspeed do timed weight changes
-		if ((!_param_fw_use_airspd.get() || !PX4_ISFINITE(_airspeed_validated->calibrated_airspeed_m_s)) &&
+		if ((!_param_fw_use_airspd.get() || !PX4_ISFINITE(_io->in.calibrated_airspeed)) &&
 		    _time_since_trans_start > getMinimumFrontTransitionTime()) {
-			_mc_roll_weight = 1.0f - (_time_since_trans_start - getMinimumFrontTransitionTime()) /
-					  (getOpenLoopFrontTransitionTime() - getMinimumFrontTransitionTime());
+			_mc_roll_weight = _roll_weight_time_schedule.evaluate(_time_since_trans_start);
 		}
 
 		// add minimum throttle for front transition
@@ -272,9 +342,8 @@ void Tiltrotor::update_transition_state()
 
 	} else if (_vtol_mode == vtol_mode::TRANSITION_FRONT_P2) {
 		// the plane is ready to go into fixed wing mode, tilt the rotors forward completely
-		_tilt_control = math::constrain(_param_vt_tilt_trans.get() +
-						fabsf(_param_vt_tilt_fw.get() - _param_vt_tilt_trans.get()) * _time_since_trans_start /
-						_param_vt_trans_p2_dur.get(), _param_vt_tilt_trans.get(), _param_vt_tilt_fw.get());
+		_tilt_control = math::constrain(_front_p2_tilt_schedule.evaluate(_time_since_trans_start),
+						_param_vt_tilt_trans.get(), _param_vt_tilt_fw.get());
 
 		_mc_roll_weight = 0.0f;
 		_mc_yaw_weight = 0.0f;
@@ -290,26 +359,21 @@ void Tiltrotor::update_transition_state()
 
 		// tilt rotors back once motors are idle
 		if (_time_since_trans_start > BACKTRANS_THROTTLE_DOWNRAMP_DUR_S) {
-
-			float progress = (_time_since_trans_start - BACKTRANS_THROTTLE_DOWNRAMP_DUR_S) / math::max(_param_vt_bt_tilt_dur.get(),
-					 0.1f);
-			progress = math::constrain(progress, 0.0f, 1.0f);
-			_tilt_control = moveLinear(_param_vt_tilt_fw.get(), _param_vt_tilt_mc.get(), progress);
+			_tilt_control = _back_tilt_schedule.evaluate(_time_since_trans_start);
 		}
 
 		_mc_yaw_weight = 1.0f;
 
 		// control backtransition deceleration using pitch.
-		if (_v_control_mode->flag_control_climb_rate_enabled) {
-			pitch_body = update_and_get_backtransition_pitch_sp();
+		if (_io->in.climb_rate_control) {
+			pitch_body = update_and_get_backtransition_pitch_sp(cycle.dt);
 		}
 
 		if (_time_since_trans_start < BACKTRANS_THROTTLE_DOWNRAMP_DUR_S) {
 			// blend throttle from FW value to 0
 			_mc_throttle_weight = 1.0f;
 			const float target_throttle = 0.0f;
-			const float progress = _time_since_trans_start / BACKTRANS_THROTTLE_DOWNRAMP_DUR_S;
-			blendThrottleDuringBacktransition(progress, target_throttle);
+			blendThrottleDuringBacktransition(_back_throttle_down_schedule.evaluate(_time_since_trans_start), target_throttle);
 
 		} else if (_time_since_trans_start < timeUntilMotorsAreUp()) {
 			// while we quickly rotate back the motors keep throttle at idle
@@ -323,9 +387,7 @@ void Tiltrotor::update_transition_state()
 			_mc_roll_weight = 1.0f;
 			_mc_pitch_weight = 1.0f;
 			// slowly ramp up throttle to avoid step inputs
-			float progress = (_time_since_trans_start - timeUntilMotorsAreUp()) / BACKTRANS_THROTTLE_UPRAMP_DUR_S;
-			progress = math::constrain(progress, 0.0f, 1.0f);
-			_mc_throttle_weight = moveLinear(0.0f, 1.0f, progress);
+			_mc_throttle_weight = _back_throttle_up_schedule.evaluate(_time_since_trans_start);
 		}
 	}
 
@@ -357,37 +419,33 @@ void Tiltrotor::waiting_on_tecs()
 
 Publishes torque and thrust setpoints for both multicopter and fixed-wing motors, as well as tiltrotor-specific controls. */
 
-void Tiltrotor::fill_actuator_outputs()
+void Tiltrotor::fill_actuator_outputs(const VtolControlCycle &cycle)
 {
 
-	_torque_setpoint_0->timestamp = hrt_absolute_time();
-	_torque_setpoint_0->timestamp_sample = _vehicle_torque_setpoint_virtual_mc->timestamp_sample;
-	_torque_setpoint_0->xyz[0] = 0.f;
-	_torque_setpoint_0->xyz[1] = 0.f;
-	_torque_setpoint_0->xyz[2] = 0.f;
-
-	_torque_setpoint_1->timestamp = hrt_absolute_time();
-	_torque_setpoint_1->timestamp_sample = _vehicle_torque_setpoint_virtual_fw->timestamp_sample;
-	_torque_setpoint_1->xyz[0] = 0.f;
-	_torque_setpoint_1->xyz[1] = 0.f;
-	_torque_setpoint_1->xyz[2] = 0.f;
-
-	_thrust_setpoint_0->timestamp = hrt_absolute_time();
-	_thrust_setpoint_0->timestamp_sample = _vehicle_thrust_setpoint_virtual_mc->timestamp_sample;
-	_thrust_setpoint_0->xyz[0] = 0.f;
-	_thrust_setpoint_0->xyz[1] = 0.f;
-	_thrust_setpoint_0->xyz[2] = 0.f;
-
-	_thrust_setpoint_1->timestamp = hrt_absolute_time();
-	_thrust_setpoint_1->timestamp_sample = _vehicle_thrust_setpoint_virtual_fw->timestamp_sample;
-	_thrust_setpoint_1->xyz[0] = 0.f;
-	_thrust_setpoint_1->xyz[1] = 0.f;
-	_thrust_setpoint_1->xyz[2] = 0.f;
+	_io->out.torque_0.timestamp_sample = _io->in.mc_torque.timestamp_sample;
+	_io->out.torque_0.xyz[0] = 0.f;
+	_io->out.torque_0.xyz[1] = 0.f;
+	_io->out.torque_0.xyz[2] = 0.f;
+
+	_io->out.torque_1.timestamp_sample = _io->in.fw_torque.timestamp_sample;
+	_io->out.torque_1.xyz[0] = 0.f;
+	_io->out.torque_1.xyz[1] = 0.f;
+	_io->out.torque_1.xyz[2] = 0.f;
+
+	_io->out.thrust_0.timestamp_sample = _io->in.mc_thrust.timestamp_sample;
+	_io->out.thrust_0.xyz[0] = 0.f;
+	_io->out.thrust_0.xyz[1] = 0.f;
+	_io->out.thrust_0.xyz[2] = 0.f;
+
+	_io->out.thrust_1.timestamp_sample = _io->in.fw_thrust.timestamp_sample;
+	_io->out.thrust_1.xyz[0] = 0.f;
+	_io->out.thrust_1.xyz[1] = 0.f;
+	_io->out.thrust_1.xyz[2] = 0.f;
 
 	// Multirotor output
-	_torque_setpoint_0->xyz[0] = _vehicle_torque_setpoint_virtual_mc->xyz[0] * _mc_roll_weight;
-	_torque_setpoint_0->xyz[1] = _vehicle_torque_setpoint_virtual_mc->xyz[1] * _mc_pitch_weight;
-	_torque_setpoint_0->xyz[2] = _vehicle_torque_setpoint_virtual_mc->xyz[2] * _mc_yaw_weight;
+	_io->out.torque_0.xyz[0] = _io->in.mc_torque.xyz[0] * _mc_roll_weight;
+	_io->out.torque_0.xyz[1] = _io->in.mc_torque.xyz[1] * _mc_pitch_weight;
+	_io->out.torque_0.xyz[2] = _io->in.mc_torque.xyz[2] * _mc_yaw_weight;
 
 	// Special case tiltrotor: instead of passing a 3D thrust vector (that would mostly have a x-component in FW, and z in MC),
 	// pass the vector magnitude and collective tilt separately. MC also needs collective thrust on z.
@@ -398,31 +456,31 @@ void Tiltrotor::fill_actuator_outputs()
 
 	if (_vtol_mode == vtol_mode::FW_MODE) {
 
-		collective_thrust_normalized_setpoint = _vehicle_thrust_setpoint_virtual_fw->xyz[0];
-		_thrust_setpoint_0->xyz[2] = -collective_thrust_normalized_setpoint;
+		collective_thrust_normalized_setpoint = _io->in.fw_thrust.xyz[0];
+		_io->out.thrust_0.xyz[2] = -collective_thrust_normalized_setpoint;
 
 		/* allow differential thrust if enabled */
 		if (_param_vt_fw_difthr_en.get() & static_cast<int32_t>(VtFwDifthrEnBits::YAW_BIT)) {
-			_torque_setpoint_0->xyz[2] = _vehicle_torque_setpoint_virtual_fw->xyz[2] * _param_vt_fw_difthr_s_y.get() ;
+			_io->out.torque_0.xyz[2] = _io->in.fw_torque.xyz[2] * _param_vt_fw_difthr_s_y.get() ;
 		}
 
 	} else {
-		collective_thrust_normalized_setpoint = -_vehicle_thrust_setpoint_virtual_mc->xyz[2] * _mc_throttle_weight;
-		_thrust_setpoint_0->xyz[2] = -collective_thrust_normalized_setpoint;
+		collective_thrust_normalized_setpoint = -_io->in.mc_thrust.xyz[2] * _mc_throttle_weight;
+		_io->out.thrust_0.xyz[2] = -collective_thrust_normalized_setpoint;
 	}
 
 	// Fixed wing output
 	if (!_param_vt_elev_mc_lock.get() || _vtol_mode != vtol_mode::MC_MODE) {
-		_torque_setpoint_1->xyz[0] = _vehicle_torque_setpoint_virtual_fw->xyz[0];
-		_torque_setpoint_1->xyz[1] = _vehicle_torque_setpoint_virtual_fw->xyz[1];
-		_torque_setpoint_1->xyz[2] = _vehicle_torque_setpoint_virtual_fw->xyz[2];
+		_io->out.torque_1.xyz[0] = _io->in.fw_torque.xyz[0];
+		_io->out.torque_1.xyz[1] = _io->in.fw_torque.xyz[1];
+		_io->out.torque_1.xyz[2] = _io->in.fw_torque.xyz[2];
 	}
 
 	// publish tiltrotor extra controls
 	tiltrotor_extra_controls_s tiltrotor_extra_controls = {};
 	tiltrotor_extra_controls.collective_tilt_normalized_setpoint = _tilt_control;
 	tiltrotor_extra_controls.collective_thrust_normalized_setpoint = collective_thrust_normalized_setpoint;
-	tiltrotor_extra_controls.timestamp = hrt_absolute_time();
+	tiltrotor_extra_controls.timestamp = cycle.now;
 	_tiltrotor_extra_controls_pub.publish(tiltrotor_extra_controls);
 }
 
@@ -454,12 +512,9 @@ float Tiltrotor::timeUntilMotorsAreUp()
 	return BACKTRANS_THROTTLE_DOWNRAMP_DUR_S + _param_vt_bt_tilt_dur.get();
 }
 
-float Tiltrotor::moveLinear(float start, float stop, float progress)
-{
-	return start + progress * (stop - start);
-}
-
 bool Tiltrotor::isFrontTransitionCompletedBase()
 {
 	return VtolType::isFrontTransitionCompletedBase() && _tilt_control >= _param_vt_tilt_trans.get();
 }
+
+#endif // VTOL_ATT_CONTROL_HAS_TILTROTOR
@@ -9,7 +9,7 @@
 #include <uORB/Publication.hpp>
 #include <uORB/topics/tiltrotor_extra_controls.h>
 
-class Tiltrotor : public VtolType
+class Tiltrotor final : public VtolType
 {
 
 public:
@@ -17,13 +17,17 @@ public:
 	Tiltrotor(VtolAttitudeControl *_att_controller);
 	~Tiltrotor() override = default;
 
-	void update_vtol_state() override;
-	void update_transition_state() override;
-	void fill_actuator_outputs() override;
-	void update_mc_state() override;
-	void update_fw_state() override;
+	void update_vtol_state(const VtolControlCycle &cycle) override;
+	void update_transition_state(const VtolControlCycle &cycle) override;
+	void fill_actuator_outputs(const VtolControlCycle &cycle) override;
+	void update_mc_state(const VtolControlCycle &cycle) override;
+	void update_fw_state(const VtolControlCycle &cycle) override;
 	void waiting_on_tecs() override;
 	void blendThrottleAfterFrontTransition(float scale) override;
+	const char *get_vtol_mode_name() const override;
+	bool uses_torque_setpoint_1() const override { return !(_param_vt_elev_mc_lock.get() && _vtol_mode == vtol_mode::MC_MODE); }
+	void parameters_update() override;
+	uint16_t get_input_set(mode vtol_mode) const override;
 
 private:
 	enum class vtol_mode {
@@ -46,9 +50,18 @@ private:
 
 	float _tilt_control{0.0f};		/**< actuator value for the tilt servo */
 
-	void parameters_update() override;
+	// tilt, throttle and MC weight profiles over the time since the transition start or the airspeed
+	TransitionSchedule _front_p1_tilt_schedule;
+	TransitionSchedule _front_p2_tilt_schedule;
+	TransitionSchedule _back_tilt_schedule;
+	TransitionSchedule _back_throttle_down_schedule;	// blend scale from the FW throttle to idle
+	TransitionSchedule _back_throttle_up_schedule;		// MC throttle weight after the motors are tilted up
+	TransitionSchedule _roll_weight_airspeed_schedule;	// MC roll weight over calibrated airspeed
+	TransitionSchedule _roll_weight_time_schedule;		// MC roll weight over time without airspeed
+
 	float timeUntilMotorsAreUp();
-	float moveLinear(float start, float stop, float progress);
+
+	void update_transition_schedules() override;
 
 	void blendThrottleDuringBacktransition(const float scale, const float target_throttle);
 	bool isFrontTransitionCompletedBase() override;
@@ -59,7 +72,8 @@ private:
 					(ParamFloat<px4::params::VT_TILT_TRANS>) _param_vt_tilt_trans,
 					(ParamFloat<px4::params::VT_TILT_FW>) _param_vt_tilt_fw,
 					(ParamFloat<px4::params::VT_TRANS_P2_DUR>) _param_vt_trans_p2_dur,
-					(ParamFloat<px4::params::VT_BT_TILT_DUR>) _param_vt_bt_tilt_dur
+					(ParamFloat<px4::params::VT_BT_TILT_DUR>) _param_vt_bt_tilt_dur,
+					(ParamFloat<px4::params::VT_SHAPE_TILT>) _param_vt_shape_tilt
 				       )
 
 };
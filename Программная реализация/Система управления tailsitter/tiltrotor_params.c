@@ -60,3 +60,17 @@ PARAM_DEFINE_FLOAT(VT_TRANS_P2_DUR, 0.5f);
  * @group VTOL Attitude Control
  */
 PARAM_DEFINE_FLOAT(VT_BT_TILT_DUR, 1.f);
+
+/**
+ * Tiltrotor tilt profile shape
+ *
+ * Shape of the motor tilt ramps over VT_F_TRANS_DUR, VT_TRANS_P2_DUR and VT_BT_TILT_DUR.
+ * 0 is linear, positive values start slowly and finish fast, negative values start fast and finish slowly.
+ *
+ * @min -1
+ * @max 1
+ * @increment 0.05
+ * @decimal 2
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_SHAPE_TILT, 0.0f);
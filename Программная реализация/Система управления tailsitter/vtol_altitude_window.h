@@ -0,0 +1,223 @@
+/**
+ * @file vtol_altitude_window.h
+ * @brief Sliding-window altitude statistics for the quadchute checks.
+ *
+ * Keeps the last N altitude samples, decimated to one every horizon / N, together with the
+ * maximum altitude, the minimum shortfall against a reference and the sums of a least-squares
+ * line through the altitudes. The extrema are kept in monotonic queues, where every sample is
+ * inserted and removed once, and the sums are only corrected for the sample entering and the
+ * one leaving the window. An update therefore costs the same at any horizon, and a longer
+ * horizon only makes the samples sparser. Altitude resets shift the whole window through a
+ * single offset.
+ */
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+
+#include <math.h>
+#include <stdint.h>
+
+using namespace time_literals;
+
+template<int N>
+class AltitudeWindow
+{
+public:
+	static_assert(N >= 2 && (N & (N - 1)) == 0, "window size must be a power of two");
+
+	/**
+	 * Set the time span covered by the window and clear it.
+	 *
+	 * @param horizon Horizon [s]
+	 */
+	void set_horizon(float horizon)
+	{
+		_spacing = static_cast<hrt_abstime>(horizon * (1e6f / N));
+		reset();
+	}
+
+	void reset()
+	{
+		_count = 0;
+		_max_queue_size = 0;
+		_min_queue_size = 0;
+		_offset = 0.f;
+		_descent_rate = 0.f;
+		_sum_t = 0.0;
+		_sum_a = 0.0;
+		_sum_tt = 0.0;
+		_sum_ta = 0.0;
+	}
+
+	/**
+	 * Add the altitude of the current cycle. It is stored if it is at least horizon / N
+	 * after the newest stored sample, the window is cleared after a longer gap.
+	 *
+	 * @param now Sample time
+	 * @param altitude Altitude [m], positive up
+	 * @param shortfall Reference minus altitude [m], -INFINITY without a valid reference
+	 */
+	void update(hrt_abstime now, float altitude, float shortfall)
+	{
+		if (_count > 0 && now > _current_time + _spacing + kMaxUpdateGap) {
+			reset();
+		}
+
+		_current_time = now;
+		_current_altitude = altitude - _offset;
+		_current_shortfall = shortfall;
+
+		if (_count == 0 || now >= newest().time + _spacing) {
+			push(now, altitude - _offset, shortfall);
+		}
+	}
+
+	/**
+	 * Shift all altitudes in the window, for estimator altitude resets.
+	 *
+	 * @param delta Altitude change [m]
+	 */
+	void shift(float delta) { _offset += delta; }
+
+	/**
+	 * @return true if the window holds N samples, spanning the horizon
+	 */
+	bool full() const { return _count == N; }
+
+	int size() const { return _count; }
+
+	/**
+	 * @return Highest altitude in the window and the current cycle [m], NAN if empty
+	 */
+	float max_altitude() const
+	{
+		if (_count == 0) {
+			return NAN;
+		}
+
+		return fmaxf(_samples[_max_queue[index(_max_queue_front)] & kMask].altitude, _current_altitude) + _offset;
+	}
+
+	/**
+	 * @return Smallest shortfall in the window and the current cycle [m], NAN if empty
+	 */
+	float min_shortfall() const
+	{
+		if (_count == 0) {
+			return NAN;
+		}
+
+		return fminf(_samples[_min_queue[index(_min_queue_front)] & kMask].shortfall, _current_shortfall);
+	}
+
+	/**
+	 * @return Descent rate of the least-squares line through the stored samples [m/s], positive down,
+	 * 0 with less than 2 samples
+	 */
+	float descent_rate() const { return _descent_rate; }
+
+private:
+	static constexpr uint32_t kMask = N - 1;
+	static constexpr hrt_abstime kMaxUpdateGap = 100_ms;	// tolerated delay of an update beyond the sample spacing
+
+	struct Sample {
+		hrt_abstime time;
+		float altitude;		// without _offset [m]
+		float shortfall;	// [m]
+	};
+
+	static uint32_t index(uint32_t position) { return position & kMask; }
+
+	const Sample &newest() const { return _samples[(_sequence - 1) & kMask]; }
+
+	void push(hrt_abstime now, float altitude, float shortfall)
+	{
+		// move the origin of the sums to the new sample, times and altitudes stay within the window
+		// span that way and the new sample adds nothing but a count
+		if (_count > 0) {
+			const double n = _count;
+			const double c = (now - newest().time) * 1e-6;
+			const double d = altitude - newest().altitude;
+
+			_sum_ta += -c * _sum_a - d * _sum_t + n * c * d;
+			_sum_tt += -2.f * c * _sum_t + n * c * c;
+			_sum_t -= n * c;
+			_sum_a -= n * d;
+		}
+
+		if (_count == N) {
+			// the oldest sample leaves the window
+			const Sample &oldest = _samples[_sequence & kMask];
+			const double t = -((now - oldest.time) * 1e-6);
+			const double a = oldest.altitude - altitude;
+
+			_sum_t -= t;
+			_sum_a -= a;
+			_sum_tt -= t * t;
+			_sum_ta -= t * a;
+
+			if (_max_queue_size > 0 && _max_queue[index(_max_queue_front)] == _sequence - N) {
+				_max_queue_front++;
+				_max_queue_size--;
+			}
+
+			if (_min_queue_size > 0 && _min_queue[index(_min_queue_front)] == _sequence - N) {
+				_min_queue_front++;
+				_min_queue_size--;
+			}
+
+		} else {
+			_count++;
+		}
+
+		_samples[_sequence & kMask] = Sample{now, altitude, shortfall};
+
+		// drop the samples that can no longer be the extremum, they are older and not larger (smaller)
+		while (_max_queue_size > 0
+		       && _samples[_max_queue[index(_max_queue_front + _max_queue_size - 1)] & kMask].altitude <= altitude) {
+			_max_queue_size--;
+		}
+
+		while (_min_queue_size > 0
+		       && _samples[_min_queue[index(_min_queue_front + _min_queue_size - 1)] & kMask].shortfall >= shortfall) {
+			_min_queue_size--;
+		}
+
+		_max_queue[index(_max_queue_front + _max_queue_size++)] = _sequence;
+		_min_queue[index(_min_queue_front + _min_queue_size++)] = _sequence;
+		_sequence++;
+
+		const double n = _count;
+		const double denominator = n * _sum_tt - _sum_t * _sum_t;
+		_descent_rate = (_count >= 2 && denominator > 0.0) ? static_cast<float>(-(n * _sum_ta - _sum_t * _sum_a) / denominator) : 0.f;
+	}
+
+	Sample _samples[N] {};
+	uint32_t _sequence{0};	// sequence number of the next sample, its slot is _sequence & kMask
+	int _count{0};
+
+	// sequence numbers of the candidates for the maximum altitude and minimum shortfall, in insertion order
+	uint32_t _max_queue[N] {};
+	uint32_t _min_queue[N] {};
+	uint32_t _max_queue_front{0};
+	uint32_t _min_queue_front{0};
+	int _max_queue_size{0};
+	int _min_queue_size{0};
+
+	hrt_abstime _spacing{0};
+	float _offset{0.f};	// added to all stored altitudes [m]
+
+	hrt_abstime _current_time{0};
+	float _current_altitude{0.f};	// without _offset [m]
+	float _current_shortfall{0.f};
+
+	float _descent_rate{0.f};	// [m/s]
+
+	// least-squares sums of the stored samples, time [s] and altitude [m] relative to the newest one.
+	// Only updated when a sample is stored, in double so the rounding of the repeated origin shifts does not accumulate.
+	double _sum_t{0.0};
+	double _sum_a{0.0};
+	double _sum_tt{0.0};
+	double _sum_ta{0.0};
+};
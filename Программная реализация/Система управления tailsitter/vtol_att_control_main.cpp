@@ -10,10 +10,13 @@
 
 
 #include "vtol_att_control_main.h"
+#include "vtol_fast_trig.h"
 #include <px4_platform_common/events.h>
 #include <systemlib/mavlink_log.h>
 #include <uORB/Publication.hpp>
 
+#include <float.h>
+
 using namespace matrix;
 using namespace time_literals;
 
@@ -25,27 +28,47 @@ using namespace time_literals;
  * between multicopter and fixed-wing modes, as well as monitoring system status and failures.
  */
 
-VtolAttitudeControl::VtolAttitudeControl() :
+VtolAttitudeControl::VtolAttitudeControl(const VtolClock &clock) :
 	ModuleParams(nullptr),
 	WorkItem(MODULE_NAME, px4::wq_configurations::rate_ctrl),
-	_loop_perf(perf_alloc(PC_ELAPSED, "vtol_att_control: cycle"))
+	_clock(clock),
+	_loop_perf(perf_alloc(PC_ELAPSED, "vtol_att_control: cycle")),
+	_loop_interval_perf(perf_alloc(PC_INTERVAL, "vtol_att_control: interval"))
 {
 	// start vtol in rotary wing mode
 	_vtol_vehicle_status.vehicle_vtol_state = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_MC;
 
 	parameters_update();
+	update_min_run_intervals();
+	_publish_heartbeat = static_cast<hrt_abstime>(math::max(_param_vt_pub_hb.get(), 0.f) * 1e6f);
 
-	if (static_cast<vtol_type>(_param_vt_type.get()) == vtol_type::TAILSITTER) {
-		_vtol_type = new Tailsitter(this);
+	_profiler.set_enabled(_param_vt_prof_en.get());
 
-	} else if (static_cast<vtol_type>(_param_vt_type.get()) == vtol_type::TILTROTOR) {
-		_vtol_type = new Tiltrotor(this);
+	// construct the VTOL type in the storage reserved inside this object, no heap allocation
+	switch (static_cast<vtol_type>(_param_vt_type.get())) {
+#if VTOL_ATT_CONTROL_HAS_TAILSITTER
 
-	} else if (static_cast<vtol_type>(_param_vt_type.get()) == vtol_type::STANDARD) {
-		_vtol_type = new Standard(this);
+	case vtol_type::TAILSITTER:
+		_vtol_type = new (_vtol_type_storage) Tailsitter(this);
+		break;
+#endif
+#if VTOL_ATT_CONTROL_HAS_TILTROTOR
 
-	} else {
-		exit_and_cleanup();
+	case vtol_type::TILTROTOR:
+		_vtol_type = new (_vtol_type_storage) Tiltrotor(this);
+		break;
+#endif
+#if VTOL_ATT_CONTROL_HAS_STANDARD
+
+	case vtol_type::STANDARD:
+		_vtol_type = new (_vtol_type_storage) Standard(this);
+		break;
+#endif
+
+	default:
+		// unknown or not part of this build, left unset: init() fails and the module is not started
+		PX4_ERR("VT_TYPE %d not supported by this build", (int)_param_vt_type.get());
+		break;
 	}
 
 	_flaps_setpoint_pub.advertise();
@@ -60,12 +83,19 @@ VtolAttitudeControl::VtolAttitudeControl() :
 /**
  * @brief Destructor for VtolAttitudeControl.
  *
- * Frees performance measurement data.
+ * Destroys the VTOL type object and frees performance measurement data.
  */
 
 VtolAttitudeControl::~VtolAttitudeControl()
 {
+	if (_vtol_type != nullptr) {
+		// placement constructed, only the destructor is run
+		_vtol_type->~VtolTypeImpl();
+		_vtol_type = nullptr;
+	}
+
 	perf_free(_loop_perf);
+	perf_free(_loop_interval_perf);
 }
 
 /**
@@ -79,6 +109,10 @@ VtolAttitudeControl::~VtolAttitudeControl()
 bool
 VtolAttitudeControl::init()
 {
+	if (_vtol_type == nullptr) {
+		return false;
+	}
+
 	if (!_vehicle_torque_setpoint_virtual_fw_sub.registerCallback()) {
 		PX4_ERR("callback registration failed");
 		return false;
@@ -99,109 +133,63 @@ VtolAttitudeControl::init()
 		return false;
 	}
 
+	_publish_count_start = _clock.now();
+
+	_command_handler.start();
+
 	return true;
 }
 
 /**
- * @brief Polls for vehicle status changes.
+ * @brief Applies the latest state of the slow-path command handler.
  *
- * This function checks for changes in the vehicle's navigation state and adjusts the VTOL transition accordingly.
+ * Copies the transition command, navigation state, home altitude and air density and
+ * handles the edge events (immediate transition, fixed-wing failure reset) once.
  */
 
-void VtolAttitudeControl::vehicle_status_poll()
+void
+VtolAttitudeControl::command_handler_update()
 {
-	_vehicle_status_sub.copy(&_vehicle_status);
+	VtolCommandHandler::State state;
 
-	// abort front transition when RTL is triggered
-	if (_vehicle_status.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_RTL
-	    && _nav_state_prev != vehicle_status_s::NAVIGATION_STATE_AUTO_RTL && _vtol_type->get_mode() == mode::TRANSITION_TO_FW) {
-		_transition_command = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_MC;
+	if (!_command_handler.get_state(state)) {
+		// handler is writing right now, keep the previous state for this cycle
+		return;
 	}
 
-	_nav_state_prev = _vehicle_status.nav_state;
-}
+	_transition_command = state.transition_command;
 
-/**
- * @brief Polls for action requests.
- *
- * Handles specific action requests, such as VTOL transitions, and updates the transition command.
- */
+	if (state.immediate_transition_count != _immediate_transition_count) {
+		_immediate_transition = state.immediate_transition;
+		_immediate_transition_count = state.immediate_transition_count;
+	}
 
-void VtolAttitudeControl::action_request_poll()
-{
-	while (_action_request_sub.updated()) {
-		action_request_s action_request;
-
-		if (_action_request_sub.copy(&action_request)) {
-			switch (action_request.action) {
-			case action_request_s::ACTION_VTOL_TRANSITION_TO_MULTICOPTER:
-				_transition_command = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_MC;
-				_immediate_transition = false;
-				break;
-
-			case action_request_s::ACTION_VTOL_TRANSITION_TO_FIXEDWING:
-				_transition_command = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW;
-				_immediate_transition = false;
-
-				// reset fixed_wing_system_failure flag when a new transition to FW is triggered
-				if (_transition_command == vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW) {
-					_vtol_vehicle_status.fixed_wing_system_failure = false;
-				}
-
-				break;
-			}
-		}
+	if (state.fw_failure_reset_count != _fw_failure_reset_count) {
+		// reset fixed_wing_system_failure flag when a new transition to FW is triggered
+		_vtol_vehicle_status.fixed_wing_system_failure = false;
+		_fw_failure_reset_count = state.fw_failure_reset_count;
 	}
+
+	_nav_state = state.nav_state;
+	_home_position_z = state.home_position_z;
+	_air_density = state.air_density;
 }
 
 /**
- * @brief Polls for vehicle commands.
+ * @brief Takes over a measured transition table newly published by the command handler.
  *
- * Processes vehicle commands related to VTOL transitions and manages command acknowledgments.
+ * Only copies the grid when the handler has read the table again (VT_TRANS_TBL changed), the file
+ * system is never accessed from here.
  */
 
-void VtolAttitudeControl::vehicle_cmd_poll()
+void
+VtolAttitudeControl::transition_table_update()
 {
-	vehicle_command_s vehicle_command;
-
-	while (_vehicle_cmd_sub.update(&vehicle_command)) {
-		if (vehicle_command.command == vehicle_command_s::VEHICLE_CMD_DO_VTOL_TRANSITION) {
-
-			uint8_t result = vehicle_command_ack_s::VEHICLE_CMD_RESULT_ACCEPTED;
-
-			const int transition_command_param1 = int(vehicle_command.param1 + 0.5f);
+	TransitionTableHandover &table = _command_handler.transition_table();
 
-			// deny transition from MC to FW in Takeoff, Land, RTL and Orbit
-			if (transition_command_param1 == vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW &&
-			    (_vehicle_status.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_TAKEOFF
-			     || _vehicle_status.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_LAND
-			     || _vehicle_status.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_RTL
-			     ||  _vehicle_status.nav_state == vehicle_status_s::NAVIGATION_STATE_ORBIT)) {
-
-				result = vehicle_command_ack_s::VEHICLE_CMD_RESULT_TEMPORARILY_REJECTED;
-
-			} else {
-				_transition_command = transition_command_param1;
-				_immediate_transition = (PX4_ISFINITE(vehicle_command.param2)) ? int(vehicle_command.param2 + 0.5f) : false;
-
-				// reset fixed_wing_system_failure flag when a new transition to FW is triggered
-				if (_transition_command == vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW) {
-					_vtol_vehicle_status.fixed_wing_system_failure = false;
-				}
-			}
-
-			if (vehicle_command.from_external) {
-				vehicle_command_ack_s command_ack{};
-				command_ack.timestamp = hrt_absolute_time();
-				command_ack.command = vehicle_command.command;
-				command_ack.result = result;
-				command_ack.target_system = vehicle_command.source_system;
-				command_ack.target_component = vehicle_command.source_component;
-
-				uORB::Publication<vehicle_command_ack_s> command_ack_pub{ORB_ID(vehicle_command_ack)};
-				command_ack_pub.publish(command_ack);
-			}
-		}
+	if (table.generation() != _vtol_type->transition_table_generation()
+	    && _vtol_type->update_measured_transition_performance(table)) {
+		_vtol_type->update_derived_params();
 	}
 }
 
@@ -283,9 +271,163 @@ VtolAttitudeControl::parameters_update()
 		// update parameters from storage
 		updateParams();
 
+		// a running bench owns the profiler until its window is closed
+		if (static_cast<BenchState>(_bench_state.load()) == BenchState::Idle) {
+			_profiler.set_enabled(_param_vt_prof_en.get());
+		}
+
 		if (_vtol_type != nullptr) {
 			_vtol_type->parameters_update();
+			_vtol_type->update_transition_performance();
+			_vtol_type->update_derived_params();
 		}
+
+		update_min_run_intervals();
+		_publish_heartbeat = static_cast<hrt_abstime>(math::max(_param_vt_pub_hb.get(), 0.f) * 1e6f);
+	}
+}
+
+/**
+ * @brief Input synchronization stage for transitions.
+ *
+ * During transitions both the MC and the FW virtual setpoints are used. They are published
+ * by two controllers and each update triggers a callback, so without synchronization one
+ * control period runs the full pipeline up to four times. Updates are therefore collected
+ * until all four inputs are new and carry the same timestamp_sample. A newer sample of one
+ * side supersedes a pending older sample of the other side, which keeps the pairing in phase.
+ * Fallbacks run the cycle anyway if an input is updated again before the set is complete
+ * (one side is slow or missing), if the complete set has mismatching samples, or if the set
+ * has been pending for longer than kInputSyncTimeout. The timeout is evaluated on the next callback.
+ *
+ * @param updated_inputs Bitmask of the virtual setpoints updated in this run (InputBits)
+ * @param now Time of this run
+ * @return true if the cycle should run now
+ */
+
+bool
+VtolAttitudeControl::transition_inputs_synchronized(uint8_t updated_inputs, hrt_abstime now)
+{
+	const bool repeated = (_pending_inputs & updated_inputs) != 0;
+
+	const VtolInputs &in = _io.in;
+	const hrt_abstime mc_sample = math::max(in.mc_torque.timestamp_sample, in.mc_thrust.timestamp_sample);
+	const hrt_abstime fw_sample = math::max(in.fw_torque.timestamp_sample, in.fw_thrust.timestamp_sample);
+
+	if ((updated_inputs & INPUT_MC) && (_pending_inputs & INPUT_FW) && fw_sample < mc_sample) {
+		// FW side is behind, wait for its sample matching the new MC one
+		_pending_inputs &= ~INPUT_FW;
+
+	} else if ((updated_inputs & INPUT_FW) && (_pending_inputs & INPUT_MC) && mc_sample < fw_sample) {
+		_pending_inputs &= ~INPUT_MC;
+	}
+
+	if (_pending_inputs == 0) {
+		_pending_inputs_since = now;
+	}
+
+	_pending_inputs |= updated_inputs;
+
+	if (_pending_inputs == INPUT_ALL) {
+		const hrt_abstime sample = in.mc_torque.timestamp_sample;
+
+		if (in.mc_thrust.timestamp_sample == sample
+		    && in.fw_torque.timestamp_sample == sample
+		    && in.fw_thrust.timestamp_sample == sample) {
+			_input_sync_matched++;
+
+		} else {
+			_input_sync_fallback_mismatch++;
+		}
+
+	} else if (repeated) {
+		_input_sync_fallback_repeat++;
+
+	} else if (now - _pending_inputs_since > kInputSyncTimeout) {
+		_input_sync_fallback_timeout++;
+
+	} else {
+		// wait for the rest of the set, this run would have been redundant
+		_input_sync_merged++;
+		return false;
+	}
+
+	_synced_inputs = _pending_inputs;
+	_pending_inputs = 0;
+	return true;
+}
+
+/**
+ * @brief Inputs of a cycle in the given mode, those of the VTOL type plus the ones used here.
+ */
+
+uint16_t
+VtolAttitudeControl::cycle_input_set(mode vtol_mode) const
+{
+	uint16_t inputs = _vtol_type->get_input_set(vtol_mode) | VtolType::INPUT_CONTROL_MODE;
+
+	if (vtol_mode != mode::FIXED_WING) {
+		// flaps/spoilers in hover and transitions
+		inputs |= VtolType::INPUT_POSITION_SETPOINT_TRIPLET;
+	}
+
+	return inputs;
+}
+
+/**
+ * @brief Reads the given input topics (VtolType::Input bits) if updated.
+ */
+
+void
+VtolAttitudeControl::poll_inputs(uint16_t inputs)
+{
+	if (inputs & VtolType::INPUT_CONTROL_MODE) {
+		read_input(_vehicle_control_mode_sub, _input_staging.control_mode, _io.in);
+	}
+
+	if (inputs & VtolType::INPUT_ATTITUDE) {
+		read_input(_vehicle_attitude_sub, _input_staging.attitude, _io.in);
+	}
+
+	if (inputs & VtolType::INPUT_LOCAL_POSITION) {
+		read_input(_local_pos_sub, _input_staging.local_pos, _io.in);
+	}
+
+	if (inputs & VtolType::INPUT_POSITION_SETPOINT_TRIPLET) {
+		read_input(_pos_sp_triplet_sub, _input_staging.pos_sp_triplet, _io.in);
+	}
+
+	if (inputs & VtolType::INPUT_AIRSPEED) {
+		read_input(_airspeed_validated_sub, _input_staging.airspeed, _io.in);
+	}
+
+	if (inputs & VtolType::INPUT_TECS_STATUS) {
+		read_input(_tecs_status_sub, _input_staging.tecs_status, _io.in);
+	}
+
+	if (inputs & VtolType::INPUT_LAND_DETECTED) {
+		read_input(_land_detected_sub, _input_staging.land_detected, _io.in);
+	}
+
+	_input_polls += math::countSetBits(inputs);
+}
+
+/**
+ * @brief Converts the per-mode rate limits (VT_RATE_*) into minimum cycle intervals.
+ */
+
+void
+VtolAttitudeControl::update_min_run_intervals()
+{
+	const float rates[] = {
+		_param_vt_rate_f_trans.get(),	// TRANSITION_TO_FW
+		_param_vt_rate_b_trans.get(),	// TRANSITION_TO_MC
+		_param_vt_rate_mc.get(),	// ROTARY_WING
+		_param_vt_rate_fw.get()		// FIXED_WING
+	};
+
+	for (int i = 0; i < kNumModes; i++) {
+		// 0 disables the limit
+		_min_run_interval[i] = rates[i] > FLT_EPSILON ? static_cast<hrt_abstime>(1e6f / rates[i]) : 0;
 	}
 }
 
@@ -299,6 +441,7 @@ void
 VtolAttitudeControl::Run()
 {
 	if (should_exit()) {
+		_command_handler.stop();
 		_vehicle_torque_setpoint_virtual_fw_sub.unregisterCallback();
 		_vehicle_torque_setpoint_virtual_mc_sub.unregisterCallback();
 		_vehicle_thrust_setpoint_virtual_fw_sub.unregisterCallback();
@@ -307,16 +450,7 @@ VtolAttitudeControl::Run()
 		return;
 	}
 
-#if !defined(ENABLE_LOCKSTEP_SCHEDULER)
-
-	const hrt_abstime now = hrt_absolute_time();
-
-	// prevent excessive scheduling (> 500 Hz)
-	if (now - _last_run_timestamp < 2_ms) {
-		return;
-	}
-
-#endif // !ENABLE_LOCKSTEP_SCHEDULER
+	perf_count(_loop_interval_perf);
 
 	if (!_initialized) {
 
@@ -329,12 +463,25 @@ VtolAttitudeControl::Run()
 		}
 	}
 
+	bench_handle_request();
+	replay_handle_request();
+
+	// the only clock read of a cycle, all timestamps and elapsed times are derived from it
+	const hrt_abstime now = _clock.now();
+
 	perf_begin(_loop_perf);
+	_profiler.begin_cycle();
 
-	bool updated_fw_in = _vehicle_torque_setpoint_virtual_fw_sub.update(&_vehicle_torque_setpoint_virtual_fw);
-	updated_fw_in |= _vehicle_thrust_setpoint_virtual_fw_sub.update(&_vehicle_thrust_setpoint_virtual_fw);
-	bool updated_mc_in = _vehicle_torque_setpoint_virtual_mc_sub.update(&_vehicle_torque_setpoint_virtual_mc);
-	updated_mc_in |= _vehicle_thrust_setpoint_virtual_mc_sub.update(&_vehicle_thrust_setpoint_virtual_mc);
+	uint8_t updated_inputs = 0;
+	updated_inputs |= read_input(_vehicle_torque_setpoint_virtual_mc_sub, _input_staging.torque, _io.in.mc_torque) ? INPUT_MC_TORQUE : 0;
+	updated_inputs |= read_input(_vehicle_thrust_setpoint_virtual_mc_sub, _input_staging.thrust, _io.in.mc_thrust) ? INPUT_MC_THRUST : 0;
+	updated_inputs |= read_input(_vehicle_torque_setpoint_virtual_fw_sub, _input_staging.torque, _io.in.fw_torque) ? INPUT_FW_TORQUE : 0;
+	updated_inputs |= read_input(_vehicle_thrust_setpoint_virtual_fw_sub, _input_staging.thrust, _io.in.fw_thrust) ? INPUT_FW_THRUST : 0;
+
+	const bool updated_mc_in = updated_inputs & INPUT_MC;
+	const bool updated_fw_in = updated_inputs & INPUT_FW;
+
+	_profiler.mark(VtolProfiler::Phase::VirtualSetpoints);
 
 	// run on actuator publications corresponding to VTOL mode
 	bool should_run = false;
@@ -354,38 +501,56 @@ VtolAttitudeControl::Run()
 		break;
 	}
 
-	if (should_run) {
-		parameters_update();
+	if (!should_run) {
+		_runs_skipped++;
+	}
 
-		_vehicle_control_mode_sub.update(&_vehicle_control_mode);
-		_vehicle_attitude_sub.update(&_vehicle_attitude);
-		_local_pos_sub.update(&_local_pos);
-		_local_pos_sp_sub.update(&_local_pos_sp);
-		_pos_sp_triplet_sub.update(&_pos_sp_triplet);
-		_airspeed_validated_sub.update(&_airspeed_validated);
-		_tecs_status_sub.update(&_tecs_status);
-		_land_detected_sub.update(&_land_detected);
+#if !defined(ENABLE_LOCKSTEP_SCHEDULER)
 
-		if (_home_position_sub.updated()) {
-			home_position_s home_position;
+	// limit the cycle rate of the current mode (VT_RATE_*). The inputs are copied above in any case,
+	// so the next cycle runs on the latest data. The gate comes before the transition input
+	// synchronization, a dropped run leaves the pending set alone and the next cycle runs once
+	// a set is complete again.
+	if (should_run && now - _last_cycle_timestamp < _min_run_interval[mode_index(_vtol_type->get_mode())]) {
+		should_run = false;
+		_runs_rate_limited++;
+	}
 
-			if (_home_position_sub.copy(&home_position) && home_position.valid_alt) {
-				_home_position_z = home_position.z;
+#endif // !ENABLE_LOCKSTEP_SCHEDULER
 
-			} else {
-				_home_position_z = NAN;
-			}
-		}
+	if (_vtol_type->get_mode() == mode::TRANSITION_TO_FW || _vtol_type->get_mode() == mode::TRANSITION_TO_MC) {
+		// run once per coherent set of MC and FW setpoints instead of on every single update
+		should_run = should_run && transition_inputs_synchronized(updated_inputs, now);
 
-		vehicle_status_poll();
-		action_request_poll();
-		vehicle_cmd_poll();
+	} else {
+		_pending_inputs = 0;
+	}
 
-		vehicle_air_data_s air_data;
+	if (should_run && (_vtol_type->get_mode() == mode::TRANSITION_TO_FW || _vtol_type->get_mode() == mode::TRANSITION_TO_MC)
+	    && (!(_synced_inputs & INPUT_MC) || !(_synced_inputs & INPUT_FW))) {
+		_runs_redundant++;
+	}
 
-		if (_vehicle_air_data_sub.update(&air_data)) {
-			_air_density = air_data.rho;
-		}
+	if (should_run) {
+		const VtolControlCycle cycle{now, math::constrain((now - _last_cycle_timestamp) * 1e-6f, VtolControlCycle::kMinDt, VtolControlCycle::kMaxDt)};
+		_last_cycle_timestamp = now;
+
+		parameters_update();
+
+		// only copy the topics the current mode consumes
+		const mode mode_before = _vtol_type->get_mode();
+		uint16_t polled_inputs = cycle_input_set(mode_before);
+		poll_inputs(polled_inputs);
+		_input_polls_possible += VtolType::kNumInputs;
+
+		_profiler.mark(VtolProfiler::Phase::Subscriptions);
+
+		// status, commands, home position and air density are handled by the companion work item
+		command_handler_update();
+		transition_table_update();
+		_vtol_type->check_air_density_change();
+
+		_profiler.mark(VtolProfiler::Phase::Polls);
 
 		_vtol_type->handleEkfResets();
 
@@ -393,8 +558,19 @@ VtolAttitudeControl::Run()
 		const bool mc_att_sp_updated = _mc_virtual_att_sp_sub.update(&_mc_virtual_att_sp);
 		const bool fw_att_sp_updated = _fw_virtual_att_sp_sub.update(&_fw_virtual_att_sp);
 
+		_profiler.mark(VtolProfiler::Phase::Setpoints);
+
 		// update the vtol state machine which decides which mode we are in
-		_vtol_type->update_vtol_state();
+		_vtol_type->update_vtol_state(cycle);
+
+		if (_vtol_type->get_mode() != mode_before) {
+			// the new mode may consume inputs the previous one did not, bring them up to date
+			const uint16_t missing_inputs = cycle_input_set(_vtol_type->get_mode()) & ~polled_inputs;
+			poll_inputs(missing_inputs);
+			polled_inputs |= missing_inputs;
+		}
+
+		_profiler.mark(VtolProfiler::Phase::StateMachine);
 
 		// check in which mode we are in and call mode specific functions
 		switch (_vtol_type->get_mode()) {
@@ -403,8 +579,8 @@ VtolAttitudeControl::Run()
 			_vtol_vehicle_status.vehicle_vtol_state = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_TRANSITION_TO_FW;
 
 			if (mc_att_sp_updated || fw_att_sp_updated) {
-				_vtol_type->update_transition_state();
-				_vehicle_attitude_sp_pub.publish(_vehicle_attitude_sp);
+				_vtol_type->update_transition_state(cycle);
+				publish(_vehicle_attitude_sp_pub, _vehicle_attitude_sp, PublishedTopic::AttitudeSetpoint);
 			}
 
 			break;
@@ -414,8 +590,8 @@ VtolAttitudeControl::Run()
 			_vtol_vehicle_status.vehicle_vtol_state = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_TRANSITION_TO_MC;
 
 			if (mc_att_sp_updated || fw_att_sp_updated) {
-				_vtol_type->update_transition_state();
-				_vehicle_attitude_sp_pub.publish(_vehicle_attitude_sp);
+				_vtol_type->update_transition_state(cycle);
+				publish(_vehicle_attitude_sp_pub, _vehicle_attitude_sp, PublishedTopic::AttitudeSetpoint);
 			}
 
 			break;
@@ -425,8 +601,8 @@ VtolAttitudeControl::Run()
 			_vtol_vehicle_status.vehicle_vtol_state = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_MC;
 
 			if (mc_att_sp_updated) {
-				_vtol_type->update_mc_state();
-				_vehicle_attitude_sp_pub.publish(_vehicle_attitude_sp);
+				_vtol_type->update_mc_state(cycle);
+				publish(_vehicle_attitude_sp_pub, _vehicle_attitude_sp, PublishedTopic::AttitudeSetpoint);
 			}
 
 			break;
@@ -436,50 +612,90 @@ VtolAttitudeControl::Run()
 			_vtol_vehicle_status.vehicle_vtol_state = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW;
 
 			if (fw_att_sp_updated) {
-				_vtol_type->update_fw_state();
-				_vehicle_attitude_sp_pub.publish(_vehicle_attitude_sp);
+				_vtol_type->update_fw_state(cycle);
+				publish(_vehicle_attitude_sp_pub, _vehicle_attitude_sp, PublishedTopic::AttitudeSetpoint);
 			}
 
 			break;
 		}
 
-		_vtol_type->fill_actuator_outputs();
+		_command_handler.set_vtol_mode(_vtol_type->get_mode());
 
-		_vehicle_torque_setpoint0_pub.publish(_torque_setpoint_0);
-		_vehicle_torque_setpoint1_pub.publish(_torque_setpoint_1);
-		_vehicle_thrust_setpoint0_pub.publish(_thrust_setpoint_0);
-		_vehicle_thrust_setpoint1_pub.publish(_thrust_setpoint_1);
+		_profiler.mark(VtolProfiler::Phase::ModeUpdate);
+
+		_vtol_type->fill_actuator_outputs(cycle);
+
+		_profiler.mark(VtolProfiler::Phase::ActuatorOutputs);
+
+		_io.out.torque_0.copy_to(_torque_setpoint_0, cycle.now);
+		_io.out.torque_1.copy_to(_torque_setpoint_1, cycle.now);
+		_io.out.thrust_0.copy_to(_thrust_setpoint_0, cycle.now);
+		_io.out.thrust_1.copy_to(_thrust_setpoint_1, cycle.now);
+
+		// the primary outputs drive the control allocation and are published on every cycle
+		publish(_vehicle_torque_setpoint0_pub, _torque_setpoint_0, PublishedTopic::TorqueSetpoint0);
+		publish(_vehicle_thrust_setpoint0_pub, _thrust_setpoint_0, PublishedTopic::ThrustSetpoint0);
+
+		// the secondary ones on every cycle if the type uses them. The allocation keeps the last value,
+		// so the cycle in which torque setpoint 1 becomes unused still publishes its neutral output.
+		const bool torque_setpoint_1_used = _vtol_type->uses_torque_setpoint_1();
+
+		if (torque_setpoint_1_used || _torque_setpoint_1_used) {
+			publish(_vehicle_torque_setpoint1_pub, _torque_setpoint_1, PublishedTopic::TorqueSetpoint1);
+
+		} else {
+			_publish_suppressed[static_cast<uint8_t>(PublishedTopic::TorqueSetpoint1)]++;
+		}
+
+		_torque_setpoint_1_used = torque_setpoint_1_used;
+
+		if (_vtol_type->uses_thrust_setpoint_1()) {
+			publish(_vehicle_thrust_setpoint1_pub, _thrust_setpoint_1, PublishedTopic::ThrustSetpoint1);
+
+		} else {
+			_publish_suppressed[static_cast<uint8_t>(PublishedTopic::ThrustSetpoint1)]++;
+		}
 
 		// Advertise/Publish vtol vehicle status
-		_vtol_vehicle_status.timestamp = hrt_absolute_time();
-		_vtol_vehicle_status_pub.publish(_vtol_vehicle_status);
+		_vtol_vehicle_status.timestamp = cycle.now;
+		publish_on_change(_vtol_vehicle_status_pub, _vtol_vehicle_status_published, _vtol_vehicle_status,
+				  PublishedTopic::VtolVehicleStatus, cycle.now);
 
 		// Publish flaps/spoiler setpoint with configured deflection in Hover if in Auto.
 		// In Manual always published in FW rate controller, and in Auto FW in FW Position Controller.
-		if (_vehicle_control_mode.flag_control_auto_enabled
+		if (_io.in.auto_control
 		    && _vtol_vehicle_status.vehicle_vtol_state != vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW) {
 
 			// flaps
-			normalized_unsigned_setpoint_s flaps_setpoint;
+			normalized_unsigned_setpoint_s flaps_setpoint{};
 			flaps_setpoint.normalized_setpoint = 0.f; // for now always set flaps to 0 in transitions and hover
-			flaps_setpoint.timestamp = hrt_absolute_time();
-			_flaps_setpoint_pub.publish(flaps_setpoint);
+			flaps_setpoint.timestamp = cycle.now;
+			publish_on_change(_flaps_setpoint_pub, _flaps_setpoint_published, flaps_setpoint, PublishedTopic::FlapsSetpoint,
+					  cycle.now);
 
 			// spoilers
 			float spoiler_control = 0.f;
 
-			if ((_pos_sp_triplet.current.valid && _pos_sp_triplet.current.type == position_setpoint_s::SETPOINT_TYPE_LAND) ||
-			    _vehicle_status.nav_state == vehicle_status_s::NAVIGATION_STATE_DESCEND) {
+			if (_io.in.landing_setpoint || _nav_state == vehicle_status_s::NAVIGATION_STATE_DESCEND) {
 				spoiler_control = _param_vt_spoiler_mc_ld.get();
 			}
 
-			normalized_unsigned_setpoint_s spoiler_setpoint;
+			normalized_unsigned_setpoint_s spoiler_setpoint{};
 			spoiler_setpoint.normalized_setpoint = spoiler_control;
-			spoiler_setpoint.timestamp = hrt_absolute_time();
-			_spoilers_setpoint_pub.publish(spoiler_setpoint);
+			spoiler_setpoint.timestamp = cycle.now;
+			publish_on_change(_spoilers_setpoint_pub, _spoilers_setpoint_published, spoiler_setpoint,
+					  PublishedTopic::SpoilersSetpoint, cycle.now);
+
+		} else {
+			// the FW controllers publish them meanwhile, publish right away when this branch is entered again
+			_flaps_setpoint_published.timestamp = 0;
+			_spoilers_setpoint_published.timestamp = 0;
 		}
+
+		_profiler.mark(VtolProfiler::Phase::Publish);
 	}
 
+	_profiler.end_cycle(should_run);
 	perf_end(_loop_perf);
 }
 
@@ -494,7 +710,13 @@ VtolAttitudeControl::Run()
 int
 VtolAttitudeControl::task_spawn(int argc, char *argv[])
 {
-	VtolAttitudeControl *instance = new VtolAttitudeControl();
+	return spawn(HrtClock::instance());
+}
+
+int
+VtolAttitudeControl::spawn(const VtolClock &clock)
+{
+	VtolAttitudeControl *instance = new VtolAttitudeControl(clock);
 
 	if (instance) {
 		_object.store(instance);
@@ -515,9 +737,375 @@ VtolAttitudeControl::task_spawn(int argc, char *argv[])
 	return PX4_ERROR;
 }
 
+/**
+ * @brief Returns the name of a published topic for status reporting.
+ */
+
+const char *
+VtolAttitudeControl::published_topic_name(PublishedTopic topic)
+{
+	switch (topic) {
+	case PublishedTopic::AttitudeSetpoint: return "vehicle_attitude_setpoint";
+
+	case PublishedTopic::TorqueSetpoint0: return "vehicle_torque_setpoint 0";
+
+	case PublishedTopic::TorqueSetpoint1: return "vehicle_torque_setpoint 1";
+
+	case PublishedTopic::ThrustSetpoint0: return "vehicle_thrust_setpoint 0";
+
+	case PublishedTopic::ThrustSetpoint1: return "vehicle_thrust_setpoint 1";
+
+	case PublishedTopic::VtolVehicleStatus: return "vtol_vehicle_status";
+
+	case PublishedTopic::FlapsSetpoint: return "flaps_setpoint";
+
+	case PublishedTopic::SpoilersSetpoint: return "spoilers_setpoint";
+
+	case PublishedTopic::Count: break;
+	}
+
+	return "unknown";
+}
+
+/**
+ * @brief Prints the current modes, loop timing, publish rates and run statistics.
+ *
+ * Publish rates are averaged since the previous status call.
+ *
+ * @return 0
+ */
+
+int
+VtolAttitudeControl::print_status()
+{
+	static const char *const common_mode_names[] = {"", "TRANSITION_TO_FW", "TRANSITION_TO_MC", "MC", "FW"};
+
+	if (_vtol_type != nullptr) {
+		PX4_INFO("mode: %s (%s)", common_mode_names[static_cast<int>(_vtol_type->get_mode())],
+			 _vtol_type->get_vtol_mode_name());
+	}
+
+#if VTOL_ATT_CONTROL_SPECIALIZED
+	PX4_INFO("vtol type storage: %zu bytes (single-airframe build)", sizeof(_vtol_type_storage));
+#else
+	PX4_INFO("vtol type storage: %zu bytes (standard %zu, tailsitter %zu, tiltrotor %zu)",
+		 sizeof(_vtol_type_storage), sizeof(Standard), sizeof(Tailsitter), sizeof(Tiltrotor));
+#endif
+	PX4_INFO("vtol io block: %zu bytes", sizeof(_io));
+
+	perf_print_counter(_loop_perf);
+	perf_print_counter(_loop_interval_perf);
+
+	const uint32_t runs = perf_event_count(_loop_interval_perf);
+	PX4_INFO("runs: %u, skipped (no input for mode): %u, rate limited: %u, redundant (transition, one input side): %u",
+		 (unsigned)runs, (unsigned)_runs_skipped, (unsigned)_runs_rate_limited, (unsigned)_runs_redundant);
+
+	PX4_INFO("command handler mailbox updates: %u", (unsigned)_command_handler.mailbox_updates());
+
+	if (_vtol_type != nullptr) {
+		PX4_INFO("derived parameters: generation %u (air density %.3f kg/m^3)", (unsigned)_vtol_type->derived_params_generation(),
+			 (double)_air_density);
+		PX4_INFO("front transition (%s): airspeed %.1f m/s, minimum %.1f s, open-loop %.1f s, timeout %.1f s",
+			 _vtol_type->transition_performance_measured() ? "measured table" : "analytic model",
+			 (double)_vtol_type->getTransitionAirspeed(), (double)_vtol_type->getMinimumFrontTransitionTime(),
+			 (double)_vtol_type->getOpenLoopFrontTransitionTime(), (double)_vtol_type->getFrontTransitionTimeout());
+		_vtol_type->print_quadchute_status();
+	}
+
+	PX4_INFO("transition input sync: %u matched, %u redundant runs eliminated, fallbacks: %u repeat, %u mismatch, %u timeout",
+		 (unsigned)_input_sync_matched, (unsigned)_input_sync_merged, (unsigned)_input_sync_fallback_repeat,
+		 (unsigned)_input_sync_fallback_mismatch, (unsigned)_input_sync_fallback_timeout);
+
+	if (_vtol_type != nullptr) {
+		const hrt_abstime interval = _min_run_interval[mode_index(_vtol_type->get_mode())];
+
+		if (interval > 0) {
+			PX4_INFO("rate limit in current mode: %.0f Hz", (double)(1e6f / interval));
+		}
+	}
+
+	const hrt_abstime now = _clock.now();
+	const float window = (_publish_count_start > 0 && now > _publish_count_start) ? (now - _publish_count_start) * 1e-6f : 0.f;
+
+	if (window > 0.f) {
+		PX4_INFO("publish rates over the last %.1f s:", (double)window);
+
+		for (uint8_t i = 0; i < static_cast<uint8_t>(PublishedTopic::Count); i++) {
+			PX4_INFO_RAW("  %-26s %7.1f Hz (%.1f Hz suppressed)\n", published_topic_name(static_cast<PublishedTopic>(i)),
+				     (double)(_publish_count[i] / window), (double)(_publish_suppressed[i] / window));
+		}
+	}
+
+	for (uint32_t &count : _publish_count) {
+		count = 0;
+	}
+
+	for (uint32_t &count : _publish_suppressed) {
+		count = 0;
+	}
+
+	if (window > 0.f) {
+		PX4_INFO("input topic polls: %.1f /s, saved by the mode input sets: %.1f /s", (double)(_input_polls / window),
+			 (double)((_input_polls_possible - _input_polls) / window));
+	}
+
+	if (window > 0.f) {
+		PX4_INFO("input messages: %.0f B/s read through a %zu byte staging buffer (replaces %zu bytes of per-topic copies)",
+			 (double)(_input_bytes_read / window), sizeof(_input_staging), kInputMessageCopiesSize);
+	}
+
+	_input_polls = 0;
+	_input_polls_possible = 0;
+	_input_bytes_read = 0;
+
+	_publish_count_start = now;
+
+	_profiler.print();
+
+	if (_profiler.enabled()) {
+		PX4_INFO_RAW("cycle histogram:\n");
+		VtolProfiler::print_histogram(_profiler.cycle_stats());
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Starts and stops the bench window on request of the shell, runs on the work queue.
+ */
+
+void
+VtolAttitudeControl::bench_handle_request()
+{
+	switch (static_cast<BenchState>(_bench_state.load())) {
+	case BenchState::StartRequested:
+		_bench_restore_profiler = _profiler.enabled();
+		_profiler.set_enabled(false);
+		_profiler.set_enabled(true); // start with a clean window
+		_bench_state.store(static_cast<int>(BenchState::Running));
+		break;
+
+	case BenchState::StopRequested:
+		_bench_stats = _profiler.cycle_stats();
+		_bench_noop_runs = _profiler.noop_stats().count;
+		_profiler.set_enabled(_bench_restore_profiler);
+		_bench_state.store(static_cast<int>(BenchState::Done));
+		break;
+
+	case BenchState::Cancelled:
+		_profiler.set_enabled(_bench_restore_profiler);
+		_bench_state.store(static_cast<int>(BenchState::Idle));
+		break;
+
+	default:
+		break;
+	}
+}
+
+int
+VtolAttitudeControl::bench(float duration)
+{
+	static constexpr hrt_abstime kAckTimeout = 500_ms;
+	static constexpr unsigned kAckPollInterval = 10_ms;
+
+	int expected = static_cast<int>(BenchState::Idle);
+
+	if (!_bench_state.compare_exchange(&expected, static_cast<int>(BenchState::StartRequested))) {
+		if (static_cast<BenchState>(expected) == BenchState::Cancelled) {
+			PX4_ERR("previous bench window not closed yet (controller not cycling)");
+
+		} else {
+			PX4_ERR("bench already running");
+		}
+
+		return 1;
+	}
+
+	const auto wait_for = [this](BenchState state) {
+		// the shell waits in wall-clock time, the controller may run on simulated time
+		const hrt_abstime start = measurement_time_us();
+
+		while (static_cast<BenchState>(_bench_state.load()) != state) {
+			if (measurement_time_us() - start > kAckTimeout) {
+				return false;
+			}
+
+			px4_usleep(kAckPollInterval);
+		}
+
+		return true;
+	};
+
+	if (!wait_for(BenchState::Running)) {
+		// withdraw the request unless the controller has just taken it, then measure anyway
+		expected = static_cast<int>(BenchState::StartRequested);
+
+		if (_bench_state.compare_exchange(&expected, static_cast<int>(BenchState::Idle))) {
+			PX4_ERR("controller not running (no virtual setpoints)");
+			return 1;
+		}
+	}
+
+	PX4_INFO("measuring for %.1f s", (double)duration);
+	px4_usleep(static_cast<unsigned>(duration * 1e6f));
+
+	_bench_state.store(static_cast<int>(BenchState::StopRequested));
+
+	if (!wait_for(BenchState::Done)) {
+		// the controller stopped cycling during the window, it closes the window on its next run
+		// unless it has just done so
+		expected = static_cast<int>(BenchState::StopRequested);
+
+		if (_bench_state.compare_exchange(&expected, static_cast<int>(BenchState::Cancelled))) {
+			PX4_ERR("controller stopped cycling, no result");
+			return 1;
+		}
+	}
+
+	const VtolProfiler::Stats &stats = _bench_stats;
+	_bench_state.store(static_cast<int>(BenchState::Idle));
+
+	if (stats.count == 0) {
+		PX4_WARN("no cycles measured");
+		return 1;
+	}
+
+	// percentiles over the executed cycles, the no-op runs would bias them low
+	PX4_INFO("%u cycles (%.1f Hz), cycle cost [us]: mean %.1f, p50 %u, p99 %u, max %u", (unsigned)stats.count,
+		 (double)(stats.count / duration), (double)stats.mean_us(), (unsigned)stats.percentile_us(50.f),
+		 (unsigned)stats.percentile_us(99.f), (unsigned)stats.max_us);
+	PX4_INFO("%u runs without a cycle (no input for the mode, merged or rate limited) not included",
+		 (unsigned)_bench_noop_runs);
+
+	return 0;
+}
+
+/**
+ * @brief Runs a requested quadchute replay between two cycles, runs on the work queue.
+ */
+
+void
+VtolAttitudeControl::replay_handle_request()
+{
+	if (static_cast<ReplayState>(_replay_state.load()) != ReplayState::Requested) {
+		return;
+	}
+
+	if (_io.in.armed) {
+		_replay_state.store(static_cast<int>(ReplayState::Refused));
+		return;
+	}
+
+	_vtol_type->replayQuadchute(_replay_horizon, _replay_report);
+	_replay_state.store(static_cast<int>(ReplayState::Done));
+}
+
+int
+VtolAttitudeControl::quadchute_replay(float horizon)
+{
+	static constexpr hrt_abstime kTimeout = 2_s;
+	static constexpr unsigned kPollInterval = 10_ms;
+
+	int expected = static_cast<int>(ReplayState::Idle);
+
+	if (!_replay_state.compare_exchange(&expected, static_cast<int>(ReplayState::Claimed))) {
+		PX4_ERR("replay already running");
+		return 1;
+	}
+
+	_replay_horizon = horizon;
+	_replay_state.store(static_cast<int>(ReplayState::Requested));
+
+	// the shell waits in wall-clock time, the controller may run on simulated time
+	const hrt_abstime start = measurement_time_us();
+	ReplayState state;
+
+	while ((state = static_cast<ReplayState>(_replay_state.load())) == ReplayState::Requested) {
+		if (measurement_time_us() - start > kTimeout) {
+			// withdraw the request unless the controller has just taken it
+			expected = static_cast<int>(ReplayState::Requested);
+
+			if (_replay_state.compare_exchange(&expected, static_cast<int>(ReplayState::Idle))) {
+				PX4_ERR("controller not running (no virtual setpoints)");
+				return 1;
+			}
+		}
+
+		px4_usleep(kPollInterval);
+	}
+
+	const quadchute_replay::Report report = _replay_report;
+	_replay_state.store(static_cast<int>(ReplayState::Idle));
+
+	if (state == ReplayState::Refused) {
+		PX4_ERR("vehicle armed, replay refused");
+		return 1;
+	}
+
+	if (report.horizon > 0.f) {
+		PX4_INFO("look-ahead %.2f s, enabled checks and limits of the vehicle", (double)report.horizon);
+
+	} else {
+		PX4_INFO("no look-ahead checks enabled (VT_QC_LOOKAHEAD), enabled checks and limits of the vehicle");
+	}
+
+	PX4_INFO("scenario         current [ms]  look-ahead [ms]  earlier [ms]");
+
+	const float step_ms = 1e3f / quadchute_replay::kRate;
+
+	for (int i = 0; i < quadchute_replay::kNumScenarios; i++) {
+		const char *name = quadchute_replay::kScenarios[i].name;
+		const int current_step = report.current_step[i];
+		const int lookahead_step = report.lookahead_step[i];
+
+		if (current_step >= 0) {
+			PX4_INFO("%-15s  %12.0f  %15.0f  %12.0f", name, (double)(current_step * step_ms),
+				 (double)(lookahead_step * step_ms), (double)((current_step - lookahead_step) * step_ms));
+
+		} else if (lookahead_step >= 0) {
+			PX4_INFO("%-15s  %12s  %15.0f  false trigger", name, "-", (double)(lookahead_step * step_ms));
+
+		} else {
+			PX4_INFO("%-15s  %12s  %15s", name, "-", "-");
+		}
+	}
+
+	return 0;
+}
+
 int
 VtolAttitudeControl::custom_command(int argc, char *argv[])
 {
+	if (!strcmp(argv[0], "trig_bench")) {
+		// runs in the shell thread, does not need the controller
+		fast_trig::benchmark();
+		return 0;
+	}
+
+	if (!is_running()) {
+		PX4_INFO("not running");
+		return 1;
+	}
+
+	if (!strcmp(argv[0], "quadchute_replay")) {
+		const float horizon = argc > 1 ? strtof(argv[1], nullptr) : 0.f;
+		return get_instance()->quadchute_replay(horizon);
+	}
+
+	if (!strcmp(argv[0], "bench")) {
+		float duration = 5.f;
+
+		if (argc > 1) {
+			duration = strtof(argv[1], nullptr);
+		}
+
+		if (!(duration > 0.f && duration <= 60.f)) {
+			return print_usage("bench duration must be in (0, 60] s");
+		}
+
+		return get_instance()->bench(duration);
+	}
+
 	return print_usage("unknown command");
 }
 
@@ -536,6 +1124,11 @@ fw_att_control is the fixed wing attitude controller.
 
 	PRINT_MODULE_USAGE_COMMAND("start");
 	PRINT_MODULE_USAGE_NAME("vtol_att_control", "controller");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("bench", "Measure the cycle cost (p50/p99/max) over a time window");
+	PRINT_MODULE_USAGE_ARG("<seconds>", "Window length (default 5 s)", true);
+	PRINT_MODULE_USAGE_COMMAND_DESCR("trig_bench", "Compare the fast trigonometry kernels against libm (max error, time per call)");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("quadchute_replay", "Replay scripted failures through the quadchute checks (disarmed only), report how much earlier the look-ahead checks trigger");
+	PRINT_MODULE_USAGE_ARG("<seconds>", "Look-ahead time (default VT_QC_LOOKAHEAD)", true);
 	PRINT_MODULE_USAGE_DEFAULT_COMMANDS();
 
 	return 0;
@@ -1,5 +1,4 @@
 
- */
 
 #pragma once
 
@@ -18,50 +17,99 @@
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionCallback.hpp>
-#include <uORB/topics/action_request.h>
 #include <uORB/topics/airspeed_validated.h>
-#include <uORB/topics/home_position.h>
 #include <uORB/topics/normalized_unsigned_setpoint.h>
-#include <uORB/topics/vehicle_air_data.h>
 #include <uORB/topics/parameter_update.h>
 #include <uORB/topics/position_setpoint_triplet.h>
 #include <uORB/topics/tecs_status.h>
 #include <uORB/topics/vehicle_attitude.h>
 #include <uORB/topics/vehicle_attitude_setpoint.h>
-#include <uORB/topics/vehicle_command.h>
-#include <uORB/topics/vehicle_command_ack.h>
 #include <uORB/topics/vehicle_control_mode.h>
 #include <uORB/topics/vehicle_land_detected.h>
 #include <uORB/topics/vehicle_local_position.h>
-#include <uORB/topics/vehicle_local_position_setpoint.h>
 #include <uORB/topics/vtol_vehicle_status.h>
-#include <uORB/topics/vehicle_status.h>
 #include <uORB/topics/vehicle_thrust_setpoint.h>
 #include <uORB/topics/vehicle_torque_setpoint.h>
+
+#include <new>
+#include <stddef.h>
+#include <string.h>
+
+#include "vtol_type_config.h"
+
+#if VTOL_ATT_CONTROL_HAS_STANDARD
 #include "standard.h"
+#endif
+#if VTOL_ATT_CONTROL_HAS_TAILSITTER
 #include "tailsitter.h"
+#endif
+#if VTOL_ATT_CONTROL_HAS_TILTROTOR
 #include "tiltrotor.h"
+#endif
+
+#include "vtol_clock.h"
+#include "vtol_command_handler.h"
+#include "vtol_profiler.h"
 
 using namespace time_literals;
 
 extern "C" __EXPORT int vtol_att_control_main(int argc, char *argv[]);
 
+// type called by the controller: the concrete (final) type in a single-airframe build, so the calls are direct
+#if VTOL_ATT_CONTROL_SPECIALIZED && VTOL_ATT_CONTROL_HAS_TAILSITTER
+using VtolTypeImpl = Tailsitter;
+#elif VTOL_ATT_CONTROL_SPECIALIZED && VTOL_ATT_CONTROL_HAS_TILTROTOR
+using VtolTypeImpl = Tiltrotor;
+#elif VTOL_ATT_CONTROL_SPECIALIZED && VTOL_ATT_CONTROL_HAS_STANDARD
+using VtolTypeImpl = Standard;
+#else
+using VtolTypeImpl = VtolType;
+#endif
+
 class VtolAttitudeControl : public ModuleBase<VtolAttitudeControl>, public ModuleParams, public px4::WorkItem
 {
 public:
 
-	VtolAttitudeControl();
+	/**
+	 * @param clock time source of the controller, the high-resolution timer on the vehicle
+	 */
+	explicit VtolAttitudeControl(const VtolClock &clock = HrtClock::instance());
 	~VtolAttitudeControl() override;
 
 	/** @see ModuleBase */
 	static int task_spawn(int argc, char *argv[]);
 
+	/**
+	 * Start the module on the given clock, task_spawn() uses the hrt. A batch simulation passes a
+	 * ManualClock that outlives the module.
+	 */
+	static int spawn(const VtolClock &clock);
+
 	/** @see ModuleBase */
 	static int custom_command(int argc, char *argv[]);
 
 	/** @see ModuleBase */
 	static int print_usage(const char *reason = nullptr);
 
+	/** @see ModuleBase::print_status() */
+	int print_status() override;
+
+	/**
+	 * Measure the cycle cost of the running controller over a time window.
+	 *
+	 * @param duration window length [s]
+	 * @return 0 on success
+	 */
+	int bench(float duration);
+
+	/**
+	 * Replay the scripted quadchute failures through the checks of the running controller, only while disarmed.
+	 *
+	 * @param horizon Look-ahead time [s], VT_QC_LOOKAHEAD if not positive
+	 * @return 0 on success
+	 */
+	int quadchute_replay(float horizon);
+
 	bool init();
 
 	bool is_fixed_wing_requested() { return _transition_command == vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW; };
@@ -76,29 +124,15 @@ public:
 
 	float getAirDensity() const { return _air_density; }
 
-	struct vehicle_torque_setpoint_s		*get_vehicle_torque_setpoint_virtual_mc() {return &_vehicle_torque_setpoint_virtual_mc;}
-	struct vehicle_torque_setpoint_s		*get_vehicle_torque_setpoint_virtual_fw() {return &_vehicle_torque_setpoint_virtual_fw;}
-	struct vehicle_thrust_setpoint_s		*get_vehicle_thrust_setpoint_virtual_mc() {return &_vehicle_thrust_setpoint_virtual_mc;}
-	struct vehicle_thrust_setpoint_s		*get_vehicle_thrust_setpoint_virtual_fw() {return &_vehicle_thrust_setpoint_virtual_fw;}
-
-	struct airspeed_validated_s 			*get_airspeed() {return &_airspeed_validated;}
-	struct position_setpoint_triplet_s		*get_pos_sp_triplet() {return &_pos_sp_triplet;}
-	struct tecs_status_s 				*get_tecs_status() {return &_tecs_status;}
-	struct vehicle_attitude_s 			*get_att() {return &_vehicle_attitude;}
+	VtolIo						*get_io() {return &_io;}
 	struct vehicle_attitude_setpoint_s		*get_att_sp() {return &_vehicle_attitude_sp;}
 	struct vehicle_attitude_setpoint_s 		*get_fw_virtual_att_sp() {return &_fw_virtual_att_sp;}
 	struct vehicle_attitude_setpoint_s 		*get_mc_virtual_att_sp() {return &_mc_virtual_att_sp;}
-	struct vehicle_control_mode_s 			*get_control_mode() {return &_vehicle_control_mode;}
-	struct vehicle_land_detected_s			*get_land_detected() {return &_land_detected;}
-	struct vehicle_local_position_s 		*get_local_pos() {return &_local_pos;}
-	struct vehicle_local_position_setpoint_s	*get_local_pos_sp() {return &_local_pos_sp;}
-	struct vehicle_torque_setpoint_s 		*get_torque_setpoint_0() {return &_torque_setpoint_0;}
-	struct vehicle_torque_setpoint_s 		*get_torque_setpoint_1() {return &_torque_setpoint_1;}
-	struct vehicle_thrust_setpoint_s 		*get_thrust_setpoint_0() {return &_thrust_setpoint_0;}
-	struct vehicle_thrust_setpoint_s 		*get_thrust_setpoint_1() {return &_thrust_setpoint_1;}
 	struct vtol_vehicle_status_s			*get_vtol_vehicle_status() {return &_vtol_vehicle_status;}
 	float get_home_position_z() { return _home_position_z; }
 
+	const VtolClock &clock() const { return _clock; }
+
 private:
 	void Run() override;
 	uORB::SubscriptionCallbackWorkItem _vehicle_torque_setpoint_virtual_fw_sub{this, ORB_ID(vehicle_torque_setpoint_virtual_fw)};
@@ -108,21 +142,15 @@ private:
 
 	uORB::SubscriptionInterval _parameter_update_sub{ORB_ID(parameter_update), 1_s};
 
-	uORB::Subscription _action_request_sub{ORB_ID(action_request)};
 	uORB::Subscription _airspeed_validated_sub{ORB_ID(airspeed_validated)};
 	uORB::Subscription _fw_virtual_att_sp_sub{ORB_ID(fw_virtual_attitude_setpoint)};
-	uORB::Subscription _home_position_sub{ORB_ID(home_position)};
 	uORB::Subscription _land_detected_sub{ORB_ID(vehicle_land_detected)};
-	uORB::Subscription _local_pos_sp_sub{ORB_ID(vehicle_local_position_setpoint)};
 	uORB::Subscription _local_pos_sub{ORB_ID(vehicle_local_position)};
 	uORB::Subscription _mc_virtual_att_sp_sub{ORB_ID(mc_virtual_attitude_setpoint)};
 	uORB::Subscription _pos_sp_triplet_sub{ORB_ID(position_setpoint_triplet)};
 	uORB::Subscription _tecs_status_sub{ORB_ID(tecs_status)};
-	uORB::Subscription _vehicle_air_data_sub{ORB_ID(vehicle_air_data)};
 	uORB::Subscription _vehicle_attitude_sub{ORB_ID(vehicle_attitude)};
 	uORB::Subscription _vehicle_control_mode_sub{ORB_ID(vehicle_control_mode)};
-	uORB::Subscription _vehicle_cmd_sub{ORB_ID(vehicle_command)};
-	uORB::Subscription _vehicle_status_sub{ORB_ID(vehicle_status)};
 
 	uORB::Publication<normalized_unsigned_setpoint_s>	_flaps_setpoint_pub{ORB_ID(flaps_setpoint)};
 	uORB::Publication<normalized_unsigned_setpoint_s>	_spoilers_setpoint_pub{ORB_ID(spoilers_setpoint)};
@@ -139,33 +167,47 @@ private:
 	vehicle_attitude_setpoint_s 		_fw_virtual_att_sp{};	// virtual fw attitude setpoint
 	vehicle_attitude_setpoint_s 		_mc_virtual_att_sp{};	// virtual mc attitude setpoint
 
-	vehicle_torque_setpoint_s		_vehicle_torque_setpoint_virtual_mc{};
-	vehicle_torque_setpoint_s		_vehicle_torque_setpoint_virtual_fw{};
-	vehicle_thrust_setpoint_s		_vehicle_thrust_setpoint_virtual_mc{};
-	vehicle_thrust_setpoint_s		_vehicle_thrust_setpoint_virtual_fw{};
+	VtolIo					_io{};	// compact copy of the fields the VTOL types use, and their outputs
+
+	/**
+	 * Staging buffer of the input topics. A message is read into it and only the fields
+	 * used are kept in _io, so no full copy per topic is held.
+	 */
+	union InputStaging {
+		airspeed_validated_s		airspeed;
+		position_setpoint_triplet_s	pos_sp_triplet;
+		tecs_status_s			tecs_status;
+		vehicle_attitude_s		attitude;
+		vehicle_control_mode_s		control_mode;
+		vehicle_land_detected_s		land_detected;
+		vehicle_local_position_s	local_pos;
+		vehicle_thrust_setpoint_s	thrust;
+		vehicle_torque_setpoint_s	torque;
+	} _input_staging{};
+
+	// per-topic copies the staging buffer replaces (4 virtual setpoints and the polled inputs), for status reporting
+	static constexpr size_t kInputMessageCopiesSize = 2 * sizeof(vehicle_torque_setpoint_s) + 2 * sizeof(
+				vehicle_thrust_setpoint_s) + sizeof(airspeed_validated_s) + sizeof(position_setpoint_triplet_s) + sizeof(
+				tecs_status_s) + sizeof(vehicle_attitude_s) + sizeof(vehicle_control_mode_s) + sizeof(vehicle_land_detected_s)
+			+ sizeof(vehicle_local_position_s);
 
 	vehicle_torque_setpoint_s		_torque_setpoint_0{};
 	vehicle_torque_setpoint_s		_torque_setpoint_1{};
 	vehicle_thrust_setpoint_s		_thrust_setpoint_0{};
 	vehicle_thrust_setpoint_s		_thrust_setpoint_1{};
 
-	airspeed_validated_s 			_airspeed_validated{};
-	position_setpoint_triplet_s		_pos_sp_triplet{};
-	tecs_status_s				_tecs_status{};
-	vehicle_attitude_s			_vehicle_attitude{};
-	vehicle_control_mode_s			_vehicle_control_mode{};
-	vehicle_land_detected_s			_land_detected{};
-	vehicle_local_position_s		_local_pos{};
-	vehicle_local_position_setpoint_s	_local_pos_sp{};
-	vehicle_status_s 			_vehicle_status{};
 	vtol_vehicle_status_s 			_vtol_vehicle_status{};
 	float _home_position_z{NAN};
 
 	float _air_density{atmosphere::kAirDensitySeaLevelStandardAtmos};	// [kg/m^3]
 
-#if !defined(ENABLE_LOCKSTEP_SCHEDULER)
-	hrt_abstime _last_run_timestamp {0};
-#endif // !ENABLE_LOCKSTEP_SCHEDULER
+	static constexpr int kNumModes = 4;
+
+	static constexpr int mode_index(mode m) { return static_cast<int>(m) - static_cast<int>(mode::TRANSITION_TO_FW); }
+
+	hrt_abstime	_min_run_interval[kNumModes] {};	// minimum time between two cycles per mode (VT_RATE_*), 0: no limit
+
+	hrt_abstime	_last_cycle_timestamp{0};	// time of the last executed cycle
 
 	/* For multicopters it is usual to have a non-zero idle speed of the engines
 	 * for fixed wings we want to have an idle speed of zero since we do not want
@@ -173,24 +215,211 @@ private:
 	int		_transition_command{vtol_vehicle_status_s::VEHICLE_VTOL_STATE_MC};
 	bool		_immediate_transition{false};
 
-	uint8_t _nav_state_prev;
+	uint8_t		_nav_state{0};			// navigation state from vehicle_status (via the command handler)
 
-	VtolType	*_vtol_type{nullptr};	// base class for different vtol types
+	uint32_t	_immediate_transition_count{0};	// last immediate transition command applied
+	uint32_t	_fw_failure_reset_count{0};	// last fixed-wing failure reset applied
+
+	const VtolClock		&_clock;		// the only time source, read once per cycle
+
+	VtolCommandHandler	_command_handler{_clock};	// slow-path status/command handling on lp_default
+
+#if VTOL_ATT_CONTROL_SPECIALIZED
+	static constexpr size_t kVtolTypeStorageSize = sizeof(VtolTypeImpl);
+	static constexpr size_t kVtolTypeStorageAlign = alignof(VtolTypeImpl);
+#else
+	static constexpr size_t kVtolTypeStorageSize = math::max(sizeof(Standard), math::max(sizeof(Tailsitter),
+			sizeof(Tiltrotor)));
+	static constexpr size_t kVtolTypeStorageAlign = math::max(alignof(Standard), math::max(alignof(Tailsitter),
+			alignof(Tiltrotor)));
+#endif
+
+	// storage of the VTOL type object (placement constructed for VT_TYPE), sized for the largest type
+	alignas(kVtolTypeStorageAlign) uint8_t _vtol_type_storage[kVtolTypeStorageSize];
+
+	VtolTypeImpl	*_vtol_type{nullptr};	// the vtol type, points into _vtol_type_storage
 
 	bool		_initialized{false};
 
 	perf_counter_t	_loop_perf;		// loop performance counter
+	perf_counter_t	_loop_interval_perf;	// interval between consecutive Run() calls
+
+	VtolProfiler	_profiler;		// per-phase cycle profiler, enabled with VT_PROF_EN
+
+	// topics published by the controller, for publish rate reporting
+	enum class PublishedTopic : uint8_t {
+		AttitudeSetpoint = 0,
+		TorqueSetpoint0,
+		TorqueSetpoint1,
+		ThrustSetpoint0,
+		ThrustSetpoint1,
+		VtolVehicleStatus,
+		FlapsSetpoint,
+		SpoilersSetpoint,
+		Count
+	};
+
+	uint32_t	_publish_count[static_cast<uint8_t>(PublishedTopic::Count)] {};
+	uint32_t	_publish_suppressed[static_cast<uint8_t>(PublishedTopic::Count)] {};	// unchanged or unused outputs not published
+	hrt_abstime	_publish_count_start{0};	// start of the publish rate window, reset by print_status()
+
+	uint32_t	_input_polls{0};		// input topic polls since the last status, see poll_inputs()
+	uint32_t	_input_polls_possible{0};	// polls if every input had been copied on every cycle
+	uint32_t	_input_bytes_read{0};		// input message bytes read since the last status, see read_input()
+
+	uint32_t	_runs_skipped{0};	// Run() calls without a new input for the current mode
+	uint32_t	_runs_rate_limited{0};	// cycles dropped by the per-mode rate limit
+	uint32_t	_runs_redundant{0};	// transition cycles computed with only one of the MC/FW inputs updated
+
+	// transition input synchronization, MC and FW virtual setpoints are matched by timestamp_sample
+	enum InputBits : uint8_t {
+		INPUT_MC_TORQUE = (1 << 0),
+		INPUT_MC_THRUST = (1 << 1),
+		INPUT_FW_TORQUE = (1 << 2),
+		INPUT_FW_THRUST = (1 << 3),
+		INPUT_MC = INPUT_MC_TORQUE | INPUT_MC_THRUST,
+		INPUT_FW = INPUT_FW_TORQUE | INPUT_FW_THRUST,
+		INPUT_ALL = INPUT_MC | INPUT_FW
+	};
+
+	static constexpr hrt_abstime kInputSyncTimeout = 2_ms;	// maximum wait for an incomplete input set
+
+	uint8_t		_pending_inputs{0};		// inputs updated since the last transition cycle (InputBits)
+	hrt_abstime	_pending_inputs_since{0};	// time the first pending input arrived
+	uint8_t		_synced_inputs{0};		// input set the last transition cycle ran on (InputBits)
+
+	uint32_t	_input_sync_matched{0};		// cycles run on a complete, timestamp matched set
+	uint32_t	_input_sync_merged{0};		// redundant runs eliminated by waiting for the set
+	uint32_t	_input_sync_fallback_repeat{0};	// cycles run because an input updated twice (other side slow/missing)
+	uint32_t	_input_sync_fallback_mismatch{0};	// cycles run on a complete set with different samples
+	uint32_t	_input_sync_fallback_timeout{0};	// cycles run because the wait timed out
+
+	// 'bench' handshake between the shell and the work queue thread, only the work queue touches the profiler
+	enum class BenchState : int {
+		Idle = 0,
+		StartRequested,
+		Running,
+		StopRequested,
+		Done,
+		Cancelled	// shell gave up waiting for the stop, the work queue restores the profiler
+	};
+
+	px4::atomic<int>	_bench_state{static_cast<int>(BenchState::Idle)};
+	bool			_bench_restore_profiler{false};	// profiler state to restore after the bench window
+	VtolProfiler::Stats	_bench_stats{};			// executed cycle statistics of the last bench window
+	uint32_t		_bench_noop_runs{0};		// runs without a cycle in the last bench window
+
+	// 'quadchute_replay' handshake between the shell and the work queue thread
+	enum class ReplayState : int {
+		Idle = 0,
+		Claimed,	// by a shell, setting up the request
+		Requested,
+		Done,
+		Refused		// armed
+	};
+
+	px4::atomic<int>	_replay_state{static_cast<int>(ReplayState::Idle)};
+	float			_replay_horizon{0.f};		// set by the shell before the request
+	quadchute_replay::Report _replay_report{};		// written by the work queue thread before Done
+
+	template<typename T, typename P>
+	void publish(P &pub, const T &msg, PublishedTopic topic)
+	{
+		pub.publish(msg);
+		_publish_count[static_cast<uint8_t>(topic)]++;
+	}
+
+	// last published content of a change-driven output
+	template<typename T>
+	struct PublishedContent {
+		T msg{};
+		hrt_abstime timestamp{0};	// 0: never published
+	};
+
+	// compare two messages without their timestamps
+	template<typename T>
+	static bool same_content(const T &a, const T &b)
+	{
+		static_assert(offsetof(T, timestamp) == 0, "timestamp must be the first field");
+		static constexpr size_t kContentOffset = sizeof(a.timestamp);
+
+		return memcmp(reinterpret_cast<const uint8_t *>(&a) + kContentOffset,
+			      reinterpret_cast<const uint8_t *>(&b) + kContentOffset, sizeof(T) - kContentOffset) == 0;
+	}
+
+	/**
+	 * Publish only if the content changed, or if the heartbeat interval (VT_PUB_HB)
+	 * elapsed since the last publication.
+	 */
+	template<typename T, typename P>
+	void publish_on_change(P &pub, PublishedContent<T> &last, const T &msg, PublishedTopic topic, hrt_abstime now)
+	{
+		const bool heartbeat_due = _publish_heartbeat == 0 || last.timestamp == 0 || now - last.timestamp >= _publish_heartbeat;
+
+		if (!heartbeat_due && same_content(msg, last.msg)) {
+			_publish_suppressed[static_cast<uint8_t>(topic)]++;
+			return;
+		}
+
+		publish(pub, msg, topic);
+		last.msg = msg;
+		last.timestamp = now;
+	}
+
+	hrt_abstime	_publish_heartbeat{0};	// heartbeat interval of change-driven outputs (VT_PUB_HB), 0: every cycle
+
+	bool		_torque_setpoint_1_used{true};	// the type used torque setpoint 1 in the previous cycle
+
+	PublishedContent<vtol_vehicle_status_s>		_vtol_vehicle_status_published{};
+	PublishedContent<normalized_unsigned_setpoint_s>	_flaps_setpoint_published{};
+	PublishedContent<normalized_unsigned_setpoint_s>	_spoilers_setpoint_published{};
+
+	static const char *published_topic_name(PublishedTopic topic);
+
+	void		bench_handle_request();
+	void		replay_handle_request();
 
-	void		vehicle_status_poll();
+	void 		parameters_update();
 
-	void		action_request_poll();
+	void		command_handler_update();
+	void		transition_table_update();
 
-	void		vehicle_cmd_poll();
+	void		update_min_run_intervals();
 
-	void 		parameters_update();
+	uint16_t	cycle_input_set(mode vtol_mode) const;
+
+	void		poll_inputs(uint16_t inputs);
+
+	/**
+	 * Read an updated message into the staging buffer and keep the fields used.
+	 *
+	 * @param sub subscription of the topic
+	 * @param staging member of _input_staging matching the topic
+	 * @param sink receives the fields used (VtolInputs or VtolSetpointSample)
+	 * @return true if the topic was updated
+	 */
+	template<typename S, typename T, typename Sink>
+	bool read_input(S &sub, T &staging, Sink &sink)
+	{
+		if (sub.update(&staging)) {
+			sink.update(staging);
+			_input_bytes_read += sizeof(T);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool		transition_inputs_synchronized(uint8_t updated_inputs, hrt_abstime now);
 
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::VT_TYPE>) _param_vt_type,
-		(ParamFloat<px4::params::VT_SPOILER_MC_LD>) _param_vt_spoiler_mc_ld
+		(ParamFloat<px4::params::VT_SPOILER_MC_LD>) _param_vt_spoiler_mc_ld,
+		(ParamBool<px4::params::VT_PROF_EN>) _param_vt_prof_en,
+		(ParamFloat<px4::params::VT_RATE_MC>) _param_vt_rate_mc,
+		(ParamFloat<px4::params::VT_RATE_FW>) _param_vt_rate_fw,
+		(ParamFloat<px4::params::VT_RATE_F_TRANS>) _param_vt_rate_f_trans,
+		(ParamFloat<px4::params::VT_RATE_B_TRANS>) _param_vt_rate_b_trans,
+		(ParamFloat<px4::params::VT_PUB_HB>) _param_vt_pub_hb
 	)
 };
@@ -186,6 +186,47 @@ PARAM_DEFINE_FLOAT(VT_QC_ALT_LOSS, 0.0f);
  */
 PARAM_DEFINE_FLOAT(VT_QC_T_ALT_LOSS, 20.0f);
 
+/**
+ * Quad-chute altitude window
+ *
+ * Time window of the uncommanded descent and transition altitude loss checks.
+ * If set, the uncommanded descent check triggers once the altitude has stayed more than VT_QC_ALT_LOSS
+ * below the TECS altitude reference over the whole window and is still decreasing, and the transition
+ * altitude loss check once it has stayed more than VT_QC_T_ALT_LOSS below the altitude at the start of
+ * the transition over the whole window. Longer windows reject more altitude noise but delay the
+ * detection by up to the window length.
+ *
+ * Set to 0 to compare the current altitude against the thresholds instead.
+ *
+ * @unit s
+ * @min 0
+ * @max 30
+ * @increment 0.5
+ * @decimal 1
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_QC_WINDOW, 0.0f);
+
+/**
+ * Quad-chute look-ahead time
+ *
+ * If set, the minimum altitude, transition altitude loss, pitch and roll quad-chute checks are
+ * also evaluated on the state projected this far ahead: the altitude with the current vertical
+ * speed and acceleration, the attitude with its current rate. The quad-chute then triggers before
+ * the threshold is actually crossed, at the cost of more false triggers on noisy estimates.
+ * The uncommanded descent check is not projected.
+ *
+ * Set to 0 to disable.
+ *
+ * @unit s
+ * @min 0
+ * @max 1
+ * @increment 0.05
+ * @decimal 2
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_QC_LOOKAHEAD, 0.0f);
+
 /**
  * Quad-chute max pitch threshold
  *
@@ -324,6 +365,44 @@ PARAM_DEFINE_FLOAT(VT_B_DEC_I, 0.1f);
  */
 PARAM_DEFINE_FLOAT(VT_PITCH_MIN, -5.0f);
 
+/**
+ * Use fixed-wing actuation in hover to accelerate forward
+ *
+ * This feature can be used to avoid the plane having to pitch nose down in order to move forward.
+ * Prevents large, negative lift from pitching nose down into wind.
+ * Fixed-wing forward actuators refers to puller/pusher (standard VTOL), or forward-tilt (tiltrotor VTOL).
+ * Only active if demanded down pitch is below VT_PITCH_MIN.
+ * Use VT_FWD_THRUST_SC to tune it.
+ * Descend mode is treated as Landing too.
+ *
+ * Only active (if enabled) in Altitude, Position and Auto modes, not in Stabilized.
+ *
+ * @value 0 Disabled
+ * @value 1 Enabled (except LANDING)
+ * @value 2 Enabled if distance to ground above MPC_LAND_ALT1
+ * @value 3 Enabled if distance to ground above MPC_LAND_ALT2
+ * @value 4 Enabled constantly
+ * @value 5 Enabled if distance to ground above MPC_LAND_ALT1 (except LANDING)
+ * @value 6 Enabled if distance to ground above MPC_LAND_ALT2 (except LANDING)
+ *
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_INT32(VT_FWD_THRUST_EN, 0);
+
+/**
+ * Fixed-wing actuation thrust scale for hover forward flight
+ *
+ * Scale applied to the demanded down-pitch to get the fixed-wing forward actuation in hover mode.
+ * Enabled via VT_FWD_THRUST_EN.
+ *
+ * @min 0.0
+ * @max 2.0
+ * @increment 0.01
+ * @decimal 2
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_FWD_THRUST_SC, 0.7f);
+
 /**
  * Minimum pitch angle during hover landing.
  *
@@ -350,3 +429,152 @@ PARAM_DEFINE_FLOAT(VT_LND_PITCH_MIN, -5.0f);
  * @group VTOL Attitude Control
  */
 PARAM_DEFINE_FLOAT(VT_SPOILER_MC_LD, 0.f);
+
+/**
+ * Enable per-phase cycle profiling
+ *
+ * If set to 1, the duration of every phase of the control cycle is measured and
+ * min/mean/percentile/max statistics are shown by 'vtol_att_control status'.
+ * Switching it on starts a new measurement window.
+ *
+ * @boolean
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_INT32(VT_PROF_EN, 0);
+
+/**
+ * Maximum control cycle rate in hover
+ *
+ * Upper limit for the rate at which the VTOL attitude control cycle runs
+ * in multicopter mode. Input updates arriving faster are merged into the next cycle.
+ * Set to 0 to run on every virtual setpoint update.
+ *
+ * @unit Hz
+ * @min 0
+ * @max 1000
+ * @decimal 0
+ * @increment 10
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_RATE_MC, 500.f);
+
+/**
+ * Maximum control cycle rate in fixed-wing flight
+ *
+ * Upper limit for the rate at which the VTOL attitude control cycle runs
+ * in fixed-wing mode. Lower it to save CPU in cruise.
+ * Set to 0 to run on every virtual setpoint update.
+ *
+ * @unit Hz
+ * @min 0
+ * @max 1000
+ * @decimal 0
+ * @increment 10
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_RATE_FW, 500.f);
+
+/**
+ * Maximum control cycle rate in front transition
+ *
+ * Set to 0 to run on every virtual setpoint update.
+ *
+ * @unit Hz
+ * @min 0
+ * @max 1000
+ * @decimal 0
+ * @increment 10
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_RATE_F_TRANS, 500.f);
+
+/**
+ * Maximum control cycle rate in back transition
+ *
+ * Set to 0 to run on every virtual setpoint update.
+ *
+ * @unit Hz
+ * @min 0
+ * @max 1000
+ * @decimal 0
+ * @increment 10
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_RATE_B_TRANS, 500.f);
+
+/**
+ * Heartbeat interval of change-driven outputs
+ *
+ * vtol_vehicle_status and the flaps and spoilers setpoints are only published when their
+ * content changes, and at least once per this interval.
+ * Set to 0 to publish them on every control cycle.
+ *
+ * @unit s
+ * @min 0
+ * @max 10
+ * @decimal 1
+ * @increment 0.1
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_PUB_HB, 1.f);
+
+/**
+ * Transition throttle profile shape
+ *
+ * Shape of the throttle blends and ramps during the transitions (blend to the fixed-wing throttle after
+ * the front transition, tailsitter and tiltrotor back transition throttle ramps).
+ * 0 is linear, positive values start slowly and finish fast, negative values start fast and finish slowly.
+ *
+ * @min -1
+ * @max 1
+ * @increment 0.05
+ * @decimal 2
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_SHAPE_THR, 0.0f);
+
+/**
+ * Transition MC weight profile shape
+ *
+ * Shape of the multicopter control weight over airspeed or time during the transitions (standard VTOL
+ * and tiltrotor).
+ * 0 is linear, positive values keep the multicopter weight high for longer, negative values reduce it
+ * faster at the beginning.
+ *
+ * @min -1
+ * @max 1
+ * @increment 0.05
+ * @decimal 2
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_SHAPE_WEIGHT, 0.0f);
+
+/**
+ * Tailsitter transition pitch profile shape
+ *
+ * Shape of the rotation of the attitude setpoint over VT_F_TRANS_DUR and VT_B_TRANS_DUR.
+ * 0 is a constant pitch rate, positive values start slowly and finish fast, negative values start fast
+ * and finish slowly.
+ *
+ * @min -1
+ * @max 1
+ * @increment 0.05
+ * @decimal 2
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_FLOAT(VT_SHAPE_PITCH, 0.0f);
+
+/**
+ * Use measured front transition performance
+ *
+ * If set to 1, the transition airspeed and the minimum, open-loop and timeout front transition times
+ * are read from the table etc/vtol_transition.txt on the SD card, measured on the airframe over air density
+ * and WEIGHT_GROSS / WEIGHT_BASE. VT_ARSP_TRANS, VT_TRANS_MIN_TM, VT_F_TR_OL_TM and VT_TRANS_TIMEOUT are
+ * then not used for them. If 0, or if the table cannot be read, they are scaled from these parameters
+ * with the square root of the weight ratio and for air density. The table is read at startup and whenever
+ * this parameter changes; after editing the file, toggle the parameter to reload it.
+ *
+ * @boolean
+ * @group VTOL Attitude Control
+ */
+PARAM_DEFINE_INT32(VT_TRANS_TBL, 0);
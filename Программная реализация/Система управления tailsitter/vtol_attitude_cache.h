@@ -0,0 +1,125 @@
+/**
+ * @file vtol_attitude_cache.h
+ * @brief Attitude-derived quantities shared by the VTOL type checks.
+ *
+ * Every quantity is computed on first use after a new vehicle_attitude sample and
+ * then reused until the next sample, so the quaternion is converted at most once per sample.
+ */
+
+#pragma once
+
+#include "vtol_fast_trig.h"
+#include "vtol_io.h"
+
+#include <drivers/drv_hrt.h>
+#include <lib/mathlib/mathlib.h>
+#include <matrix/math.hpp>
+
+class VtolAttitudeCache
+{
+public:
+	explicit VtolAttitudeCache(const VtolInputs *inputs) :
+		_inputs(inputs)
+	{}
+
+	/**
+	 * @return Rotation from body to earth frame
+	 */
+	const matrix::Dcmf &dcm()
+	{
+		if (!valid(DCM)) {
+			_dcm = matrix::Dcmf(matrix::Quatf(_inputs->q));
+			_valid |= DCM;
+		}
+
+		return _dcm;
+	}
+
+	/**
+	 * @return Euler angles (roll, pitch, yaw) [rad], same convention as matrix::Eulerf(dcm)
+	 * but computed with the fast trigonometry kernels (max error 2e-6 rad)
+	 */
+	const matrix::Eulerf &euler()
+	{
+		if (!valid(EULER)) {
+			const matrix::Dcmf &R = dcm();
+			const float theta = fast_trig::asin(-R(2, 0));
+
+			if (fabsf(theta - M_PI_2_F) < 1.0e-3f) {
+				_euler = matrix::Eulerf(0.f, theta, fast_trig::atan2(R(1, 2), R(0, 2)));
+
+			} else if (fabsf(theta + M_PI_2_F) < 1.0e-3f) {
+				_euler = matrix::Eulerf(0.f, theta, fast_trig::atan2(-R(1, 2), -R(0, 2)));
+
+			} else {
+				_euler = matrix::Eulerf(fast_trig::atan2(R(2, 1), R(2, 2)), theta, fast_trig::atan2(R(1, 0), R(0, 0)));
+			}
+
+			_valid |= EULER;
+		}
+
+		return _euler;
+	}
+
+	/**
+	 * @return Body z axis expressed in earth frame
+	 */
+	matrix::Vector3f body_z() { return dcm().col(2); }
+
+	/**
+	 * @return Angle between the body z axis and the earth z axis [rad]
+	 */
+	float tilt()
+	{
+		if (!valid(TILT)) {
+			_tilt = fast_trig::acos(dcm()(2, 2));
+			_valid |= TILT;
+		}
+
+		return _tilt;
+	}
+
+	/**
+	 * @return Local position velocity expressed in body frame [m/s]
+	 */
+	const matrix::Vector3f &velocity_body()
+	{
+		if (!valid(VELOCITY_BODY) || _inputs->local_pos_sample != _local_pos_sample) {
+			_velocity_body = dcm().transpose() * matrix::Vector3f(_inputs->vx, _inputs->vy, _inputs->vz);
+			_local_pos_sample = _inputs->local_pos_sample;
+			_valid |= VELOCITY_BODY;
+		}
+
+		return _velocity_body;
+	}
+
+private:
+	enum Field : uint8_t {
+		DCM = (1 << 0),
+		EULER = (1 << 1),
+		TILT = (1 << 2),
+		VELOCITY_BODY = (1 << 3),
+	};
+
+	bool valid(Field field)
+	{
+		if (_inputs->attitude_sample != _attitude_sample) {
+			// new attitude sample, everything derived from the previous one is stale
+			_attitude_sample = _inputs->attitude_sample;
+			_valid = 0;
+		}
+
+		return _valid & field;
+	}
+
+	const VtolInputs *_inputs;
+
+	hrt_abstime _attitude_sample{0};
+	hrt_abstime _local_pos_sample{0};
+	uint8_t _valid{0};	// Field bits computed for _attitude_sample
+
+	matrix::Dcmf _dcm;
+	matrix::Eulerf _euler;
+	float _tilt{0.f};
+	matrix::Vector3f _velocity_body;
+};
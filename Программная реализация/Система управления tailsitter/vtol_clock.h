@@ -0,0 +1,95 @@
+/**
+ * @file vtol_clock.h
+ * @brief Time source of the VTOL attitude controller.
+ *
+ * The controller reads the time once per cycle from its clock and derives every
+ * timestamp and elapsed time from that reading. On the vehicle this is the
+ * high-resolution timer; a batch simulation injects a ManualClock and steps it,
+ * so the transition logic runs as fast as the host allows and deterministically.
+ */
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/atomic.h>
+
+#include <stdint.h>
+#include <time.h>
+
+class VtolClock
+{
+public:
+	virtual ~VtolClock() = default;
+
+	/**
+	 * @return Current time [us]
+	 */
+	virtual hrt_abstime now() const = 0;
+};
+
+/**
+ * Wall-clock time from the high-resolution timer (or the lockstep time in SITL).
+ */
+class HrtClock final : public VtolClock
+{
+public:
+	hrt_abstime now() const override { return hrt_absolute_time(); }
+
+	static HrtClock &instance()
+	{
+		static HrtClock clock;
+		return clock;
+	}
+};
+
+/**
+ * Externally stepped time, it only moves when the owner sets or advances it.
+ */
+class ManualClock final : public VtolClock
+{
+public:
+	explicit ManualClock(hrt_abstime start = 0) : _now(start) {}
+
+	hrt_abstime now() const override { return _now.load(); }
+
+	/**
+	 * Set the time [us], it never moves backwards.
+	 */
+	void set(hrt_abstime now)
+	{
+		if (now > _now.load()) {
+			_now.store(now);
+		}
+	}
+
+	/**
+	 * Advance the time by dt [us].
+	 */
+	void advance(hrt_abstime dt) { _now.fetch_add(dt); }
+
+private:
+	px4::atomic<hrt_abstime> _now;
+};
+
+/**
+ * Monotonic wall-clock time for measuring how long code takes (profiler, benchmarks), never used for control.
+ * On the vehicle this is the high-resolution timer. On POSIX the hrt time can be simulated (lockstep SITL,
+ * host build) and does not move while code runs, so the host monotonic clock is read instead.
+ *
+ * @return Time [ns]
+ */
+static inline uint64_t measurement_time_ns()
+{
+#if defined(__PX4_POSIX)
+	timespec ts{};
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+#else
+	return hrt_absolute_time() * 1000ull;
+#endif
+}
+
+/**
+ * @return measurement_time_ns() [us]
+ */
+static inline hrt_abstime measurement_time_us() { return measurement_time_ns() / 1000ull; }
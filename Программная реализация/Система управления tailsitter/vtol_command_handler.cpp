@@ -0,0 +1,226 @@
+/**
+ * @file vtol_command_handler.cpp
+ * @brief Slow-path status and command handling for the VTOL attitude controller.
+ */
+
+#include "vtol_command_handler.h"
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/defines.h>
+
+// measured front transition performance over air density and weight ratio, read if VT_TRANS_TBL is set
+static constexpr char kTransitionTablePath[] = PX4_STORAGEDIR "/etc/vtol_transition.txt";
+
+VtolCommandHandler::VtolCommandHandler(const VtolClock &clock) :
+	ModuleParams(nullptr),
+	ScheduledWorkItem("vtol_att_control_cmd", px4::wq_configurations::lp_default),
+	_clock(clock)
+{
+	_mailbox.write(_state);
+}
+
+void VtolCommandHandler::start()
+{
+	transition_table_poll();
+	ScheduleOnInterval(kInterval);
+}
+
+void VtolCommandHandler::stop()
+{
+	ScheduleClear();
+}
+
+void VtolCommandHandler::Run()
+{
+	if (_parameter_update_sub.updated()) {
+		parameter_update_s param_update;
+		_parameter_update_sub.copy(&param_update);
+		updateParams();
+	}
+
+	transition_table_poll();
+
+	bool changed = vehicle_status_poll();
+	changed |= action_request_poll();
+	changed |= vehicle_cmd_poll();
+	changed |= home_position_poll();
+	changed |= air_data_poll();
+
+	if (changed) {
+		_mailbox.write(_state);
+	}
+}
+
+/**
+ * @brief Polls for vehicle status changes.
+ *
+ * This function checks for changes in the vehicle's navigation state and adjusts the VTOL transition accordingly.
+ *
+ * @return true if the state changed
+ */
+
+bool VtolCommandHandler::vehicle_status_poll()
+{
+	if (!_vehicle_status_sub.update(&_vehicle_status)) {
+		return false;
+	}
+
+	// abort front transition when RTL is triggered
+	if (_vehicle_status.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_RTL
+	    && _nav_state_prev != vehicle_status_s::NAVIGATION_STATE_AUTO_RTL
+	    && static_cast<mode>(_vtol_mode.load()) == mode::TRANSITION_TO_FW) {
+		_state.transition_command = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_MC;
+	}
+
+	_nav_state_prev = _vehicle_status.nav_state;
+	_state.nav_state = _vehicle_status.nav_state;
+
+	return true;
+}
+
+/**
+ * @brief Polls for action requests.
+ *
+ * Handles specific action requests, such as VTOL transitions, and updates the transition command.
+ *
+ * @return true if the state changed
+ */
+
+bool VtolCommandHandler::action_request_poll()
+{
+	bool changed = false;
+
+	while (_action_request_sub.updated()) {
+		action_request_s action_request;
+
+		if (_action_request_sub.copy(&action_request)) {
+			switch (action_request.action) {
+			case action_request_s::ACTION_VTOL_TRANSITION_TO_MULTICOPTER:
+				_state.transition_command = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_MC;
+				_state.immediate_transition = false;
+				_state.immediate_transition_count++;
+				changed = true;
+				break;
+
+			case action_request_s::ACTION_VTOL_TRANSITION_TO_FIXEDWING:
+				_state.transition_command = vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW;
+				_state.immediate_transition = false;
+				_state.immediate_transition_count++;
+
+				// reset fixed_wing_system_failure flag when a new transition to FW is triggered
+				_state.fw_failure_reset_count++;
+				changed = true;
+				break;
+			}
+		}
+	}
+
+	return changed;
+}
+
+/**
+ * @brief Polls for vehicle commands.
+ *
+ * Processes vehicle commands related to VTOL transitions and manages command acknowledgments.
+ *
+ * @return true if the state changed
+ */
+
+bool VtolCommandHandler::vehicle_cmd_poll()
+{
+	bool changed = false;
+	vehicle_command_s vehicle_command;
+
+	while (_vehicle_cmd_sub.update(&vehicle_command)) {
+		if (vehicle_command.command == vehicle_command_s::VEHICLE_CMD_DO_VTOL_TRANSITION) {
+
+			uint8_t result = vehicle_command_ack_s::VEHICLE_CMD_RESULT_ACCEPTED;
+
+			const int transition_command_param1 = int(vehicle_command.param1 + 0.5f);
+
+			// deny transition from MC to FW in Takeoff, Land, RTL and Orbit
+			if (transition_command_param1 == vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW &&
+			    (_vehicle_status.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_TAKEOFF
+			     || _vehicle_status.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_LAND
+			     || _vehicle_status.nav_state == vehicle_status_s::NAVIGATION_STATE_AUTO_RTL
+			     ||  _vehicle_status.nav_state == vehicle_status_s::NAVIGATION_STATE_ORBIT)) {
+
+				result = vehicle_command_ack_s::VEHICLE_CMD_RESULT_TEMPORARILY_REJECTED;
+
+			} else {
+				_state.transition_command = transition_command_param1;
+				_state.immediate_transition = (PX4_ISFINITE(vehicle_command.param2)) ? int(vehicle_command.param2 + 0.5f) : false;
+				_state.immediate_transition_count++;
+
+				// reset fixed_wing_system_failure flag when a new transition to FW is triggered
+				if (_state.transition_command == vtol_vehicle_status_s::VEHICLE_VTOL_STATE_FW) {
+					_state.fw_failure_reset_count++;
+				}
+
+				changed = true;
+			}
+
+			if (vehicle_command.from_external) {
+				vehicle_command_ack_s command_ack{};
+				command_ack.timestamp = _clock.now();
+				command_ack.command = vehicle_command.command;
+				command_ack.result = result;
+				command_ack.target_system = vehicle_command.source_system;
+				command_ack.target_component = vehicle_command.source_component;
+
+				_command_ack_pub.publish(command_ack);
+			}
+		}
+	}
+
+	return changed;
+}
+
+bool VtolCommandHandler::home_position_poll()
+{
+	if (!_home_position_sub.updated()) {
+		return false;
+	}
+
+	home_position_s home_position;
+
+	if (_home_position_sub.copy(&home_position) && home_position.valid_alt) {
+		_state.home_position_z = home_position.z;
+
+	} else {
+		_state.home_position_z = NAN;
+	}
+
+	return true;
+}
+
+bool VtolCommandHandler::air_data_poll()
+{
+	vehicle_air_data_s air_data;
+
+	if (_vehicle_air_data_sub.update(&air_data)) {
+		_state.air_density = air_data.rho;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Reads the measured transition table when VT_TRANS_TBL changes.
+ *
+ * Other parameter updates leave the published table alone. If the controller is copying the
+ * table right now, the read is retried on the next run.
+ */
+
+void VtolCommandHandler::transition_table_poll()
+{
+	const int8_t enabled = _param_vt_trans_tbl.get() ? 1 : 0;
+
+	if (enabled == _transition_table_enabled || !_transition_table.begin_write()) {
+		return;
+	}
+
+	_transition_table.end_write(enabled && _transition_table.grid().load(kTransitionTablePath));
+	_transition_table_enabled = enabled;
+}
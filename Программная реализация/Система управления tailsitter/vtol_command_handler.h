@@ -0,0 +1,182 @@
+/**
+ * @file vtol_command_handler.h
+ * @brief Low-priority companion work item of the VTOL attitude controller.
+ *
+ * Handles everything that is not needed at the control rate: vehicle status,
+ * action requests, vehicle commands (including their acknowledgement), home
+ * position and air density. The result is handed to the rate controller
+ * through a lock-free mailbox, so the hot loop only copies a few bytes.
+ * It also reads the measured transition table (VT_TRANS_TBL), so the rate
+ * controller never touches the file system.
+ */
+
+#pragma once
+
+#include "vtol_clock.h"
+#include "vtol_transition_performance.h"
+#include "vtol_type.h"
+
+#include <lib/atmosphere/atmosphere.h>
+#include <px4_platform_common/atomic.h>
+#include <px4_platform_common/module_params.h>
+#include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+#include <uORB/Publication.hpp>
+#include <uORB/Subscription.hpp>
+#include <uORB/topics/action_request.h>
+#include <uORB/topics/home_position.h>
+#include <uORB/topics/parameter_update.h>
+#include <uORB/topics/vehicle_air_data.h>
+#include <uORB/topics/vehicle_command.h>
+#include <uORB/topics/vehicle_command_ack.h>
+#include <uORB/topics/vehicle_status.h>
+#include <uORB/topics/vtol_vehicle_status.h>
+
+#include <string.h>
+
+using namespace time_literals;
+
+/**
+ * Single writer, single reader mailbox based on a sequence lock.
+ *
+ * The writer never blocks. The reader retries a bounded number of times and
+ * otherwise reports that no consistent snapshot was available, in which case
+ * the caller keeps its previous copy. The sequence and the data are padded by
+ * a full cache line on both sides, so they never share a line with neighbouring
+ * members without requiring an over-aligned allocation.
+ *
+ * The data is copied with plain memcpy, so the ordering against the sequence
+ * relies on the fences: the writer's release fence keeps the data stores after
+ * the odd sequence, the reader's acquire fence keeps the data loads before the
+ * sequence is read again. px4::atomic only orders the sequence itself.
+ */
+template<typename T>
+class SeqLockMailbox
+{
+public:
+	void write(const T &data)
+	{
+		_sequence.fetch_add(1); // odd: write in progress
+		__atomic_thread_fence(__ATOMIC_RELEASE); // data stores not before the odd sequence
+		memcpy(&_data, &data, sizeof(T));
+		_sequence.fetch_add(1); // seq_cst RMW: data stores not after the even sequence
+	}
+
+	/**
+	 * @return true if a consistent snapshot was copied into data
+	 */
+	bool read(T &data) const
+	{
+		for (int attempt = 0; attempt < kMaxReadAttempts; attempt++) {
+			const uint32_t sequence = _sequence.load();
+
+			if (sequence & 1) {
+				continue;
+			}
+
+			memcpy(&data, &_data, sizeof(T));
+			__atomic_thread_fence(__ATOMIC_ACQUIRE); // data loads not after the sequence check
+
+			if (_sequence.load() == sequence) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	uint32_t sequence() const { return _sequence.load(); }
+
+private:
+	static constexpr int kCacheLineSize = 64;
+	static constexpr int kMaxReadAttempts = 3;
+
+	uint8_t _pad_front[kCacheLineSize];
+	px4::atomic<uint32_t> _sequence{0};
+	T _data{};
+	uint8_t _pad_back[kCacheLineSize];
+};
+
+class VtolCommandHandler : public ModuleParams, public px4::ScheduledWorkItem
+{
+public:
+	/**
+	 * State handed from the command handler to the rate controller.
+	 * Edge events (immediate transition, failure flag reset) are signalled by counters.
+	 */
+	struct State {
+		int32_t transition_command{vtol_vehicle_status_s::VEHICLE_VTOL_STATE_MC};
+		uint32_t immediate_transition_count{0};	// incremented whenever a command sets immediate_transition
+		bool immediate_transition{false};
+		uint32_t fw_failure_reset_count{0};	// incremented whenever a new transition to FW is commanded
+		uint8_t nav_state{0};
+		float home_position_z{NAN};
+		float air_density{atmosphere::kAirDensitySeaLevelStandardAtmos};	// [kg/m^3]
+	};
+
+	explicit VtolCommandHandler(const VtolClock &clock);
+	~VtolCommandHandler() override = default;
+
+	/**
+	 * Read the transition table in the calling context, then schedule the work item.
+	 */
+	void start();
+	void stop();
+
+	/**
+	 * Copy the latest state, called from the rate controller.
+	 *
+	 * @return false if no consistent snapshot was available, state is left untouched
+	 */
+	bool get_state(State &state) const { return _mailbox.read(state); }
+
+	/**
+	 * Current VTOL mode, published back by the rate controller (used to abort front transitions on RTL).
+	 */
+	void set_vtol_mode(mode vtol_mode) { _vtol_mode.store(static_cast<int>(vtol_mode)); }
+
+	uint32_t mailbox_updates() const { return _mailbox.sequence() / 2; }
+
+	/**
+	 * Measured transition table, republished whenever VT_TRANS_TBL changes.
+	 */
+	TransitionTableHandover &transition_table() { return _transition_table; }
+
+private:
+	static constexpr uint32_t kInterval = 20_ms;	// 50 Hz
+
+	void Run() override;
+
+	bool vehicle_status_poll();
+	bool action_request_poll();
+	bool vehicle_cmd_poll();
+	bool home_position_poll();
+	bool air_data_poll();
+	void transition_table_poll();
+
+	uORB::Subscription _action_request_sub{ORB_ID(action_request)};
+	uORB::Subscription _home_position_sub{ORB_ID(home_position)};
+	uORB::Subscription _parameter_update_sub{ORB_ID(parameter_update)};
+	uORB::Subscription _vehicle_air_data_sub{ORB_ID(vehicle_air_data)};
+	uORB::Subscription _vehicle_cmd_sub{ORB_ID(vehicle_command)};
+	uORB::Subscription _vehicle_status_sub{ORB_ID(vehicle_status)};
+
+	uORB::Publication<vehicle_command_ack_s> _command_ack_pub{ORB_ID(vehicle_command_ack)};
+
+	const VtolClock &_clock;	// time source of the controller, stamps the command acknowledgements
+
+	vehicle_status_s _vehicle_status{};
+	uint8_t _nav_state_prev{0};
+
+	State _state{};	// writer side copy, only accessed from Run()
+
+	px4::atomic<int> _vtol_mode{static_cast<int>(mode::ROTARY_WING)};
+
+	SeqLockMailbox<State> _mailbox;
+
+	TransitionTableHandover _transition_table;
+	int8_t _transition_table_enabled{-1};	// VT_TRANS_TBL the table was last read for, -1 before the first read
+
+	DEFINE_PARAMETERS(
+		(ParamBool<px4::params::VT_TRANS_TBL>) _param_vt_trans_tbl
+	)
+};
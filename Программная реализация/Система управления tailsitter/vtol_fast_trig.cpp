@@ -0,0 +1,122 @@
+/**
+ * @file vtol_fast_trig.cpp
+ * @brief Accuracy and throughput benchmark of the fast trigonometry kernels.
+ */
+
+#include "vtol_fast_trig.h"
+#include "vtol_clock.h"
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/log.h>
+
+namespace fast_trig
+{
+
+namespace
+{
+
+static constexpr int kSamples = 20000;
+
+struct Kernel {
+	const char *name;
+	float (*fast)(float, float);
+	float (*libm)(float, float);
+	double (*reference)(double, double);
+	float min;	// sampled input domain, for atan2 the angle of (x, y)
+	float max;
+	bool binary;
+};
+
+float input(const Kernel &kernel, int i)
+{
+	return kernel.min + (kernel.max - kernel.min) * i / (kSamples - 1);
+}
+
+// unary kernels ignore the second argument
+const Kernel kKernels[] = {
+	{"sin",   [](float x, float) { return fast_trig::sin(x); },  [](float x, float) { return sinf(x); },  [](double x, double) { return ::sin(x); },  -100.f, 100.f, false},
+	{"cos",   [](float x, float) { return fast_trig::cos(x); },  [](float x, float) { return cosf(x); },  [](double x, double) { return ::cos(x); },  -100.f, 100.f, false},
+	{"atan2", [](float y, float x) { return fast_trig::atan2(y, x); }, [](float y, float x) { return atan2f(y, x); }, [](double y, double x) { return ::atan2(y, x); }, -M_PI_F, M_PI_F, true},
+	{"asin",  [](float x, float) { return fast_trig::asin(x); }, [](float x, float) { return asinf(x); }, [](double x, double) { return ::asin(x); }, -1.f, 1.f, false},
+	{"acos",  [](float x, float) { return fast_trig::acos(x); }, [](float x, float) { return acosf(x); }, [](double x, double) { return ::acos(x); }, -1.f, 1.f, false},
+};
+
+void arguments(const Kernel &kernel, int i, float &a, float &b)
+{
+	a = input(kernel, i);
+	b = 0.f;
+
+	if (kernel.binary) {
+		// (y, x) at the sampled angle, off the unit circle
+		const float radius = 0.5f + (i % 7);
+		b = radius * cosf(a);
+		a = radius * sinf(a);
+	}
+}
+
+/**
+ * @return Mean time per call including the indirect call overhead [ns]
+ */
+float time_ns(float (*function)(float, float), const float *a, const float *b, int count, int repeat)
+{
+	volatile float sink = 0.f;
+	const uint64_t start = measurement_time_ns();
+
+	for (int r = 0; r < repeat; r++) {
+		float sum = 0.f;
+
+		for (int i = 0; i < count; i++) {
+			sum += function(a[i], b[i]);
+		}
+
+		sink = sink + sum;
+	}
+
+	return static_cast<float>(measurement_time_ns() - start) / (count * repeat);
+}
+
+} // namespace
+
+void benchmark()
+{
+	static constexpr int kTimedSamples = 256;
+	static constexpr int kRepeat = 100;	// 25600 calls per measurement, well above the timer resolution
+	static constexpr int kRuns = 5;
+	float a[kTimedSamples];
+	float b[kTimedSamples];
+
+	PX4_INFO("kernel  max error [rad]  fast [ns]  libm [ns]");
+
+	for (const Kernel &kernel : kKernels) {
+		double max_error = 0.0;
+
+		for (int i = 0; i < kSamples; i++) {
+			float x;
+			float y;
+			arguments(kernel, i, x, y);
+
+			const double error = fabs(kernel.fast(x, y) - kernel.reference(x, y));
+
+			if (error > max_error) {
+				max_error = error;
+			}
+		}
+
+		for (int i = 0; i < kTimedSamples; i++) {
+			arguments(kernel, i * (kSamples / kTimedSamples), a[i], b[i]);
+		}
+
+		// best of several runs, the first ones also pay for cold caches and the clock ramping up
+		float fast_ns = INFINITY;
+		float libm_ns = INFINITY;
+
+		for (int run = 0; run < kRuns; run++) {
+			fast_ns = fminf(fast_ns, time_ns(kernel.fast, a, b, kTimedSamples, kRepeat));
+			libm_ns = fminf(libm_ns, time_ns(kernel.libm, a, b, kTimedSamples, kRepeat));
+		}
+
+		PX4_INFO("%-6s  %15.2e  %9.1f  %9.1f", kernel.name, max_error, (double)fast_ns, (double)libm_ns);
+	}
+}
+
+} // namespace fast_trig
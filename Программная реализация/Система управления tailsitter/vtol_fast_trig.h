@@ -0,0 +1,122 @@
+/**
+ * @file vtol_fast_trig.h
+ * @brief Bounded-error trigonometry kernels for the VTOL hot path.
+ *
+ * Branch-light polynomial approximations that avoid the libm calls (and their
+ * errno/range handling) on the control path. The error bounds below are the
+ * maximum absolute errors against the double precision reference, measured
+ * over the full input domain with the benchmark in vtol_fast_trig.cpp
+ * ("vtol_att_control trig_bench"). They are far below what the attitude
+ * thresholds and setpoints computed from them resolve (~1e-4 rad), but the
+ * kernels are not meant for accumulated quantities such as integrators.
+ */
+
+#pragma once
+
+#include <px4_platform_common/defines.h>
+
+#include <math.h>
+
+namespace fast_trig
+{
+
+/**
+ * Reduce x to [-pi, pi].
+ */
+inline float reduce_two_pi(float x)
+{
+	// 2 pi split into an exactly representable head and the remainder (Cody-Waite),
+	// so the reduction does not lose the low bits of x for the angles that matter here
+	const float turns = floorf(x * (1.f / M_TWOPI_F) + 0.5f);
+	return (x - turns * 6.28125f) - turns * 1.9353071795864769e-3f;
+}
+
+/**
+ * sin(x) for x in [-3/2 pi, 3/2 pi].
+ */
+inline float sin_reduced(float x)
+{
+	// sin(pi - x) = sin(x)
+	if (x > M_PI_2_F) {
+		x = M_PI_F - x;
+
+	} else if (x < -M_PI_2_F) {
+		x = -M_PI_F - x;
+	}
+
+	// Taylor series up to x^11, truncation error < 6e-8 on [-pi/2, pi/2]
+	const float x2 = x * x;
+	return x * (1.f + x2 * (-1.f / 6.f + x2 * (1.f / 120.f + x2 * (-1.f / 5040.f + x2 * (1.f / 362880.f
+							   + x2 * (-1.f / 39916800.f))))));
+}
+
+/**
+ * sin(x), max error 3e-7 on |x| <= 100 rad.
+ */
+inline float sin(float x) { return sin_reduced(reduce_two_pi(x)); }
+
+/**
+ * cos(x), max error 3e-7 on |x| <= 100 rad.
+ */
+inline float cos(float x) { return sin_reduced(reduce_two_pi(x) + M_PI_2_F); }
+
+/**
+ * atan(z) for |z| <= 1, max error 2e-6.
+ */
+inline float atan_unit(float z)
+{
+	const float z2 = z * z;
+	return z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f + z2 * (0.05265332f
+						 + z2 * -0.01172120f)))));
+}
+
+/**
+ * atan2(y, x), max error 2e-6, atan2(0, 0) = 0 like libm.
+ */
+inline float atan2(float y, float x)
+{
+	const float abs_x = fabsf(x);
+	const float abs_y = fabsf(y);
+
+	if (!(abs_x > 0.f || abs_y > 0.f)) {
+		return 0.f;
+	}
+
+	// reduce to the first octant, the quotient is always in [0, 1]
+	const bool swap = abs_y > abs_x;
+	float angle = swap ? M_PI_2_F - atan_unit(abs_x / abs_y) : atan_unit(abs_y / abs_x);
+
+	if (x < 0.f) {
+		angle = M_PI_F - angle;
+	}
+
+	return y < 0.f ? -angle : angle;
+}
+
+/**
+ * acos(x), max error 4e-7, x is clamped to [-1, 1].
+ * Abramowitz & Stegun 4.4.46.
+ */
+inline float acos(float x)
+{
+	const bool negative = x < 0.f;
+	const float a = fminf(fabsf(x), 1.f);
+
+	const float poly = 1.5707963050f + a * (-0.2145988016f + a * (0.0889789874f + a * (-0.0501743046f + a * (0.0308918810f
+			   + a * (-0.0170881256f + a * (0.0066700901f + a * -0.0012624911f))))));
+	const float angle = sqrtf(1.f - a) * poly;
+
+	return negative ? M_PI_F - angle : angle;
+}
+
+/**
+ * asin(x), max error 4e-7, x is clamped to [-1, 1].
+ */
+inline float asin(float x) { return M_PI_2_F - acos(x); }
+
+/**
+ * Benchmark the kernels against libm and print the maximum errors and the time per call.
+ */
+void benchmark();
+
+} // namespace fast_trig
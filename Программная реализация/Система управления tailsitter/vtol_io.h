@@ -0,0 +1,159 @@
+/**
+ * @file vtol_io.h
+ * @brief Compact input/output block of the VTOL types.
+ *
+ * Holds only the message fields the VTOL logic reads and writes instead of pointers
+ * into a dozen full-size uORB messages, so the data touched by a cycle fits in a
+ * handful of cache lines. Fields are grouped by use, the ones needed on every cycle
+ * (virtual setpoints and outputs) first. The controller updates the inputs whenever
+ * it copies a new message and builds the torque/thrust messages from the outputs.
+ */
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+#include <uORB/topics/airspeed_validated.h>
+#include <uORB/topics/position_setpoint_triplet.h>
+#include <uORB/topics/tecs_status.h>
+#include <uORB/topics/vehicle_attitude.h>
+#include <uORB/topics/vehicle_control_mode.h>
+#include <uORB/topics/vehicle_land_detected.h>
+#include <uORB/topics/vehicle_local_position.h>
+#include <uORB/topics/vehicle_thrust_setpoint.h>
+#include <uORB/topics/vehicle_torque_setpoint.h>
+
+/**
+ * Torque or thrust setpoint without the message overhead.
+ */
+struct VtolSetpointSample {
+	float xyz[3];
+	hrt_abstime timestamp_sample;
+
+	template<typename T>
+	void update(const T &msg)
+	{
+		xyz[0] = msg.xyz[0];
+		xyz[1] = msg.xyz[1];
+		xyz[2] = msg.xyz[2];
+		timestamp_sample = msg.timestamp_sample;
+	}
+
+	template<typename T>
+	void copy_to(T &msg, hrt_abstime now) const
+	{
+		msg.timestamp = now;
+		msg.timestamp_sample = timestamp_sample;
+		msg.xyz[0] = xyz[0];
+		msg.xyz[1] = xyz[1];
+		msg.xyz[2] = xyz[2];
+	}
+};
+
+struct VtolInputs {
+	// virtual setpoints of the MC and FW rate controllers, read by every fill_actuator_outputs()
+	VtolSetpointSample mc_torque;
+	VtolSetpointSample fw_torque;
+	VtolSetpointSample mc_thrust;
+	VtolSetpointSample fw_thrust;
+
+	// vehicle_attitude
+	hrt_abstime attitude_sample;
+	float q[4];
+
+	// vehicle_local_position
+	hrt_abstime local_pos_sample;
+	float z;
+	float vx;
+	float vy;
+	float vz;
+	float ax;
+	float ay;
+	float az;
+	float delta_z;
+	float dist_bottom;
+	float ref_alt;
+	uint8_t z_reset_counter;
+	bool z_valid;
+	bool z_global;
+	bool v_xy_valid;
+	bool v_z_valid;
+	bool dist_bottom_valid;
+
+	// vehicle_control_mode, vehicle_land_detected and position_setpoint_triplet flags
+	bool armed;
+	bool altitude_control;
+	bool climb_rate_control;
+	bool auto_control;
+	bool landed;
+	bool landing_setpoint;	// current position setpoint is a valid LAND setpoint
+
+	// airspeed_validated and tecs_status
+	float calibrated_airspeed;
+	float tecs_altitude_reference;
+	hrt_abstime tecs_timestamp;
+
+	void update(const vehicle_attitude_s &attitude)
+	{
+		attitude_sample = attitude.timestamp_sample;
+
+		for (int i = 0; i < 4; i++) {
+			q[i] = attitude.q[i];
+		}
+	}
+
+	void update(const vehicle_local_position_s &local_pos)
+	{
+		local_pos_sample = local_pos.timestamp_sample;
+		z = local_pos.z;
+		vx = local_pos.vx;
+		vy = local_pos.vy;
+		vz = local_pos.vz;
+		ax = local_pos.ax;
+		ay = local_pos.ay;
+		az = local_pos.az;
+		delta_z = local_pos.delta_z;
+		dist_bottom = local_pos.dist_bottom;
+		ref_alt = local_pos.ref_alt;
+		z_reset_counter = local_pos.z_reset_counter;
+		z_valid = local_pos.z_valid;
+		z_global = local_pos.z_global;
+		v_xy_valid = local_pos.v_xy_valid;
+		v_z_valid = local_pos.v_z_valid;
+		dist_bottom_valid = local_pos.dist_bottom_valid;
+	}
+
+	void update(const vehicle_control_mode_s &control_mode)
+	{
+		armed = control_mode.flag_armed;
+		altitude_control = control_mode.flag_control_altitude_enabled;
+		climb_rate_control = control_mode.flag_control_climb_rate_enabled;
+		auto_control = control_mode.flag_control_auto_enabled;
+	}
+
+	void update(const vehicle_land_detected_s &land_detected) { landed = land_detected.landed; }
+
+	void update(const position_setpoint_triplet_s &triplet)
+	{
+		landing_setpoint = triplet.current.valid && triplet.current.type == position_setpoint_s::SETPOINT_TYPE_LAND;
+	}
+
+	void update(const airspeed_validated_s &airspeed) { calibrated_airspeed = airspeed.calibrated_airspeed_m_s; }
+
+	void update(const tecs_status_s &tecs_status)
+	{
+		tecs_altitude_reference = tecs_status.altitude_reference;
+		tecs_timestamp = tecs_status.timestamp;
+	}
+};
+
+struct VtolOutputs {
+	VtolSetpointSample torque_0;	// vehicle_torque_setpoint instance 0
+	VtolSetpointSample torque_1;	// vehicle_torque_setpoint instance 1
+	VtolSetpointSample thrust_0;	// vehicle_thrust_setpoint instance 0
+	VtolSetpointSample thrust_1;	// vehicle_thrust_setpoint instance 1
+};
+
+struct VtolIo {
+	VtolOutputs out;	// first, so the outputs are adjacent to the virtual setpoints they are computed from
+	VtolInputs in;
+};
@@ -0,0 +1,219 @@
+/**
+ * @file vtol_profiler.cpp
+ * @brief Per-phase cycle profiler implementation.
+ */
+
+#include "vtol_profiler.h"
+
+#include <px4_platform_common/log.h>
+
+#include <string.h>
+
+VtolProfiler::VtolProfiler()
+{
+	reset();
+}
+
+void VtolProfiler::Stats::reset()
+{
+	memset(this, 0, sizeof(*this));
+	min_us = UINT32_MAX;
+}
+
+void VtolProfiler::Stats::add(uint32_t dt_us)
+{
+	count++;
+	sum_us += dt_us;
+
+	if (dt_us < min_us) {
+		min_us = dt_us;
+	}
+
+	if (dt_us > max_us) {
+		max_us = dt_us;
+	}
+
+	histogram[bin_index(dt_us)]++;
+}
+
+uint32_t VtolProfiler::Stats::percentile_us(float percentile) const
+{
+	if (count == 0) {
+		return 0;
+	}
+
+	// rank of the requested sample, rounded to the nearest (p0 is the first and p100 the last sample)
+	uint32_t rank = static_cast<uint32_t>(percentile / 100.f * count + 0.5f);
+
+	if (rank < 1) {
+		rank = 1;
+
+	} else if (rank > count) {
+		rank = count;
+	}
+
+	uint32_t cumulative = 0;
+
+	for (uint8_t bin = 0; bin < kNumBins; bin++) {
+		cumulative += histogram[bin];
+
+		if (cumulative >= rank) {
+			if (bin == kNumBins - 1) {
+				// last bin is open ended
+				return max_us;
+			}
+
+			// the bin edge can overshoot the largest sample seen
+			const uint32_t edge = bin_upper_edge_us(bin);
+			return edge < max_us ? edge : max_us;
+		}
+	}
+
+	return max_us;
+}
+
+void VtolProfiler::set_enabled(bool enabled)
+{
+	if (enabled && !_enabled) {
+		// start a fresh measurement window every time profiling is switched on
+		reset();
+	}
+
+	_enabled = enabled;
+	clear_pending();
+	_cycle_start = 0;
+}
+
+void VtolProfiler::reset()
+{
+	for (Stats &stats : _phases) {
+		stats.reset();
+	}
+
+	_cycle.reset();
+	_noop.reset();
+	clear_pending();
+	_cycle_start = 0;
+}
+
+uint8_t VtolProfiler::bin_index(uint32_t dt_us)
+{
+	if (dt_us < kLinearBins) {
+		return static_cast<uint8_t>(dt_us);
+	}
+
+	const uint8_t msb = 31 - __builtin_clz(dt_us); // >= 3
+	const uint8_t sub = (dt_us >> (msb - kSubBinsLog2)) & ((1 << kSubBinsLog2) - 1);
+	const unsigned bin = kLinearBins + (msb - 3) * (1 << kSubBinsLog2) + sub;
+
+	return bin < kNumBins ? static_cast<uint8_t>(bin) : kNumBins - 1;
+}
+
+uint32_t VtolProfiler::bin_upper_edge_us(uint8_t bin)
+{
+	if (bin < kLinearBins) {
+		return bin;
+	}
+
+	const uint8_t msb = 3 + (bin - kLinearBins) / (1 << kSubBinsLog2);
+	const uint8_t sub = (bin - kLinearBins) % (1 << kSubBinsLog2);
+
+	// last value that still maps into this bin
+	return (1u << msb) + ((sub + 1u) << (msb - kSubBinsLog2)) - 1u;
+}
+
+const char *VtolProfiler::phase_name(Phase phase)
+{
+	switch (phase) {
+	case Phase::VirtualSetpoints: return "virtual sp";
+
+	case Phase::Subscriptions: return "subscriptions";
+
+	case Phase::Polls: return "polls";
+
+	case Phase::Setpoints: return "setpoints";
+
+	case Phase::StateMachine: return "state machine";
+
+	case Phase::ModeUpdate: return "mode update";
+
+	case Phase::ActuatorOutputs: return "actuator out";
+
+	case Phase::Publish: return "publish";
+
+	case Phase::Count: break;
+	}
+
+	return "unknown";
+}
+
+void VtolProfiler::print_line(const char *name, const Stats &stats)
+{
+	if (stats.count == 0) {
+		PX4_INFO_RAW("  %-14s %8s\n", name, "-");
+		return;
+	}
+
+	PX4_INFO_RAW("  %-14s %8u %6u %8.1f %6u %6u %6u\n", name, (unsigned)stats.count, (unsigned)stats.min_us,
+		     (double)stats.mean_us(), (unsigned)stats.percentile_us(50.f), (unsigned)stats.percentile_us(99.f),
+		     (unsigned)stats.max_us);
+}
+
+void VtolProfiler::print_histogram(const Stats &stats)
+{
+	if (stats.count == 0) {
+		PX4_INFO_RAW("  no samples\n");
+		return;
+	}
+
+	static constexpr int kBarWidth = 40;
+
+	uint32_t largest_bin = 0;
+
+	for (uint8_t bin = 0; bin < kNumBins; bin++) {
+		if (stats.histogram[bin] > largest_bin) {
+			largest_bin = stats.histogram[bin];
+		}
+	}
+
+	uint32_t lower_edge = 0;
+
+	for (uint8_t bin = 0; bin < kNumBins; bin++) {
+		const uint32_t upper_edge = bin_upper_edge_us(bin);
+
+		if (stats.histogram[bin] > 0) {
+			char bar[kBarWidth + 1];
+			const int len = static_cast<int>((uint64_t)stats.histogram[bin] * kBarWidth / largest_bin);
+			memset(bar, '#', len);
+			bar[len] = '\0';
+
+			if (bin == kNumBins - 1) {
+				PX4_INFO_RAW("  %5u+      us %8u %s\n", (unsigned)lower_edge, (unsigned)stats.histogram[bin], bar);
+
+			} else {
+				PX4_INFO_RAW("  %5u-%-5u us %8u %s\n", (unsigned)lower_edge, (unsigned)upper_edge,
+					     (unsigned)stats.histogram[bin], bar);
+			}
+		}
+
+		lower_edge = upper_edge + 1;
+	}
+}
+
+void VtolProfiler::print() const
+{
+	if (!_enabled && _cycle.count == 0) {
+		PX4_INFO_RAW("phase profiling disabled (VT_PROF_EN)\n");
+		return;
+	}
+
+	PX4_INFO_RAW("phase profile%s [us]:\n", _enabled ? "" : " (disabled, last window)");
+	PX4_INFO_RAW("  %-14s %8s %6s %8s %6s %6s %6s\n", "phase", "count", "min", "mean", "p50", "p99", "max");
+
+	for (uint8_t i = 0; i < kNumPhases; i++) {
+		print_line(phase_name(static_cast<Phase>(i)), _phases[i]);
+	}
+
+	print_line("cycle", _cycle);
+	print_line("no-op run", _noop);
+}
@@ -0,0 +1,163 @@
+/**
+ * @file vtol_profiler.h
+ * @brief Lightweight per-phase cycle profiler for the VTOL attitude control loop.
+ *
+ * A cycle is split into consecutive phases by calls to mark(). Each phase keeps
+ * min/max/mean and a log-linear histogram from which percentiles are read.
+ * Only runs that execute the controller enter the phase and cycle statistics, runs
+ * that end without a cycle (no input for the mode, merged or rate limited) are kept apart.
+ * When disabled, every call returns immediately without reading the timer.
+ * Durations are taken from measurement_time_us(), which keeps running when the hrt is simulated.
+ */
+
+#pragma once
+
+#include "vtol_clock.h"
+
+#include <drivers/drv_hrt.h>
+
+#include <stdint.h>
+
+class VtolProfiler
+{
+public:
+	enum class Phase : uint8_t {
+		VirtualSetpoints = 0,	/**< virtual torque/thrust setpoint updates (callback topics) */
+		Subscriptions,		/**< parameter check and input topic copies */
+		Polls,			/**< slow-path state (status, commands, home, air density) from the command handler */
+		Setpoints,		/**< EKF reset handling and virtual attitude setpoints */
+		StateMachine,		/**< update_vtol_state() */
+		ModeUpdate,		/**< mode specific update_*_state() and attitude setpoint publication */
+		ActuatorOutputs,	/**< fill_actuator_outputs() */
+		Publish,		/**< torque/thrust, vtol status, flaps and spoiler publications */
+		Count
+	};
+
+	static constexpr uint8_t kNumPhases = static_cast<uint8_t>(Phase::Count);
+
+	// log-linear histogram: 1 us bins up to 8 us, then 4 bins per power of two up to 8 ms
+	static constexpr uint8_t kLinearBins = 8;
+	static constexpr uint8_t kSubBinsLog2 = 2;
+	static constexpr uint8_t kNumBins = kLinearBins + (13 - 3) * (1 << kSubBinsLog2);
+
+	struct Stats {
+		uint32_t count;
+		uint32_t min_us;
+		uint32_t max_us;
+		uint64_t sum_us;
+		uint32_t histogram[kNumBins];
+
+		void reset();
+		void add(uint32_t dt_us);
+
+		float mean_us() const { return count > 0 ? static_cast<float>(sum_us) / count : 0.f; }
+
+		/**
+		 * @param percentile in [0, 100]
+		 * @return Upper edge of the histogram bin containing the given percentile [us]
+		 */
+		uint32_t percentile_us(float percentile) const;
+	};
+
+	VtolProfiler();
+
+	void set_enabled(bool enabled);
+	bool enabled() const { return _enabled; }
+
+	/**
+	 * Start a new cycle, the first phase starts now.
+	 */
+	void begin_cycle()
+	{
+		if (_enabled) {
+			_cycle_start = _phase_start = measurement_time_us();
+		}
+	}
+
+	/**
+	 * Account the time since the previous mark (or the cycle start) to the given phase.
+	 */
+	void mark(Phase phase)
+	{
+		if (_enabled && _cycle_start != 0) {
+			const hrt_abstime now = measurement_time_us();
+			_pending_us[static_cast<uint8_t>(phase)] += static_cast<uint32_t>(now - _phase_start);
+			_pending_phases |= 1u << static_cast<uint8_t>(phase);
+			_phase_start = now;
+		}
+	}
+
+	/**
+	 * Close the cycle and account its phases and total duration.
+	 *
+	 * @param executed true if the controller ran, otherwise only the duration is counted as a no-op run
+	 */
+	void end_cycle(bool executed)
+	{
+		if (_enabled && _cycle_start != 0) {
+			const uint32_t total = static_cast<uint32_t>(measurement_time_us() - _cycle_start);
+
+			if (executed) {
+				for (uint8_t i = 0; i < kNumPhases; i++) {
+					if (_pending_phases & (1u << i)) {
+						_phases[i].add(_pending_us[i]);
+					}
+				}
+
+				_cycle.add(total);
+
+			} else {
+				_noop.add(total);
+			}
+
+			clear_pending();
+			_cycle_start = 0;
+		}
+	}
+
+	void reset();
+
+	const Stats &phase_stats(Phase phase) const { return _phases[static_cast<uint8_t>(phase)]; }
+	const Stats &cycle_stats() const { return _cycle; }
+	const Stats &noop_stats() const { return _noop; }
+
+	static const char *phase_name(Phase phase);
+
+	/**
+	 * Print one line per phase plus the total cycle (min/mean/p50/p99/max).
+	 */
+	void print() const;
+
+	/**
+	 * Print the non-empty histogram bins of the given statistics.
+	 */
+	static void print_histogram(const Stats &stats);
+
+private:
+	static uint8_t bin_index(uint32_t dt_us);
+	static uint32_t bin_upper_edge_us(uint8_t bin);
+
+	static void print_line(const char *name, const Stats &stats);
+
+	void clear_pending()
+	{
+		for (uint32_t &pending : _pending_us) {
+			pending = 0;
+		}
+
+		_pending_phases = 0;
+	}
+
+	bool _enabled{false};
+
+	hrt_abstime _cycle_start{0};
+	hrt_abstime _phase_start{0};
+
+	// phases of the open cycle, accounted once it is known to have executed
+	uint32_t _pending_us[kNumPhases] {};
+	uint16_t _pending_phases{0};
+
+	Stats _phases[kNumPhases] {};
+	Stats _cycle{};
+	Stats _noop{};		// runs without a controller cycle
+};
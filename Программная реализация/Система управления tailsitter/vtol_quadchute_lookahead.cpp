@@ -0,0 +1,68 @@
+/**
+ * @file vtol_quadchute_lookahead.cpp
+ * @brief Scripted failures of the quadchute replay.
+ */
+
+#include "vtol_quadchute_lookahead.h"
+
+#include <lib/mathlib/mathlib.h>
+
+namespace quadchute_replay
+{
+
+const Scenario kScenarios[kNumScenarios] = {
+	{
+		"thrust loss", [](float t, Truth & truth)
+		{
+			// sinks from 50 m at 2 m/s^2 after 1 s, crosses the transition altitude loss first
+			const float sink = math::max(t - 1.f, 0.f);
+			truth = {50.f - sink * sink, 2.f * sink, sink > 0.f ? 2.f : 0.f, 0.f, 0.f};
+		}
+	},
+	{
+		"steady descent", [](float t, Truth & truth)
+		{
+			// 4 m/s from 25 m, crosses the minimum altitude
+			truth = {25.f - 4.f * t, 4.f, 0.f, 0.f, 0.f};
+		}
+	},
+	{
+		"pitch up", [](float t, Truth & truth)
+		{
+			// 25 deg/s after 1 s
+			truth = {50.f, 0.f, 0.f, 0.f, math::radians(25.f) * math::max(t - 1.f, 0.f)};
+		}
+	},
+	{
+		"roll off", [](float t, Truth & truth)
+		{
+			// accelerating at 60 deg/s^2 after 1 s
+			const float t_roll = math::max(t - 1.f, 0.f);
+			truth = {50.f, 0.f, 0.f, math::radians(30.f) * t_roll * t_roll, math::radians(5.f)};
+		}
+	},
+	{
+		"turns (nominal)", [](float t, Truth & truth)
+		{
+			// +-25 deg turns and +-2 m altitude oscillation at 0.2 Hz, must not trigger
+			const float w = 2.f * M_PI_F * 0.2f;
+			truth = {50.f + 2.f * sinf(w * t), -2.f * w * cosf(w * t), 2.f * w * w * sinf(w * t),
+				 math::radians(25.f) *sinf(w * t), math::radians(5.f)
+				};
+		}
+	},
+};
+
+float noise(uint32_t &seed)
+{
+	float sum = 0.f;
+
+	for (int i = 0; i < 2; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		sum += (seed >> 8) * (1.f / (1u << 24));
+	}
+
+	return sum - 1.f;
+}
+
+} // namespace quadchute_replay
@@ -0,0 +1,156 @@
+/**
+ * @file vtol_quadchute_lookahead.h
+ * @brief Short-horizon projection of the state the quadchute checks look at.
+ *
+ * The altitude is projected with the current vertical speed and acceleration, the attitude
+ * through the last row of the attitude dcm (gravity in body frame, which holds the pitch and
+ * roll) and its rate. The rate is differentiated from consecutive vehicle_attitude samples and
+ * low-pass filtered. Both projections are first and second order closed forms, so they are
+ * only meant for horizons well below a second.
+ *
+ * The scripted failures of the 'quadchute_replay' command are defined here as well, the replay
+ * itself runs them through VtolType::replayQuadchute().
+ */
+
+#pragma once
+
+#include <drivers/drv_hrt.h>
+
+#include <float.h>
+#include <math.h>
+
+using namespace time_literals;
+
+class QuadchuteLookahead
+{
+public:
+	void reset()
+	{
+		_sample = 0;
+
+		for (int i = 0; i < 3; i++) {
+			_row_rate[i] = 0.f;
+		}
+	}
+
+	/**
+	 * Update the attitude rate estimate, only new samples are used.
+	 *
+	 * @param sample vehicle_attitude timestamp_sample
+	 * @param row Attitude dcm(2, 0), dcm(2, 1), dcm(2, 2)
+	 */
+	void update(hrt_abstime sample, const float row[3])
+	{
+		if (sample == _sample) {
+			return;
+		}
+
+		if (_sample == 0 || sample < _sample || sample - _sample > kMaxSampleInterval) {
+			// no usable previous sample, start over
+			for (int i = 0; i < 3; i++) {
+				_row_rate[i] = 0.f;
+			}
+
+		} else {
+			const float dt = (sample - _sample) * 1e-6f;
+			const float alpha = dt / (kRateTimeConstant + dt);
+
+			for (int i = 0; i < 3; i++) {
+				_row_rate[i] += alpha * ((row[i] - _row[i]) / dt - _row_rate[i]);
+			}
+		}
+
+		for (int i = 0; i < 3; i++) {
+			_row[i] = row[i];
+		}
+
+		_sample = sample;
+	}
+
+	/**
+	 * Project the attitude row at its current rate.
+	 *
+	 * @param row Current attitude dcm(2, 0..2)
+	 * @param horizon Look-ahead time [s]
+	 * @param predicted Projected attitude dcm(2, 0..2), normalized
+	 */
+	void predict_attitude(const float row[3], float horizon, float predicted[3]) const
+	{
+		float norm_sq = 0.f;
+
+		for (int i = 0; i < 3; i++) {
+			predicted[i] = row[i] + _row_rate[i] * horizon;
+			norm_sq += predicted[i] * predicted[i];
+		}
+
+		// the linear projection leaves the unit sphere (the row is gravity in body frame), pull it
+		// back so dcm(2, 0) is -sin(pitch) again for the pitch and gimbal lock tests
+		if (norm_sq > FLT_EPSILON) {
+			const float scale = 1.f / sqrtf(norm_sq);
+
+			for (int i = 0; i < 3; i++) {
+				predicted[i] *= scale;
+			}
+
+		} else {
+			for (int i = 0; i < 3; i++) {
+				predicted[i] = row[i];
+			}
+		}
+	}
+
+	/**
+	 * @param vz Vertical speed [m/s], positive down
+	 * @param az Vertical acceleration [m/s^2], positive down
+	 * @param horizon Look-ahead time [s]
+	 * @return Altitude lost over the horizon at constant acceleration [m], negative if climbing
+	 */
+	static float altitude_drop(float vz, float az, float horizon) { return (vz + 0.5f * az * horizon) * horizon; }
+
+private:
+	static constexpr float kRateTimeConstant = 0.05f;		// attitude rate low-pass [s]
+	static constexpr hrt_abstime kMaxSampleInterval = 100_ms;	// longer gaps restart the rate estimate
+
+	hrt_abstime _sample{0};		// timestamp_sample of _row
+	float _row[3] {};
+	float _row_rate[3] {};		// [1/s]
+};
+
+/**
+ * Scripted failure trajectories of the 'quadchute_replay' command, flown from the start of a front
+ * transition with estimator noise added.
+ */
+namespace quadchute_replay
+{
+
+static constexpr float kRate = 250.f;		// vehicle_attitude and vehicle_local_position rate [Hz]
+static constexpr float kDuration = 10.f;	// [s]
+static constexpr int kNumScenarios = 5;
+
+struct Truth {
+	float altitude;	// [m], the altitude at the start is the transition start altitude
+	float vz;	// [m/s], positive down
+	float az;	// [m/s^2], positive down
+	float roll;	// [rad]
+	float pitch;	// [rad]
+};
+
+struct Scenario {
+	const char *name;
+	void (*state)(float t, Truth &truth);
+};
+
+extern const Scenario kScenarios[kNumScenarios];
+
+/**
+ * Deterministic noise in [-1, 1], the sum of two uniform samples.
+ */
+float noise(uint32_t &seed);
+
+struct Report {
+	float horizon;		// look-ahead time the projected checks ran with, 0 if they did not run [s]
+	int current_step[kNumScenarios];	// first step a current check triggered, -1 if none
+	int lookahead_step[kNumScenarios];	// first step any check triggered, -1 if none
+};
+
+} // namespace quadchute_replay
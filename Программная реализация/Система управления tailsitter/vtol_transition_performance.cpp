@@ -0,0 +1,267 @@
+/**
+ * @file vtol_transition_performance.cpp
+ * @brief Transition performance grid, analytic model and measured tables.
+ */
+
+#include "vtol_transition_performance.h"
+
+#include <lib/atmosphere/atmosphere.h>
+#include <lib/mathlib/mathlib.h>
+#include <px4_platform_common/defines.h>
+#include <px4_platform_common/log.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+
+struct MeasuredTable {
+	float density[TransitionPerformanceGrid::kMaxTableNodes];
+	float weight_ratio[TransitionPerformanceGrid::kMaxTableNodes];
+	int density_nodes;
+	int weight_ratio_nodes;
+	int rows;
+	TransitionPerformance values[TransitionPerformanceGrid::kMaxTableNodes][TransitionPerformanceGrid::kMaxTableNodes];
+};
+
+TransitionPerformance lerp(const TransitionPerformance &a, const TransitionPerformance &b, float t)
+{
+	return TransitionPerformance{
+		a.transition_airspeed + t * (b.transition_airspeed - a.transition_airspeed),
+		a.min_time + t * (b.min_time - a.min_time),
+		a.open_loop_time + t * (b.open_loop_time - a.open_loop_time),
+		a.timeout + t * (b.timeout - a.timeout)};
+}
+
+/**
+ * Interval of x on an ascending axis, held at the first and last node outside of it.
+ */
+void axis_position(const float *axis, int nodes, float x, int &i, float &t)
+{
+	i = 0;
+	t = 0.f;
+
+	if (nodes < 2 || x <= axis[0]) {
+		return;
+	}
+
+	if (x >= axis[nodes - 1]) {
+		i = nodes - 2;
+		t = 1.f;
+		return;
+	}
+
+	while (x > axis[i + 1]) {
+		i++;
+	}
+
+	t = (x - axis[i]) / (axis[i + 1] - axis[i]);
+}
+
+/**
+ * @return Number of values parsed from text, -1 if there are more than max or anything else
+ */
+int parse_floats(const char *text, float *values, int max)
+{
+	int count = 0;
+
+	for (;;) {
+		while (*text == ' ' || *text == '\t') {
+			text++;
+		}
+
+		if (*text == '\0' || *text == '\n' || *text == '\r' || *text == '#') {
+			return count;
+		}
+
+		char *end;
+		const float value = strtof(text, &end);
+
+		if (end == text || count == max || !PX4_ISFINITE(value)) {
+			return -1;
+		}
+
+		values[count++] = value;
+		text = end;
+	}
+}
+
+bool ascending(const float *axis, int nodes)
+{
+	for (int i = 1; i < nodes; i++) {
+		if (!(axis[i] > axis[i - 1])) {
+			return false;
+		}
+	}
+
+	return nodes > 0;
+}
+
+/**
+ * Read a measured table. Text, '#' starts a comment, blank lines are ignored:
+ *
+ *   density 0.9 1.05 1.225          air densities [kg/m^3], ascending
+ *   weight 0.8 1.0 1.3              weight ratios, ascending
+ *   13.2 4.1 6.2 16.0               one row per density and weight ratio, density major:
+ *   ...                             transition airspeed [m/s], minimum, open-loop and timeout time [s]
+ *
+ * Up to kMaxTableNodes densities and weight ratios, a single one makes the values independent of it.
+ *
+ * @return nullptr on success, otherwise the reason
+ */
+const char *load_table(FILE *file, MeasuredTable &table, int &line_number)
+{
+	table.density_nodes = 0;
+	table.weight_ratio_nodes = 0;
+	table.rows = 0;
+
+	char line[128];
+	line_number = 0;
+
+	while (fgets(line, sizeof(line), file) != nullptr) {
+		line_number++;
+
+		if (strchr(line, '\n') == nullptr && !feof(file)) {
+			return "line too long";
+		}
+
+		if (strncmp(line, "density", 7) == 0) {
+			table.density_nodes = parse_floats(line + 7, table.density, TransitionPerformanceGrid::kMaxTableNodes);
+
+			if (!ascending(table.density, table.density_nodes) || table.density[0] <= 0.f) {
+				return "invalid densities";
+			}
+
+			continue;
+		}
+
+		if (strncmp(line, "weight", 6) == 0) {
+			table.weight_ratio_nodes = parse_floats(line + 6, table.weight_ratio, TransitionPerformanceGrid::kMaxTableNodes);
+
+			if (!ascending(table.weight_ratio, table.weight_ratio_nodes) || table.weight_ratio[0] <= 0.f) {
+				return "invalid weight ratios";
+			}
+
+			continue;
+		}
+
+		float row[4];
+		const int count = parse_floats(line, row, 4);
+
+		if (count == 0) {
+			continue;
+		}
+
+		if (table.density_nodes == 0 || table.weight_ratio_nodes == 0) {
+			return "values before the density and weight axes";
+		}
+
+		if (count != 4) {
+			return "expected airspeed, minimum, open-loop and timeout time";
+		}
+
+		if (table.rows == table.density_nodes * table.weight_ratio_nodes) {
+			return "more rows than densities x weight ratios";
+		}
+
+		if (row[0] <= 0.f || row[1] < 0.f || row[2] < row[1] || row[3] < 0.f) {
+			return "out of range (airspeed > 0, 0 <= minimum <= open-loop time, timeout >= 0)";
+		}
+
+		table.values[table.rows / table.weight_ratio_nodes][table.rows % table.weight_ratio_nodes] =
+			TransitionPerformance{row[0], row[1], row[2], row[3]};
+		table.rows++;
+	}
+
+	if (table.density_nodes == 0 || table.weight_ratio_nodes == 0
+	    || table.rows != table.density_nodes * table.weight_ratio_nodes) {
+		return "fewer rows than densities x weight ratios";
+	}
+
+	return nullptr;
+}
+
+} // namespace
+
+void TransitionPerformanceGrid::build(const TransitionPerformance &performance)
+{
+	// assumptions: transition_time = transition_true_airspeed / average_acceleration (thrust)
+	// transition_true_airspeed ~ sqrt(rho0 / rh0)
+	// average_acceleration ~ rho / rho0
+	// transition_time ~ sqrt(rho0/rh0) * rho0 / rho
+	for (int i = 0; i < kDensityNodes; i++) {
+		const float rho0_over_rho = atmosphere::kAirDensitySeaLevelStandardAtmos / (kDensityMin + i * kDensityStep);
+		const float time_factor = sqrtf(rho0_over_rho) * rho0_over_rho;
+
+		for (int j = 0; j < kWeightRatioNodes; j++) {
+			// Since the stall airspeed increases with vehicle weight, we increase the transition airspeed
+			// by the same factor.
+			_nodes[i][j] = TransitionPerformance{
+				sqrtf(kWeightRatioMin + j * kWeightRatioStep) * performance.transition_airspeed,
+				time_factor * performance.min_time,
+				time_factor * performance.open_loop_time,
+				time_factor * performance.timeout};
+		}
+	}
+}
+
+bool TransitionPerformanceGrid::load(const char *path)
+{
+	FILE *file = fopen(path, "r");
+
+	if (file == nullptr) {
+		PX4_ERR("transition table %s: cannot open", path);
+		return false;
+	}
+
+	MeasuredTable table;
+	int line_number;
+	const char *error = load_table(file, table, line_number);
+	fclose(file);
+
+	if (error != nullptr) {
+		PX4_ERR("transition table %s line %d: %s", path, line_number, error);
+		return false;
+	}
+
+	// resample onto the grid, the measured values are held beyond the measured range
+	for (int i = 0; i < kDensityNodes; i++) {
+		int density_index;
+		float density_t;
+		axis_position(table.density, table.density_nodes, kDensityMin + i * kDensityStep, density_index, density_t);
+		const int density_next = math::min(density_index + 1, table.density_nodes - 1);
+
+		for (int j = 0; j < kWeightRatioNodes; j++) {
+			int weight_index;
+			float weight_t;
+			axis_position(table.weight_ratio, table.weight_ratio_nodes, kWeightRatioMin + j * kWeightRatioStep,
+				      weight_index, weight_t);
+			const int weight_next = math::min(weight_index + 1, table.weight_ratio_nodes - 1);
+
+			_nodes[i][j] = lerp(lerp(table.values[density_index][weight_index], table.values[density_index][weight_next], weight_t),
+					    lerp(table.values[density_next][weight_index], table.values[density_next][weight_next], weight_t),
+					    density_t);
+		}
+	}
+
+	return true;
+}
+
+TransitionPerformance TransitionPerformanceGrid::lookup(float density, float weight_ratio) const
+{
+	if (!PX4_ISFINITE(density)) {
+		density = atmosphere::kAirDensitySeaLevelStandardAtmos;
+	}
+
+	const float x = (math::constrain(density, kDensityMin, kDensityMax) - kDensityMin) * (1.f / kDensityStep);
+	const float y = (math::constrain(weight_ratio, kWeightRatioMin, kWeightRatioMax) - kWeightRatioMin) *
+			(1.f / kWeightRatioStep);
+
+	const int i = math::min(static_cast<int>(x), kDensityNodes - 2);
+	const int j = math::min(static_cast<int>(y), kWeightRatioNodes - 2);
+
+	return lerp(lerp(_nodes[i][j], _nodes[i][j + 1], y - j), lerp(_nodes[i + 1][j], _nodes[i + 1][j + 1], y - j), x - i);
+}
@@ -0,0 +1,158 @@
+/**
+ * @file vtol_transition_performance.h
+ * @brief Front transition airspeed and times over air density and vehicle weight.
+ *
+ * The values are held on a uniform grid over air density and weight ratio (WEIGHT_GROSS /
+ * WEIGHT_BASE), filled at parameter change either from the analytic model or from a table
+ * measured on the airframe, and read by bilinear interpolation. A lookup costs the same for
+ * either source and at any density.
+ */
+
+#pragma once
+
+#include <px4_platform_common/atomic.h>
+
+#include <stdint.h>
+
+struct TransitionPerformance {
+	float transition_airspeed;	// calibrated [m/s]
+	float min_time;			// minimum front transition time [s]
+	float open_loop_time;		// open-loop front transition time [s]
+	float timeout;			// front transition timeout [s], 0 if disabled
+};
+
+class TransitionPerformanceGrid
+{
+public:
+	// low value: hot day at 4000m AMSL with some margin
+	// high value: cold day at 0m AMSL with some margin
+	static constexpr float kDensityMin = 0.7f;	// [kg/m^3]
+	static constexpr float kDensityMax = 1.5f;	// [kg/m^3]
+	static constexpr int kDensityNodes = 17;
+
+	// range of the ratio between the actual vehicle weight and the vehicle nominal weight (weight at
+	// which the performance limits are derived)
+	static constexpr float kWeightRatioMin = 0.5f;
+	static constexpr float kWeightRatioMax = 2.0f;
+	static constexpr int kWeightRatioNodes = 13;
+
+	static constexpr int kMaxTableNodes = 6;	// per axis of a measured table
+
+	/**
+	 * Fill the grid from the analytic model: the transition airspeed grows with the square root of
+	 * the weight ratio (as the stall speed), the times with (rho0 / rho)^1.5.
+	 *
+	 * @param performance Values at the nominal weight and sea level standard density
+	 */
+	void build(const TransitionPerformance &performance);
+
+	/**
+	 * Fill the grid from a measured table, see load_table() in the .cpp for the format.
+	 * The table is interpolated onto the grid, so next to a kink of the measured values the lookup
+	 * can deviate from them by the slope change over one grid step.
+	 * The grid is unchanged if the file cannot be read or is malformed.
+	 *
+	 * @return true on success
+	 */
+	bool load(const char *path);
+
+	/**
+	 * @param density Air density [kg/m^3], sea level standard if not finite, clamped to the grid
+	 * @param weight_ratio WEIGHT_GROSS / WEIGHT_BASE, clamped to the grid
+	 */
+	TransitionPerformance lookup(float density, float weight_ratio) const;
+
+private:
+	static constexpr float kDensityStep = (kDensityMax - kDensityMin) / (kDensityNodes - 1);
+	static constexpr float kWeightRatioStep = (kWeightRatioMax - kWeightRatioMin) / (kWeightRatioNodes - 1);
+
+	TransitionPerformance _nodes[kDensityNodes][kWeightRatioNodes] {};
+};
+
+/**
+ * Hands a measured grid from the work item that reads it from the file system to the controller.
+ *
+ * The writer fills the grid only after claiming it and publishes it with a new generation, the
+ * reader copies it only after claiming it, so neither ever sees a partial grid and neither blocks:
+ * a claim that fails is retried on the next run.
+ */
+class TransitionTableHandover
+{
+public:
+	enum class CopyResult {
+		Copied,		// measured grid copied
+		NoTable,	// no measured grid (disabled or unreadable), use the analytic model
+		Busy		// being written, retry
+	};
+
+	/**
+	 * Claim the grid for writing.
+	 *
+	 * @return false while the reader copies it, retry later
+	 */
+	bool begin_write()
+	{
+		int state = static_cast<int>(State::Empty);
+
+		if (_state.compare_exchange(&state, static_cast<int>(State::Writing))) {
+			return true;
+		}
+
+		state = static_cast<int>(State::Ready);
+		return _state.compare_exchange(&state, static_cast<int>(State::Writing));
+	}
+
+	TransitionPerformanceGrid &grid() { return _grid; }
+
+	/**
+	 * Publish the grid written since begin_write().
+	 *
+	 * @param valid false if there is no measured grid
+	 */
+	void end_write(bool valid)
+	{
+		_state.store(static_cast<int>(valid ? State::Ready : State::Empty));
+		_generation.fetch_add(1);
+	}
+
+	/**
+	 * @return Incremented on every end_write()
+	 */
+	uint32_t generation() const { return _generation.load(); }
+
+	/**
+	 * @param grid Set to the measured grid if Copied
+	 * @param generation Set to the generation handed over if Copied or NoTable
+	 */
+	CopyResult copy(TransitionPerformanceGrid &grid, uint32_t &generation)
+	{
+		const uint32_t published = _generation.load();
+		int state = static_cast<int>(State::Ready);
+
+		if (_state.compare_exchange(&state, static_cast<int>(State::Reading))) {
+			grid = _grid;
+			generation = published;
+			_state.store(static_cast<int>(State::Ready));
+			return CopyResult::Copied;
+		}
+
+		if (state == static_cast<int>(State::Empty)) {
+			generation = published;
+			return CopyResult::NoTable;
+		}
+
+		return CopyResult::Busy;
+	}
+
+private:
+	enum class State : int {
+		Empty = 0,
+		Writing,
+		Ready,
+		Reading
+	};
+
+	px4::atomic<int> _state{static_cast<int>(State::Empty)};
+	px4::atomic<uint32_t> _generation{0};
+	TransitionPerformanceGrid _grid;
+};
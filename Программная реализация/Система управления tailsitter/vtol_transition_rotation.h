@@ -0,0 +1,87 @@
+/**
+ * @file vtol_transition_rotation.h
+ * @brief Tailsitter transition attitude setpoint, rotated about a fixed axis.
+ *
+ * Rotations about a fixed axis compose by adding their angles, so the setpoint is advanced by the
+ * angle elapsed since the last update. The step quaternion uses the Taylor series of sin/cos of the
+ * half angle (error below 1e-10 for steps up to kMaxStep). Every kResyncSteps steps, and for larger
+ * steps, the setpoint is recomputed from the closed form, which bounds the drift.
+ */
+
+#pragma once
+
+#include <matrix/matrix/math.hpp>
+
+#include <math.h>
+
+class TransitionRotation
+{
+public:
+	static constexpr int kResyncSteps = 50;		// incremental steps between two exact resyncs
+	static constexpr float kMaxStep = 0.05f;	// [rad] larger steps are computed exactly
+
+	/**
+	 * @param q_start Attitude setpoint at the transition start
+	 * @param axis Rotation axis of the transition
+	 */
+	void start(const matrix::Quatf &q_start, const matrix::Vector3f &axis)
+	{
+		_q_start = q_start;
+		_q_start.normalize();
+		_axis = axis;
+		_axis.normalize();
+		_q = _q_start;
+		_angle = 0.f;
+		_steps = 0;
+	}
+
+	/**
+	 * Rotate the setpoint to the given angle.
+	 *
+	 * @param angle Rotation from the transition start attitude [rad]
+	 */
+	void rotate_to(float angle)
+	{
+		const float step = angle - _angle;
+
+		if (++_steps >= kResyncSteps || fabsf(step) > kMaxStep) {
+			_q = closed_form(_q_start, _axis, angle);
+			_steps = 0;
+
+		} else {
+			const float half = 0.5f * step;
+			const float half_sq = half * half;
+			const float c = 1.f - half_sq * (0.5f - half_sq * (1.f / 24.f));
+			const float s = half * (1.f - half_sq * (1.f / 6.f));
+
+			_q = matrix::Quatf(c, s * _axis(0), s * _axis(1), s * _axis(2)) * _q;
+		}
+
+		_angle = angle;
+	}
+
+	/**
+	 * @return Attitude setpoint, normalized up to the drift between two resyncs
+	 */
+	const matrix::Quatf &setpoint() const { return _q; }
+
+	/**
+	 * @return q_start rotated by angle about axis (a unit vector)
+	 */
+	static matrix::Quatf closed_form(const matrix::Quatf &q_start, const matrix::Vector3f &axis, float angle)
+	{
+		matrix::Quatf q = matrix::Quatf(matrix::AxisAnglef(axis, angle)) * q_start;
+		q.normalize();
+		return q;
+	}
+
+	const matrix::Quatf &start_attitude() const { return _q_start; }
+	const matrix::Vector3f &axis() const { return _axis; }
+
+private:
+	matrix::Quatf _q_start;
+	matrix::Quatf _q;
+	matrix::Vector3f _axis;		// unit rotation axis
+	float _angle{0.f};		// [rad] rotation of _q from _q_start
+	int _steps{0};			// incremental steps since the last exact resync
+};
@@ -0,0 +1,93 @@
+/**
+ * @file vtol_transition_schedule.h
+ * @brief Transition profiles sampled into lookup tables.
+ *
+ * A schedule maps the time since the transition start, or the airspeed, to a tilt, pitch,
+ * throttle or MC weight. It is sampled from the shaped profile whenever the parameters or the
+ * air density change and evaluated by linear interpolation between uniformly spaced knots,
+ * so a shaped profile costs the same per cycle as a linear one and no division is left on
+ * the control path.
+ */
+
+#pragma once
+
+#include <lib/mathlib/mathlib.h>
+
+#include <math.h>
+
+class TransitionSchedule
+{
+public:
+	static constexpr int kSegments = 16;
+
+	/**
+	 * @param progress Progress through the profile [0, 1]
+	 * @param shape 0 for linear, positive to start slowly and finish fast (cubic expo), negative for the reverse [-1, 1]
+	 * @return Shaped progress [0, 1]
+	 */
+	static float shaped(float progress, float shape)
+	{
+		if (shape >= 0.f) {
+			return math::expo(progress, shape);
+		}
+
+		return 1.f - math::expo(1.f - progress, -shape);
+	}
+
+	/**
+	 * Sample value(x) = start + (end - start) * shaped((x - x_begin) / (x_end - x_begin), shape).
+	 *
+	 * Below x_begin the value is start. Above x_end it is end, or the last segment continued if extend
+	 * is set. If x_end is not above x_begin the schedule is a step from start to end after x_begin.
+	 *
+	 * @param extend Continue the last segment instead of holding the end value
+	 */
+	void build(float x_begin, float x_end, float start, float end, float shape, bool extend = false)
+	{
+		_x_begin = x_begin;
+		_extend = extend;
+
+		if (x_end - x_begin > FLT_EPSILON) {
+			_inv_step = kSegments / (x_end - x_begin);
+
+			for (int i = 0; i < kSegments; i++) {
+				_values[i] = start + (end - start) * shaped(static_cast<float>(i) / kSegments, shape);
+			}
+
+			// exactly, start + (end - start) can round below end and thresholds on it would never be reached
+			_values[kSegments] = end;
+
+		} else {
+			_inv_step = INFINITY;
+			_extend = false;
+			_values[0] = start;
+
+			for (int i = 1; i <= kSegments; i++) {
+				_values[i] = end;
+			}
+		}
+	}
+
+	float evaluate(float x) const
+	{
+		const float position = (x - _x_begin) * _inv_step;
+
+		if (!(position > 0.f)) {
+			return _values[0];
+		}
+
+		if (position >= kSegments) {
+			return _extend ? _values[kSegments] + (position - kSegments) * (_values[kSegments] - _values[kSegments - 1])
+			       : _values[kSegments];
+		}
+
+		const int i = static_cast<int>(position);
+		return _values[i] + (position - i) * (_values[i + 1] - _values[i]);
+	}
+
+private:
+	float _x_begin{0.f};
+	float _inv_step{INFINITY};	// knots per unit of x
+	bool _extend{false};
+	float _values[kSegments + 1] {};
+};
@@ -8,21 +8,54 @@
 
 #include "vtol_type.h"
 #include "vtol_att_control_main.h"
+#include "vtol_fast_trig.h"
 
 #include <float.h>
 #include <px4_platform_common/defines.h>
 #include <matrix/math.hpp>
-#include <lib/atmosphere/atmosphere.h>
+#include <string.h>
 
 using namespace matrix;
 
 #define THROTTLE_BLENDING_DUR_S 1.0f
 
-// [.] minimum ratio between the actual vehicle weight and the vehicle nominal weight (weight at which the performance limits are derived)
-static constexpr float kMinWeightRatio = 0.5f;
+// [kg/m^3] air density change that triggers a refresh of the density scaled transition times (~1% in time)
+static constexpr float kAirDensityHysteresis = 0.01f;
 
-// [.] maximum ratio between the actual vehicle weight and the vehicle nominal weight (weight at which the performance limits are derived)
-static constexpr float kMaxWeightRatio = 2.0f;
+// [.] |dcm(2, 0)| above which matrix::Eulerf treats the rotation as gimbal locked (pitch within 1e-3 rad of +-90 deg)
+static constexpr float kGimbalLockSinPitch = 0.9999995f;
+
+/**
+ * @return Unit vector (cos(yaw), sin(yaw)) of the rotation q, yaw as matrix::Eulerf defines it
+ * (including its gimbal lock convention) but without computing the angle
+ */
+static Vector2f heading_of(const Quatf &q)
+{
+	const float r20 = 2.f * (q(1) * q(3) - q(0) * q(2));
+
+	if (fabsf(r20) > kGimbalLockSinPitch) {
+		// yaw from the body z axis, sign flipped for pitch -90 deg
+		const float sign = r20 < 0.f ? 1.f : -1.f;
+		return Vector2f(sign * 2.f * (q(0) * q(2) + q(1) * q(3)), sign * 2.f * (q(2) * q(3) - q(0) * q(1))).normalized();
+	}
+
+	return Vector2f(q(0) * q(0) + q(1) * q(1) - q(2) * q(2) - q(3) * q(3), 2.f * (q(1) * q(2) + q(0) * q(3))).normalized();
+}
+
+/**
+ * @return (cos(a / 2), sin(a / 2)) for a in (-pi, pi] given as the unit vector (cos(a), sin(a)),
+ * computed from the larger of the two so neither small nor large angles lose precision
+ */
+static Vector2f half_angle(float cos_a, float sin_a)
+{
+	if (cos_a >= 0.f) {
+		const float cos_half = sqrtf(0.5f * (1.f + cos_a));
+		return Vector2f(cos_half, 0.5f * sin_a / cos_half);
+	}
+
+	const float sin_half = copysignf(sqrtf(0.5f * (1.f - cos_a)), sin_a);
+	return Vector2f(0.5f * sin_a / sin_half, sin_half);
+}
 
 /**
  * @brief Constructor for the VtolType class.
@@ -32,27 +65,14 @@ static constexpr float kMaxWeightRatio = 2.0f;
 VtolType::VtolType(VtolAttitudeControl *att_controller) :
 	ModuleParams(nullptr),
 	_attc(att_controller),
-	_common_vtol_mode(mode::ROTARY_WING)
+	_common_vtol_mode(mode::ROTARY_WING),
+	_io(att_controller->get_io()),
+	_attitude(&_io->in)
 {
-	_v_att = _attc->get_att();
 	_v_att_sp = _attc->get_att_sp();
 	_mc_virtual_att_sp = _attc->get_mc_virtual_att_sp();
 	_fw_virtual_att_sp = _attc->get_fw_virtual_att_sp();
-	_v_control_mode = _attc->get_control_mode();
 	_vtol_vehicle_status = _attc->get_vtol_vehicle_status();
-	_vehicle_torque_setpoint_virtual_mc = _attc->get_vehicle_torque_setpoint_virtual_mc();
-	_vehicle_torque_setpoint_virtual_fw = _attc->get_vehicle_torque_setpoint_virtual_fw();
-	_vehicle_thrust_setpoint_virtual_mc = _attc->get_vehicle_thrust_setpoint_virtual_mc();
-	_vehicle_thrust_setpoint_virtual_fw = _attc->get_vehicle_thrust_setpoint_virtual_fw();
-	_torque_setpoint_0 = _attc->get_torque_setpoint_0();
-	_torque_setpoint_1 = _attc->get_torque_setpoint_1();
-	_thrust_setpoint_0 = _attc->get_thrust_setpoint_0();
-	_thrust_setpoint_1 = _attc->get_thrust_setpoint_1();
-	_local_pos = _attc->get_local_pos();
-	_local_pos_sp = _attc->get_local_pos_sp();
-	_airspeed_validated = _attc->get_airspeed();
-	_tecs_status = _attc->get_tecs_status();
-	_land_detected = _attc->get_land_detected();
 }
 
 /**
@@ -62,6 +82,8 @@ VtolType::VtolType(VtolAttitudeControl *att_controller) :
 
 bool VtolType::init()
 {
+	update_transition_performance();
+	update_derived_params();
 	return true;
 }
 
@@ -81,12 +103,40 @@ void VtolType::parameters_update()
 	_param_vt_f_tr_ol_tm.set(math::max(_param_vt_f_tr_ol_tm.get(), _param_vt_trans_min_tm.get()));
 }
 
+/**
+ * @brief Inputs consumed by the common VTOL logic in the given mode.
+ *
+ * The local position is always needed, it tracks EKF altitude resets and provides the
+ * altitude at the start of a transition. Fixed-wing flight and transitions run the quadchute checks.
+ */
+
+uint16_t VtolType::get_input_set(mode vtol_mode) const
+{
+	uint16_t inputs = INPUT_CONTROL_MODE | INPUT_LOCAL_POSITION;
+
+	switch (vtol_mode) {
+	case mode::ROTARY_WING:
+		break;
+
+	case mode::FIXED_WING:
+		inputs |= INPUT_ATTITUDE | INPUT_TECS_STATUS | INPUT_LAND_DETECTED;
+		break;
+
+	case mode::TRANSITION_TO_FW:
+	case mode::TRANSITION_TO_MC:
+		inputs |= INPUT_ATTITUDE | INPUT_AIRSPEED | INPUT_TECS_STATUS | INPUT_LAND_DETECTED;
+		break;
+	}
+
+	return inputs;
+}
+
 /**
  * @brief Updates the state in multicopter mode.
  * Resets attitude and weight for multicopter control.
  */
 
-void VtolType::update_mc_state()
+void VtolType::update_mc_state(const VtolControlCycle &)
 {
 	resetAccelToPitchPitchIntegrator();
 
@@ -104,10 +154,10 @@ void VtolType::update_mc_state()
  * Resets integrators and handles transitions to fixed-wing mode.
  */
 
-void VtolType::update_fw_state()
+void VtolType::update_fw_state(const VtolControlCycle &cycle)
 {
 	resetAccelToPitchPitchIntegrator();
-	_last_thr_in_fw_mode =  _vehicle_thrust_setpoint_virtual_fw->xyz[0];
+	_last_thr_in_fw_mode =  _io->in.fw_thrust.xyz[0];
 
 	// copy virtual attitude setpoint to real attitude setpoint
 	memcpy(_v_att_sp, _fw_virtual_att_sp, sizeof(vehicle_attitude_setpoint_s));
@@ -116,66 +166,64 @@ void VtolType::update_fw_state()
 	_mc_yaw_weight = 0.0f;
 
 	// tecs didn't publish an update yet after the transition
-	if (_tecs_status->timestamp < _trans_finished_ts) {
+	if (_io->in.tecs_timestamp < _trans_finished_ts) {
 		_tecs_running = false;
 
 	} else if (!_tecs_running) {
 		_tecs_running = true;
-		_tecs_running_ts = hrt_absolute_time();
+		_tecs_running_ts = cycle.now;
 	}
 
 	// TECS didn't publish yet or the position controller didn't publish yet AFTER tecs
 	// only wait on TECS we're in a mode where it is actually running
 	if ((!_tecs_running || (_tecs_running && _fw_virtual_att_sp->timestamp <= _tecs_running_ts))
-	    && _v_control_mode->flag_control_altitude_enabled) {
+	    && _io->in.altitude_control) {
 
 		waiting_on_tecs();
-		_throttle_blend_start_ts = hrt_absolute_time();
+		_throttle_blend_start_ts = cycle.now;
 
 	} else if (shouldBlendThrottleAfterFrontTransition()) {
-		const float progress = (float)(hrt_absolute_time() - _throttle_blend_start_ts) * 1e-6f / THROTTLE_BLENDING_DUR_S;
+		const float blend_time = (float)(cycle.now - _throttle_blend_start_ts) * 1e-6f;
 
-		if (progress >= 1.0f) {
+		if (blend_time >= THROTTLE_BLENDING_DUR_S) {
 			stopBlendingThrottleAfterFrontTransition();
 
 		} else {
-			blendThrottleAfterFrontTransition(progress);
+			blendThrottleAfterFrontTransition(_throttle_blend_schedule.evaluate(blend_time));
 		}
 	}
 
-	check_quadchute_condition();
+	check_quadchute_condition(cycle);
 }
 
 /**
  * @brief Updates the state during the transition phase.
  *
- * Updates timestamps, handles transition timing, checks for quadchute conditions,
+ * Updates the elapsed transition time from the cycle time, checks for quadchute conditions,
  * and adjusts throttle blending.
  */
 
-void VtolType::update_transition_state()
+void VtolType::update_transition_state(const VtolControlCycle &cycle)
 {
-	hrt_abstime t_now = hrt_absolute_time();
-	_transition_dt = (float)(t_now - _last_loop_ts) / 1e6f;
-	_transition_dt = math::constrain(_transition_dt, 0.0001f, 0.02f);
-	_last_loop_ts = t_now;
-	_throttle_blend_start_ts = t_now;
+	_throttle_blend_start_ts = cycle.now;
 
-	_time_since_trans_start = (float)(t_now - _transition_start_timestamp) * 1e-6f;
+	_time_since_trans_start = (float)(cycle.now - _transition_start_timestamp) * 1e-6f;
 
-	check_quadchute_condition();
+	check_quadchute_condition(cycle);
 
-	_last_thr_in_mc = _vehicle_thrust_setpoint_virtual_mc->xyz[2];
+	_last_thr_in_mc = _io->in.mc_thrust.xyz[2];
 }
 
-float VtolType::update_and_get_backtransition_pitch_sp()
+float VtolType::update_and_get_backtransition_pitch_sp(float dt)
 {
 	// maximum up or down pitch the controller is allowed to demand
 	const float pitch_lim = 0.3f;
-	const Eulerf euler(Quatf(_v_att->q));
 
-	const float track = atan2f(_local_pos->vy, _local_pos->vx);
-	const float accel_body_forward = cosf(track) * _local_pos->ax + sinf(track) * _local_pos->ay;
+	// acceleration along the horizontal track, which is the projection onto the velocity direction
+	// (cos(track), sin(track)) = (vx, vy) / |v|, no trigonometry needed; along north when not moving
+	const float speed_xy = sqrtf(_io->in.vx * _io->in.vx + _io->in.vy * _io->in.vy);
+	const float accel_body_forward = speed_xy > FLT_EPSILON ?
+					 (_io->in.vx * _io->in.ax + _io->in.vy * _io->in.ay) / speed_xy : _io->in.ax;
 
 	// increase the target deceleration setpoint provided to the controller by 20%
 	// to make overshooting the transition waypoint less likely in the presence of tracking errors
@@ -193,7 +241,7 @@ float VtolType::update_and_get_backtransition_pitch_sp()
 		integrator_input = 0.0f;
 	}
 
-	_accel_to_pitch_integ += integrator_input * _transition_dt;
+	_accel_to_pitch_integ += integrator_input * dt;
 
 	// only allow positive (pitch up) pitch setpoint
 	return math::constrain(pitch_sp_new, 0.f, pitch_lim);
@@ -229,7 +277,7 @@ bool VtolType::isFrontTransitionCompleted()
 bool VtolType::isFrontTransitionCompletedBase()
 {
 	// continue the transition to fw mode while monitoring airspeed for a final switch to fw mode
-	const bool airspeed_triggers_transition = PX4_ISFINITE(_airspeed_validated->calibrated_airspeed_m_s)
+	const bool airspeed_triggers_transition = PX4_ISFINITE(_io->in.calibrated_airspeed)
 			&& _param_fw_use_airspd.get();
 	const bool minimum_trans_time_elapsed = _time_since_trans_start > getMinimumFrontTransitionTime();
 	const bool openloop_trans_time_elapsed = _time_since_trans_start > getOpenLoopFrontTransitionTime();
@@ -238,7 +286,7 @@ bool VtolType::isFrontTransitionCompletedBase()
 
 	if (airspeed_triggers_transition) {
 		transition_to_fw = minimum_trans_time_elapsed
-				   && _airspeed_validated->calibrated_airspeed_m_s >= getTransitionAirspeed();
+				   && _io->in.calibrated_airspeed >= getTransitionAirspeed();
 
 	} else {
 		transition_to_fw = openloop_trans_time_elapsed;
@@ -259,7 +307,7 @@ bool VtolType::isFrontTransitionCompletedBase()
 
 bool VtolType::can_transition_on_ground()
 {
-	return !_v_control_mode->flag_armed || _land_detected->landed;
+	return !_io->in.armed || _io->in.landed;
 }
 
 /**
@@ -270,43 +318,51 @@ bool VtolType::can_transition_on_ground()
  * transition is initiated.
  */
 
-void VtolType::resetTransitionStates()
+void VtolType::resetTransitionStates(const VtolControlCycle &cycle)
 {
-	_transition_start_timestamp = hrt_absolute_time();
+	_transition_start_timestamp = cycle.now;
 	_time_since_trans_start = 0.f;
-	_local_position_z_start_of_transition = _local_pos->z;
+	_local_position_z_start_of_transition = _io->in.z;
 }
 
 /**
- * @brief Check if quadchute is enabled.
+ * @brief Altitude above ground.
  *
- * This function checks if the vehicle is above the quadchute altitude limit and if the quadchute
- * feature is armed and enabled, indicating that a quadchute maneuver might be needed.
+ * Local z-position or altitude above home or distance sensor altitude depending on what's available.
  *
- * @return true if quadchute is enabled, false otherwise.
+ * @return Distance to ground [m].
  */
 
-bool VtolType::isQuadchuteEnabled()
+float VtolType::getDistanceToGround() const
 {
-	float dist_to_ground = 0.f;
 	const float home_position_z = _attc->get_home_position_z();
 
-	if (_local_pos->dist_bottom_valid) {
-		dist_to_ground = _local_pos->dist_bottom;
+	if (_io->in.dist_bottom_valid) {
+		return _io->in.dist_bottom;
 
 	} else if (PX4_ISFINITE(home_position_z)) {
-		dist_to_ground = -(_local_pos->z - home_position_z);
+		return -(_io->in.z - home_position_z);
+	}
 
-	} else {
-		dist_to_ground = -_local_pos->z;
+	return -_io->in.z;
+}
 
-	}
+/**
+ * @brief Check if quadchute is enabled.
+ *
+ * This function checks if the vehicle is above the quadchute altitude limit and if the quadchute
+ * feature is armed and enabled, indicating that a quadchute maneuver might be needed.
+ *
+ * @return true if quadchute is enabled, false otherwise.
+ */
 
+bool VtolType::isQuadchuteEnabled(const QuadchuteInputs &inputs) const
+{
 	const bool above_quadchute_altitude_limit = _param_quadchute_max_height.get() > 0
-			&& dist_to_ground > (float)_param_quadchute_max_height.get();
+			&& inputs.dist_to_ground > (float)_param_quadchute_max_height.get();
 
-	return _v_control_mode->flag_armed &&
-	       !_land_detected->landed && !above_quadchute_altitude_limit;
+	return _io->in.armed &&
+	       !_io->in.landed && !above_quadchute_altitude_limit;
 
 }
 
@@ -319,12 +375,12 @@ bool VtolType::isQuadchuteEnabled()
  * @return true if the minimum altitude has been breached, false otherwise.
  */
 
-bool VtolType::isMinAltBreached()
+bool VtolType::isMinAltBreached(const QuadchuteInputs &inputs)
 {
 	// fixed-wing minimum altitude
 	if (_param_vt_fw_min_alt.get() > FLT_EPSILON) {
 
-		if (-(_local_pos->z) < _param_vt_fw_min_alt.get()) {
+		if (-(_io->in.z) < _param_vt_fw_min_alt.get()) {
 			return true;
 
 		}
@@ -333,31 +389,91 @@ bool VtolType::isMinAltBreached()
 	return false;
 }
 
+/**
+ * @brief Check if the minimum altitude will be breached within the look-ahead time.
+ *
+ * Same as isMinAltBreached() on the altitude projected with the current vertical speed and acceleration.
+ *
+ * @return true if the projected altitude is below the minimum altitude, false otherwise.
+ */
+
+bool VtolType::isMinAltBreachPredicted(const QuadchuteInputs &inputs)
+{
+	return -(_io->in.z + inputs.predicted_drop) < _param_vt_fw_min_alt.get();
+}
+
+/**
+ * @brief Shortfall of the altitude against the TECS altitude reference.
+ *
+ * The reference is only usable while TECS controls the altitude, the local altitude is valid
+ * and global and the last tecs_status is less than 1s old.
+ *
+ * @return TECS altitude reference minus the current altitude (AMSL) [m], NAN if the reference is not usable.
+ */
+
+float VtolType::getTecsAltitudeShortfall(hrt_abstime now) const
+{
+	// TECS may have published after the cycle time was sampled
+	const hrt_abstime tecs_status_age = now > _io->in.tecs_timestamp ? now - _io->in.tecs_timestamp : 0;
+
+	if (_io->in.z_valid && _io->in.z_global && _io->in.altitude_control
+	    && PX4_ISFINITE(_io->in.tecs_altitude_reference)
+	    && tecs_status_age < 1_s) {
+
+		return _io->in.tecs_altitude_reference - (-_io->in.z + _io->in.ref_alt);
+	}
+
+	return NAN;
+}
+
+/**
+ * @brief Add the current sample to the quadchute altitude window.
+ *
+ * The window holds the local altitude, for the transition altitude loss, and the TECS shortfall,
+ * for the uncommanded descent. Samples without a usable TECS reference are stored with an infinitely
+ * negative shortfall, so the uncommanded descent needs a usable reference over the whole window.
+ */
+
+void VtolType::updateAltitudeWindow(hrt_abstime now)
+{
+	if (!_io->in.z_valid) {
+		_altitude_window.reset();
+		return;
+	}
+
+	const float shortfall = getTecsAltitudeShortfall(now);
+	_altitude_window.update(now, -_io->in.z, PX4_ISFINITE(shortfall) ? shortfall : -INFINITY);
+}
+
 /**
  * @brief Check for uncommanded descent.
  *
  * This function checks if the vehicle is descending without command during
  * fixed-wing flight and if the descent exceeds the configured altitude loss threshold.
+ * With VT_QC_WINDOW set the shortfall against the TECS altitude reference has to exceed the
+ * threshold over the whole window while the altitude is still decreasing.
  *
  * @return true if the vehicle is in an uncommanded descent, false otherwise.
  */
 
-bool VtolType::isUncommandedDescent()
+bool VtolType::isUncommandedDescent(const QuadchuteInputs &inputs)
 {
-	const float current_altitude = -_local_pos->z + _local_pos->ref_alt;
+	if (_derived.qc_window > 0.f) {
+		return _altitude_window.full() && _altitude_window.min_shortfall() > _param_vt_qc_alt_loss.get()
+		       && _altitude_window.descent_rate() > 0.f;
+	}
+
+	const float shortfall = getTecsAltitudeShortfall(inputs.now);
 
-	if (_param_vt_qc_alt_loss.get() > FLT_EPSILON && _local_pos->z_valid && _local_pos->z_global
-	    && _v_control_mode->flag_control_altitude_enabled
-	    && PX4_ISFINITE(_tecs_status->altitude_reference)
-	    && (current_altitude < _tecs_status->altitude_reference)
-	    && hrt_elapsed_time(&_tecs_status->timestamp) < 1_s) {
+	if (_param_vt_qc_alt_loss.get() > FLT_EPSILON && shortfall > 0.f) {
+		const float current_altitude = -_io->in.z + _io->in.ref_alt;
 
 		if (!PX4_ISFINITE(_quadchute_ref_alt)) {
 			_quadchute_ref_alt = current_altitude;
 		}
 
 		_quadchute_ref_alt = math::min(math::max(_quadchute_ref_alt, current_altitude),
-					       _tecs_status->altitude_reference);
+					       _io->in.tecs_altitude_reference);
 
 		return (_quadchute_ref_alt - current_altitude) > _param_vt_qc_alt_loss.get();
 
@@ -373,24 +489,49 @@ bool VtolType::isUncommandedDescent()
  *
  * This function monitors altitude loss during the front transition to fixed-wing mode,
  * comparing the current altitude with the altitude at the start of the transition.
+ * With VT_QC_WINDOW set the highest altitude over the whole window is compared instead.
  *
  * @return true if the altitude loss exceeds the configured threshold, false otherwise.
  */
 
-bool VtolType::isFrontTransitionAltitudeLoss()
+bool VtolType::isFrontTransitionAltitudeLoss(const QuadchuteInputs &inputs)
 {
 	bool result = false;
 
-	// only run if param set, altitude valid and controlled, and in transition to FW or within 5s of finishing it.
-	if (_param_vt_qc_t_alt_loss.get() > FLT_EPSILON && _local_pos->z_valid && _v_control_mode->flag_control_altitude_enabled
-	    && (_common_vtol_mode == mode::TRANSITION_TO_FW || hrt_elapsed_time(&_trans_finished_ts) < 5_s)) {
+	if (isFrontTransitionAltitudeMonitored(inputs.now)) {
+		if (_derived.qc_window > 0.f) {
+			result = _altitude_window.full()
+				 && -_local_position_z_start_of_transition - _altitude_window.max_altitude() > _param_vt_qc_t_alt_loss.get();
 
-		result = _local_pos->z - _local_position_z_start_of_transition > _param_vt_qc_t_alt_loss.get();
+		} else {
+			result = _io->in.z - _local_position_z_start_of_transition > _param_vt_qc_t_alt_loss.get();
+		}
 	}
 
 	return result;
 }
 
+/**
+ * @brief Check for altitude loss during front transition within the look-ahead time.
+ *
+ * Same as isFrontTransitionAltitudeLoss() on the altitude projected with the current vertical speed and acceleration.
+ *
+ * @return true if the projected altitude loss exceeds the configured threshold, false otherwise.
+ */
+
+bool VtolType::isFrontTransitionAltitudeLossPredicted(const QuadchuteInputs &inputs)
+{
+	return isFrontTransitionAltitudeMonitored(inputs.now)
+	       && _io->in.z + inputs.predicted_drop - _local_position_z_start_of_transition > _param_vt_qc_t_alt_loss.get();
+}
+
+bool VtolType::isFrontTransitionAltitudeMonitored(hrt_abstime now) const
+{
+	// only run if param set, altitude valid and controlled, and in transition to FW or within 5s of finishing it.
+	return _param_vt_qc_t_alt_loss.get() > FLT_EPSILON && _io->in.z_valid && _io->in.altitude_control
+	       && (_common_vtol_mode == mode::TRANSITION_TO_FW || now - _trans_finished_ts < 5_s);
+}
+
 /**
  * @brief Handle resets from the Extended Kalman Filter (EKF).
  *
@@ -401,14 +542,16 @@ bool VtolType::isFrontTransitionAltitudeLoss()
 void VtolType::handleEkfResets()
 {
 	// check if there is a reset in the z-direction, and if so, shift the transition start z as well
-	if (_local_pos->z_reset_counter != _altitude_reset_counter) {
-		_local_position_z_start_of_transition += _local_pos->delta_z;
-		_altitude_reset_counter = _local_pos->z_reset_counter;
+	if (_io->in.z_reset_counter != _altitude_reset_counter) {
+		_local_position_z_start_of_transition += _io->in.delta_z;
+		_altitude_reset_counter = _io->in.z_reset_counter;
 
 		if (PX4_ISFINITE(_quadchute_ref_alt)) {
-			_quadchute_ref_alt -= _local_pos->delta_z;
+			_quadchute_ref_alt -= _io->in.delta_z;
 		}
 
+		_altitude_window.shift(-_io->in.delta_z);
+
 	}
 }
 
@@ -416,46 +559,63 @@ void VtolType::handleEkfResets()
  * @brief Check if the pitch angle exceeds the allowed maximum.
  *
  * This function checks if the vehicle's pitch angle during fixed-wing flight exceeds
- * the maximum pitch angle allowed by the parameters.
+ * the maximum pitch angle allowed by the parameters. pitch = asin(-dcm(2, 0)), so the
+ * limit is compared on dcm(2, 0) against sin(VT_FW_QC_P) precomputed in update_derived_params().
  *
  * @return true if the maximum pitch is exceeded, false otherwise.
  */
 
-bool VtolType::isPitchExceeded()
+bool VtolType::isPitchExceeded(const QuadchuteInputs &inputs)
 {
-	// fixed-wing maximum pitch angle
-	if (_param_vt_fw_qc_p.get() > 0) {
-		Eulerf euler = Quatf(_v_att->q);
-
-		if (fabsf(euler.theta()) > fabsf(math::radians(static_cast<float>(_param_vt_fw_qc_p.get())))) {
-			return true;
-		}
-	}
-
-	return false;
+	return pitchBeyondLimit(inputs.dcm_20, _derived.qc_sin_pitch_max);
 }
 
 /**
  * @brief Check if the roll angle exceeds the allowed maximum.
  *
  * This function checks if the vehicle's roll angle during fixed-wing flight exceeds
- * the maximum roll angle allowed by the parameters.
+ * the maximum roll angle allowed by the parameters. roll = atan2(dcm(2, 1), dcm(2, 2)),
+ * so |roll| > VT_FW_QC_R is a sign test of the cross product with (cos, sin) of the limit.
+ * Roll is 0 in gimbal lock like for matrix::Eulerf.
  *
  * @return true if the maximum roll is exceeded, false otherwise.
  */
 
-bool VtolType::isRollExceeded()
+bool VtolType::isRollExceeded(const QuadchuteInputs &inputs)
 {
-	// fixed-wing maximum roll angle
-	if (_param_vt_fw_qc_r.get() > 0) {
-		Eulerf euler = Quatf(_v_att->q);
+	return rollBeyondLimit(inputs.dcm_20, inputs.dcm_21, inputs.dcm_22, _derived.qc_cos_roll_max, _derived.qc_sin_roll_max);
+}
 
-		if (fabsf(euler.phi()) > fabsf(math::radians(static_cast<float>(_param_vt_fw_qc_r.get())))) {
-			return true;
-		}
-	}
+bool VtolType::rollBeyondLimit(float dcm_20, float dcm_21, float dcm_22, float cos_roll_max, float sin_roll_max)
+{
+	return fabsf(dcm_20) <= kGimbalLockSinPitch && cos_roll_max * fabsf(dcm_21) - sin_roll_max * dcm_22 > 0.f;
+}
 
-	return false;
+/**
+ * @brief Check if the pitch angle will exceed the allowed maximum within the look-ahead time.
+ *
+ * Same as isPitchExceeded() on the attitude projected with its current rate.
+ *
+ * @return true if the projected pitch exceeds the maximum, false otherwise.
+ */
+
+bool VtolType::isPitchExceedPredicted(const QuadchuteInputs &inputs)
+{
+	return pitchBeyondLimit(inputs.predicted_dcm_20, _derived.qc_sin_pitch_max);
+}
+
+/**
+ * @brief Check if the roll angle will exceed the allowed maximum within the look-ahead time.
+ *
+ * Same as isRollExceeded() on the attitude projected with its current rate.
+ *
+ * @return true if the projected roll exceeds the maximum, false otherwise.
+ */
+
+bool VtolType::isRollExceedPredicted(const QuadchuteInputs &inputs)
+{
+	return rollBeyondLimit(inputs.predicted_dcm_20, inputs.predicted_dcm_21, inputs.predicted_dcm_22,
+			       _derived.qc_cos_roll_max, _derived.qc_sin_roll_max);
 }
 
 /**
@@ -467,7 +627,7 @@ bool VtolType::isRollExceeded()
  * @return true if the transition timeout is reached, false otherwise.
  */
 
-bool VtolType::isFrontTransitionTimeout()
+bool VtolType::isFrontTransitionTimeout(const QuadchuteInputs &inputs)
 {
 	// check front transition timeout
 	if (getFrontTransitionTimeout()  > FLT_EPSILON && _common_vtol_mode == mode::TRANSITION_TO_FW) {
@@ -481,42 +641,109 @@ bool VtolType::isFrontTransitionTimeout()
 	return false;
 }
 
+static constexpr uint8_t kQuadchuteModes = (1 << static_cast<int>(mode::FIXED_WING))
+		| (1 << static_cast<int>(mode::TRANSITION_TO_FW)) | (1 << static_cast<int>(mode::TRANSITION_TO_MC));
+
+const VtolType::QuadchuteCheck VtolType::kQuadchuteChecks[kNumQuadchuteChecks] = {
+	{"transition timeout", &VtolType::isFrontTransitionTimeout, QuadchuteReason::TransitionTimeout, (1 << static_cast<int>(mode::TRANSITION_TO_FW))},
+	{"minimum altitude", &VtolType::isMinAltBreached, QuadchuteReason::MinimumAltBreached, kQuadchuteModes},
+	{"maximum pitch", &VtolType::isPitchExceeded, QuadchuteReason::MaximumPitchExceeded, kQuadchuteModes},
+	{"maximum roll", &VtolType::isRollExceeded, QuadchuteReason::MaximumRollExceeded, kQuadchuteModes},
+	{"transition altitude loss", &VtolType::isFrontTransitionAltitudeLoss, QuadchuteReason::TransitionAltitudeLoss, kQuadchuteModes},
+	{"uncommanded descent", &VtolType::isUncommandedDescent, QuadchuteReason::UncommandedDescent, kQuadchuteModes},
+	// the same limits on the state projected VT_QC_LOOKAHEAD ahead
+	{"minimum altitude ahead", &VtolType::isMinAltBreachPredicted, QuadchuteReason::MinimumAltBreached, kQuadchuteModes},
+	{"maximum pitch ahead", &VtolType::isPitchExceedPredicted, QuadchuteReason::MaximumPitchExceeded, kQuadchuteModes},
+	{"maximum roll ahead", &VtolType::isRollExceedPredicted, QuadchuteReason::MaximumRollExceeded, kQuadchuteModes},
+	{"trans. alt. loss ahead", &VtolType::isFrontTransitionAltitudeLossPredicted, QuadchuteReason::TransitionAltitudeLoss, kQuadchuteModes},
+};
+
+// reason reported when several are active at once
+static constexpr QuadchuteReason kQuadchuteReasonPriority[] = {
+	QuadchuteReason::MinimumAltBreached,
+	QuadchuteReason::UncommandedDescent,
+	QuadchuteReason::TransitionAltitudeLoss,
+	QuadchuteReason::MaximumPitchExceeded,
+	QuadchuteReason::MaximumRollExceeded,
+	QuadchuteReason::TransitionTimeout,
+};
+
 /**
- * @brief Get the reason for triggering a quadchute.
+ * @brief Evaluate the quadchute checks.
  *
- * This function evaluates various conditions, such as altitude loss, uncommanded descent,
- * or exceeding pitch or roll limits, and returns the reason for activating the quadchute.
+ * Runs the checks enabled by the parameters that apply in the current mode, cheapest first.
+ * All of them run, so the result names every active reason and not only the first one.
  *
- * @return The reason for triggering a quadchute.
+ * @return Mask of the active quadchute reasons.
  */
 
-QuadchuteReason VtolType::getQuadchuteReason()
+uint16_t VtolType::evaluateQuadchute(const QuadchuteInputs &inputs, uint16_t *checks_hit)
 {
-	if (isMinAltBreached()) {
-		return QuadchuteReason::MinimumAltBreached;
-	}
+	const uint8_t mode_bit = 1 << static_cast<int>(_common_vtol_mode);
+	uint16_t reasons = 0;
+	uint16_t hits = 0;
 
-	if (isUncommandedDescent()) {
-		return QuadchuteReason::UncommandedDescent;
-	}
+	for (int i = 0; i < kNumQuadchuteChecks; i++) {
+		const QuadchuteCheck &check = kQuadchuteChecks[i];
 
-	if (isFrontTransitionAltitudeLoss()) {
-		return QuadchuteReason::TransitionAltitudeLoss;
+		if (!(_quadchute_checks_enabled & (1 << i)) || !(check.modes & mode_bit)) {
+			continue;
+		}
+
+		_quadchute_check_counters[i].evaluations++;
+
+		if ((this->*check.check)(inputs)) {
+			_quadchute_check_counters[i].hits++;
+			reasons |= quadchuteReasonBit(check.reason);
+			hits |= 1 << i;
+		}
 	}
 
-	if (isPitchExceeded()) {
-		return QuadchuteReason::MaximumPitchExceeded;
+	if (checks_hit != nullptr) {
+		*checks_hit = hits;
 	}
 
-	if (isRollExceeded()) {
-		return QuadchuteReason::MaximumRollExceeded;
+	return reasons;
+}
+
+void VtolType::print_quadchute_status() const
+{
+	PX4_INFO_RAW("quadchute checks (evaluations / hits):\n");
+
+	for (int i = 0; i < kNumQuadchuteChecks; i++) {
+		if (_quadchute_checks_enabled & (1 << i)) {
+			PX4_INFO_RAW("  %-24s %8u / %u\n", kQuadchuteChecks[i].name, (unsigned)_quadchute_check_counters[i].evaluations,
+				     (unsigned)_quadchute_check_counters[i].hits);
+
+		} else {
+			PX4_INFO_RAW("  %-24s disabled\n", kQuadchuteChecks[i].name);
+		}
 	}
 
-	if (isFrontTransitionTimeout()) {
-		return QuadchuteReason::TransitionTimeout;
+	if (_derived.qc_window > 0.f) {
+		PX4_INFO_RAW("altitude window %.1f s: %d/%d samples, max altitude %.1f m, min TECS shortfall %.1f m, descent rate %.2f m/s\n",
+			     (double)_derived.qc_window, _altitude_window.size(), kAltitudeWindowSize,
+			     (double)_altitude_window.max_altitude(), (double)_altitude_window.min_shortfall(),
+			     (double)_altitude_window.descent_rate());
 	}
 
-	return QuadchuteReason::None;
+	if (_quadchute_reasons != 0) {
+		PX4_INFO_RAW("last quadchute reasons:");
+
+		uint16_t printed = 0;
+
+		// the look-ahead checks share the reasons, name each reason after its first check
+		for (const QuadchuteCheck &check : kQuadchuteChecks) {
+			const uint16_t reason = quadchuteReasonBit(check.reason);
+
+			if ((_quadchute_reasons & reason) && !(printed & reason)) {
+				PX4_INFO_RAW(" [%s]", check.name);
+				printed |= reason;
+			}
+		}
+
+		PX4_INFO_RAW("\n");
+	}
 }
 
 /**
@@ -547,17 +774,185 @@ void VtolType::handleSpecialExternalCommandQuadchute()
  * exceeding limits, or external commands, and triggers the quadchute if necessary.
  */
 
-void VtolType::check_quadchute_condition()
+void VtolType::check_quadchute_condition(const VtolControlCycle &cycle)
 {
 	handleSpecialExternalCommandQuadchute();
 
-	if (isQuadchuteEnabled()) {
-		QuadchuteReason reason = getQuadchuteReason();
+	if (_quadchute_checks_enabled == 0) {
+		return;
+	}
+
+	QuadchuteInputs inputs;
+	inputs.now = cycle.now;
+	inputs.dist_to_ground = getDistanceToGround();
+
+	if (!isQuadchuteEnabled(inputs)) {
+		return;
+	}
+
+	updateQuadchuteInputs(inputs);
+
+	const uint16_t reasons = evaluateQuadchute(inputs);
+
+	if (reasons == 0) {
+		return;
+	}
+
+	if (!_vtol_vehicle_status->fixed_wing_system_failure) {
+		_quadchute_reasons = reasons;
+	}
 
-		if (reason != QuadchuteReason::None) {
+	for (QuadchuteReason reason : kQuadchuteReasonPriority) {
+		if (reasons & quadchuteReasonBit(reason)) {
 			_attc->quadchute(reason);
+			break;
+		}
+	}
+}
+
+void VtolType::updateQuadchuteInputs(QuadchuteInputs &inputs)
+{
+	if (_derived.qc_window > 0.f) {
+		updateAltitudeWindow(inputs.now);
+	}
+
+	// attitude rows used by the pitch and roll checks, computed once from the quaternion
+	const float *q = _io->in.q;
+	inputs.dcm_20 = 2.f * (q[1] * q[3] - q[0] * q[2]);
+	inputs.dcm_21 = 2.f * (q[0] * q[1] + q[2] * q[3]);
+	inputs.dcm_22 = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+
+	if (_derived.qc_lookahead > 0.f) {
+		const float row[3] {inputs.dcm_20, inputs.dcm_21, inputs.dcm_22};
+		float predicted[3];
+
+		_quadchute_lookahead.update(_io->in.attitude_sample, row);
+		_quadchute_lookahead.predict_attitude(row, _derived.qc_lookahead, predicted);
+
+		inputs.predicted_dcm_20 = predicted[0];
+		inputs.predicted_dcm_21 = predicted[1];
+		inputs.predicted_dcm_22 = predicted[2];
+		inputs.predicted_drop = _io->in.v_z_valid ? QuadchuteLookahead::altitude_drop(_io->in.vz, _io->in.az,
+					_derived.qc_lookahead) : 0.f;
+	}
+}
+
+/**
+ * @brief Replay scripted failures through the quadchute checks.
+ *
+ * Each scenario is flown as a front transition from its start altitude, with TECS holding that
+ * altitude, on a copy of the inputs. The checks, their parameters and the derived limits are the
+ * ones of the vehicle, the step of the first current check and of the first check at all (current
+ * or look-ahead) that triggers are reported.
+ */
+
+void VtolType::replayQuadchute(float horizon, quadchute_replay::Report &report)
+{
+	using namespace quadchute_replay;
+
+	// borrowed for the replay, restored at the end
+	VtolIo *const io = _io;
+	const mode common_vtol_mode = _common_vtol_mode;
+	const float z_start_of_transition = _local_position_z_start_of_transition;
+	const float time_since_trans_start = _time_since_trans_start;
+	const DerivedParams derived = _derived;
+	const uint16_t checks_enabled = _quadchute_checks_enabled;
+	QuadchuteCheckCounters counters[kNumQuadchuteChecks];
+	memcpy(counters, _quadchute_check_counters, sizeof(counters));
+
+	if (horizon > 0.f) {
+		// look-ahead counterparts of the enabled current checks
+		_derived.qc_lookahead = horizon;
+
+		for (int i = kFirstLookaheadQuadchuteCheck; i < kNumQuadchuteChecks; i++) {
+			for (int j = 0; j < kFirstLookaheadQuadchuteCheck; j++) {
+				if ((checks_enabled & (1 << j)) && kQuadchuteChecks[j].reason == kQuadchuteChecks[i].reason) {
+					_quadchute_checks_enabled |= 1 << i;
+				}
+			}
+		}
+	}
+
+	const uint16_t current_checks = (1 << kFirstLookaheadQuadchuteCheck) - 1;
+	report.horizon = (_quadchute_checks_enabled & ~current_checks) ? _derived.qc_lookahead : 0.f;
+
+	VtolIo replay_io = *io;
+	VtolInputs &in = replay_io.in;
+	_io = &replay_io;
+	_common_vtol_mode = mode::TRANSITION_TO_FW;
+
+	const int steps = static_cast<int>(kDuration * kRate);
+
+	for (int s = 0; s < kNumScenarios; s++) {
+		Truth start;
+		kScenarios[s].state(0.f, start);
+
+		_local_position_z_start_of_transition = -start.altitude;
+		_quadchute_ref_alt = NAN;
+		_altitude_window.reset();
+		_quadchute_lookahead.reset();
+
+		uint32_t seed = 1;
+		report.current_step[s] = -1;
+		report.lookahead_step[s] = -1;
+
+		for (int i = 0; i < steps && report.current_step[s] < 0; i++) {
+			Truth truth;
+			kScenarios[s].state(i / kRate, truth);
+
+			// estimator noise: attitude 0.02 deg, altitude 5 cm, vertical speed 5 cm/s, acceleration 0.3 m/s^2
+			const float roll = truth.roll + math::radians(0.02f) * noise(seed);
+			const float pitch = truth.pitch + math::radians(0.02f) * noise(seed);
+			const float altitude = truth.altitude + 0.05f * noise(seed);
+			const float vz = truth.vz + 0.05f * noise(seed);
+			const float az = truth.az + 0.3f * noise(seed);
+
+			const hrt_abstime now = 1_s + static_cast<hrt_abstime>(i * (1e6f / kRate));
+
+			in.attitude_sample = now;
+			Quatf(Eulerf(roll, pitch, 0.f)).copyTo(in.q);
+			in.local_pos_sample = now;
+			in.z = -altitude;
+			in.vz = vz;
+			in.az = az;
+			in.ref_alt = 0.f;
+			in.z_valid = true;
+			in.z_global = true;
+			in.v_z_valid = true;
+			in.altitude_control = true;
+			in.tecs_altitude_reference = start.altitude;
+			in.tecs_timestamp = now;
+			_time_since_trans_start = i / kRate;
+
+			QuadchuteInputs inputs{};
+			inputs.now = now;
+			inputs.dist_to_ground = altitude;
+			updateQuadchuteInputs(inputs);
+
+			uint16_t checks_hit;
+			evaluateQuadchute(inputs, &checks_hit);
+
+			if (checks_hit != 0 && report.lookahead_step[s] < 0) {
+				report.lookahead_step[s] = i;
+			}
+
+			if (checks_hit & current_checks) {
+				report.current_step[s] = i;
+			}
 		}
 	}
+
+	_io = io;
+	_common_vtol_mode = common_vtol_mode;
+	_local_position_z_start_of_transition = z_start_of_transition;
+	_time_since_trans_start = time_since_trans_start;
+	_derived = derived;
+	_quadchute_checks_enabled = checks_enabled;
+	memcpy(_quadchute_check_counters, counters, sizeof(counters));
+
+	_quadchute_ref_alt = NAN;
+	_altitude_window.reset();
+	_quadchute_lookahead.reset();
 }
 
 /**
@@ -571,27 +966,13 @@ void VtolType::check_quadchute_condition()
 
 float VtolType::pusher_assist()
 {
-	// Altitude above ground is local z-position or altitude above home or distance sensor altitude depending on what's available
-	float dist_to_ground = 0.f;
-	const float home_position_z = _attc->get_home_position_z();
-
-	if (_local_pos->dist_bottom_valid) {
-		dist_to_ground = _local_pos->dist_bottom;
-
-	} else if (PX4_ISFINITE(home_position_z)) {
-		dist_to_ground = -(_local_pos->z - home_position_z);
-
-	} else {
-		dist_to_ground = -_local_pos->z;
-
-	}
+	const float dist_to_ground = getDistanceToGround();
 
 	// the vehicle is "landing" if it is in auto mode and the type is set to LAND, and
 	// "descending" if it is in auto and climb rate controlled but not altitude controlled
-	const bool vehicle_is_landing_or_descending = _v_control_mode->flag_control_auto_enabled
-			&& ((_attc->get_pos_sp_triplet()->current.valid
-			     && _attc->get_pos_sp_triplet()->current.type == position_setpoint_s::SETPOINT_TYPE_LAND) ||
-			    (_v_control_mode->flag_control_climb_rate_enabled && !_v_control_mode->flag_control_altitude_enabled));
+	const bool vehicle_is_landing_or_descending = _io->in.auto_control
+			&& (_io->in.landing_setpoint ||
+			    (_io->in.climb_rate_control && !_io->in.altitude_control));
 
 	// disable pusher assist depending on setting of forward_thrust_enable_mode:
 	switch (_param_vt_fwd_thrust_en.get()) {
@@ -639,7 +1020,7 @@ float VtolType::pusher_assist()
 
 	// if the thrust scale param is zero or the drone is not in a climb rate controlled mode,
 	// then the pusher-for-pitch strategy is disabled and we can return
-	if (_param_vt_fwd_thrust_sc.get() < FLT_EPSILON || !(_v_control_mode->flag_control_climb_rate_enabled)) {
+	if (_param_vt_fwd_thrust_sc.get() < FLT_EPSILON || !(_io->in.climb_rate_control)) {
 		return 0.0f;
 	}
 
@@ -648,118 +1029,235 @@ float VtolType::pusher_assist()
 		return 0.0f;
 	}
 
-	const Dcmf R(Quatf(_v_att->q));
-	const Dcmf R_sp(Quatf(_v_att_sp->q_d));
-	const Eulerf euler(R);
-	const Eulerf euler_sp(R_sp);
+	float pitch_setpoint_min = math::radians(_param_vt_pitch_min.get());
+
+	if (_io->in.landing_setpoint) {
+		pitch_setpoint_min = math::radians(
+					     _param_vt_lnd_pitch_min.get()); // set min pitch during LAND (usually lower to generate less lift)
+	}
+
+	return pusher_assist_limit_pitch(Quatf(_io->in.q), _v_att_sp->q_d, pitch_setpoint_min, _param_vt_fwd_thrust_sc.get());
+}
+
+float VtolType::pusher_assist_limit_pitch(const Quatf &q, float q_d[4], float pitch_setpoint_min, float thrust_scale)
+{
+	// The setpoint is decomposed in the heading frame (earth frame rotated by the current yaw) and
+	// rebuilt with a limited pitch. All angles are carried as (cos, sin) pairs taken directly from
+	// the quaternions, which is algebraically the same as going through the Euler angles and DCMs.
+	const Quatf q_sp(q_d);
+	const Vector2f heading = heading_of(q);
 
 	// direction of desired body z axis represented in earth frame
-	Vector3f body_z_sp(R_sp(0, 2), R_sp(1, 2), R_sp(2, 2));
+	const Vector3f body_z_sp(2.f * (q_sp(0) * q_sp(2) + q_sp(1) * q_sp(3)),
+				 2.f * (q_sp(2) * q_sp(3) - q_sp(0) * q_sp(1)),
+				 q_sp(0) * q_sp(0) - q_sp(1) * q_sp(1) - q_sp(2) * q_sp(2) + q_sp(3) * q_sp(3));
 
-	// rotate desired body z axis into new frame which is rotated in z by the current
-	// heading of the vehicle. we refer to this as the heading frame.
-	Dcmf R_yaw = Eulerf(0.0f, 0.0f, -euler(2));
-	body_z_sp = R_yaw * body_z_sp;
-	body_z_sp.normalize();
+	// rotate desired body z axis into the heading frame
+	const Vector3f body_z_sp_heading = Vector3f(heading(0) * body_z_sp(0) + heading(1) * body_z_sp(1),
+					   -heading(1) * body_z_sp(0) + heading(0) * body_z_sp(1),
+					   body_z_sp(2)).normalized();
 
 	// calculate the desired pitch seen in the heading frame
 	// this value corresponds to the amount the vehicle would try to pitch down
-	const float pitch_setpoint = atan2f(body_z_sp(0), body_z_sp(2));
+	const float pitch_setpoint = fast_trig::atan2(body_z_sp_heading(0), body_z_sp_heading(2));
 
 	// normalized pusher support throttle (standard VTOL) or tilt (tiltrotor), initialize to 0
 	float forward_thrust = 0.0f;
 
-	float pitch_setpoint_min = math::radians(_param_vt_pitch_min.get());
-
-	if (_attc->get_pos_sp_triplet()->current.valid
-	    && _attc->get_pos_sp_triplet()->current.type == position_setpoint_s::SETPOINT_TYPE_LAND) {
-		pitch_setpoint_min = math::radians(
-					     _param_vt_lnd_pitch_min.get()); // set min pitch during LAND (usually lower to generate less lift)
-	}
-
 	// only allow pitching down up to threshold, the rest of the desired
 	// forward acceleration will be compensated by the pusher/tilt
 
 	if (pitch_setpoint < pitch_setpoint_min) {
-		// desired roll angle in heading frame stays the same
-		const float roll_new = -asinf(body_z_sp(1));
+		const float sin_pitch_setpoint_min = fast_trig::sin(pitch_setpoint_min);
+
+		// sin(atan2(x, z)) = x / |(x, z)|
+		const float sin_pitch_setpoint = body_z_sp_heading(0) / sqrtf(body_z_sp_heading(0) * body_z_sp_heading(0) +
+						 body_z_sp_heading(2) * body_z_sp_heading(2));
 
-		forward_thrust = (sinf(pitch_setpoint_min) - sinf(pitch_setpoint)) * _param_vt_fwd_thrust_sc.get();
+		forward_thrust = (sin_pitch_setpoint_min - sin_pitch_setpoint) * thrust_scale;
 		// limit forward actuation to [0, 0.9]
 		forward_thrust = math::constrain(forward_thrust, 0.0f, 0.9f);
 
 		// Set the pitch to 0 if the pitch limit is negative (pitch down), but allow a positive (pitch up) pitch.
 		// This can be used for tiltrotor to make them hover with a positive angle of attack
-		const float pitch_new = pitch_setpoint_min > 0.f ? pitch_setpoint_min : 0.f;
+		const float sin_pitch_new = pitch_setpoint_min > 0.f ? sin_pitch_setpoint_min : 0.f;
+		const float cos_pitch_new = pitch_setpoint_min > 0.f ? fast_trig::cos(pitch_setpoint_min) : 1.f;
 
-		// create corrected desired body z axis in heading frame
-		const Dcmf R_tmp = Eulerf(roll_new, pitch_new, 0.0f);
-		Vector3f tilt_new(R_tmp(0, 2), R_tmp(1, 2), R_tmp(2, 2));
+		// corrected desired body z axis in heading frame: roll of the setpoint (sin(roll) = -z_y) kept, pitch replaced
+		const float cos_roll_new = sqrtf(fmaxf(1.f - body_z_sp_heading(1) * body_z_sp_heading(1), 0.f));
+		const Vector3f tilt_heading(cos_roll_new * sin_pitch_new, body_z_sp_heading(1), cos_roll_new * cos_pitch_new);
 
 		// rotate the vector into a new frame which is rotated in z by the desired heading
-		// with respect to the earh frame.
-		const float yaw_error = wrap_pi(euler_sp(2) - euler(2));
-		const Dcmf R_yaw_correction = Eulerf(0.0f, 0.0f, -yaw_error);
-		tilt_new = R_yaw_correction * tilt_new;
-
-		// now extract roll and pitch setpoints
-		const float pitch_body = atan2f(tilt_new(0), tilt_new(2));
-		const float roll_body = -asinf(tilt_new(1));
-
-		const Quatf q_sp(Eulerf(roll_body, pitch_body, euler_sp(2)));
-		q_sp.copyTo(_v_att_sp->q_d);
+		// with respect to the earth frame, the yaw error is the angle between the two headings
+		const Vector2f heading_sp = heading_of(q_sp);
+		const float cos_yaw_error = heading_sp(0) * heading(0) + heading_sp(1) * heading(1);
+		const float sin_yaw_error = heading_sp(1) * heading(0) - heading_sp(0) * heading(1);
+		const Vector3f tilt_new(cos_yaw_error * tilt_heading(0) + sin_yaw_error * tilt_heading(1),
+					-sin_yaw_error * tilt_heading(0) + cos_yaw_error * tilt_heading(1),
+					tilt_heading(2));
+
+		// roll and pitch setpoints (roll = -asin(y), pitch = atan2(x, z)) as half angles, yaw of the setpoint kept
+		const float norm_xz = sqrtf(tilt_new(0) * tilt_new(0) + tilt_new(2) * tilt_new(2));
+		const Vector2f roll_half = half_angle(sqrtf(fmaxf(1.f - tilt_new(1) * tilt_new(1), 0.f)), -tilt_new(1));
+		const Vector2f pitch_half = norm_xz > 0.f ? half_angle(tilt_new(2) / norm_xz, tilt_new(0) / norm_xz) : Vector2f(1.f, 0.f);
+		const Vector2f yaw_half = half_angle(heading_sp(0), heading_sp(1));
+
+		// Quatf(Eulerf(roll, pitch, yaw))
+		const float cr = roll_half(0), sr = roll_half(1);
+		const float cp = pitch_half(0), sp = pitch_half(1);
+		const float cy = yaw_half(0), sy = yaw_half(1);
+		q_d[0] = cr * cp * cy + sr * sp * sy;
+		q_d[1] = sr * cp * cy - cr * sp * sy;
+		q_d[2] = cr * sp * cy + sr * cp * sy;
+		q_d[3] = cr * cp * sy - sr * sp * cy;
 	}
 
 	return forward_thrust;
+}
+
+/**
+ * @brief Fill the transition performance grid from the analytic model.
+ *
+ * Around VT_ARSP_TRANS, VT_TRANS_MIN_TM, VT_F_TR_OL_TM and VT_TRANS_TIMEOUT, unless the table
+ * measured on the airframe is in use (see update_measured_transition_performance()).
+ */
 
+void VtolType::update_transition_performance()
+{
+	if (!_transition_performance_measured) {
+		_transition_performance.build(TransitionPerformance{_param_vt_arsp_trans.get(), _param_vt_trans_min_tm.get(),
+					      _param_vt_f_tr_ol_tm.get(), _param_vt_trans_timeout.get()});
+	}
 }
 
-float VtolType::getFrontTransitionTimeFactor() const
+/**
+ * @brief Take over the measured transition table from the command handler.
+ *
+ * The handler reads the table when VT_TRANS_TBL changes, this only copies the grid. Without a
+ * table (VT_TRANS_TBL not set or unreadable) the analytic model is restored.
+ */
+
+bool VtolType::update_measured_transition_performance(TransitionTableHandover &table)
 {
-	// assumptions: transition_time = transition_true_airspeed / average_acceleration (thrust)
-	// transition_true_airspeed ~ sqrt(rho0 / rh0)
-	// average_acceleration ~ rho / rho0
-	// transition_time ~ sqrt(rho0/rh0) * rho0 / rho
+	switch (table.copy(_transition_performance, _transition_table_generation)) {
+	case TransitionTableHandover::CopyResult::Copied:
+		_transition_performance_measured = true;
+		return true;
+
+	case TransitionTableHandover::CopyResult::NoTable:
+		if (!_transition_performance_measured) {
+			return false;
+		}
 
-	// low value: hot day at 4000m AMSL with some margin
-	// high value: cold day at 0m AMSL with some margin
-	const float rho = math::constrain(_attc->getAirDensity(), 0.7f, 1.5f);
+		_transition_performance_measured = false;
+		update_transition_performance();
+		return true;
 
-	if (PX4_ISFINITE(rho)) {
-		float rho0_over_rho = atmosphere::kAirDensitySeaLevelStandardAtmos / rho;
-		return sqrtf(rho0_over_rho) * rho0_over_rho;
+	case TransitionTableHandover::CopyResult::Busy:
+		break;
 	}
 
-	return 1.0f;
+	return false;
 }
 
-float VtolType::getMinimumFrontTransitionTime() const
-{
-	return getFrontTransitionTimeFactor() * _param_vt_trans_min_tm.get();
-}
+/**
+ * @brief Recompute the values derived from parameters and air density.
+ *
+ * The transition times and airspeed are read from the performance grid at the current air
+ * density and weight, the transition schedules are rebuilt from them.
+ */
 
-float VtolType::getFrontTransitionTimeout() const
+void VtolType::update_derived_params()
 {
-	return getFrontTransitionTimeFactor() * _param_vt_trans_timeout.get();
+	float weight_ratio = 1.0f;
+
+	if (_param_weight_base.get() > FLT_EPSILON && _param_weight_gross.get() > FLT_EPSILON) {
+		weight_ratio = _param_weight_gross.get() / _param_weight_base.get();
+	}
+
+	_derived.air_density = _attc->getAirDensity();
+
+	const TransitionPerformance performance = _transition_performance.lookup(_derived.air_density, weight_ratio);
+
+	_derived.min_front_trans_time = performance.min_time;
+	_derived.open_loop_front_trans_time = performance.open_loop_time;
+	_derived.front_trans_timeout = performance.timeout;
+	_derived.transition_airspeed = performance.transition_airspeed;
+	_derived.blend_airspeed_margin = _derived.transition_airspeed - getBlendAirspeed();
+
+	// quadchute attitude limits, |pitch| <= 90 deg and |roll| <= 180 deg can never exceed the upper bounds
+	const int32_t qc_pitch_max = _param_vt_fw_qc_p.get();
+	const int32_t qc_roll_max = _param_vt_fw_qc_r.get();
+
+	_derived.qc_sin_pitch_max = sinf(math::radians(static_cast<float>(qc_pitch_max)));
+	_derived.qc_cos_roll_max = cosf(math::radians(static_cast<float>(qc_roll_max)));
+	_derived.qc_sin_roll_max = sinf(math::radians(static_cast<float>(qc_roll_max)));
+
+	const float qc_lookahead = math::max(_param_vt_qc_lookahead.get(), 0.f);
+
+	// skip list of the quadchute checks (same order as kQuadchuteChecks), a disabled check is never evaluated
+	const bool checks_enabled[kNumQuadchuteChecks] = {
+		_derived.front_trans_timeout > FLT_EPSILON,
+		_param_vt_fw_min_alt.get() > FLT_EPSILON,
+		qc_pitch_max > 0 && qc_pitch_max < 90,
+		qc_roll_max > 0 && qc_roll_max < 180,
+		_param_vt_qc_t_alt_loss.get() > FLT_EPSILON,
+		_param_vt_qc_alt_loss.get() > FLT_EPSILON,
+		qc_lookahead > 0.f && _param_vt_fw_min_alt.get() > FLT_EPSILON,
+		qc_lookahead > 0.f && qc_pitch_max > 0 && qc_pitch_max < 90,
+		qc_lookahead > 0.f && qc_roll_max > 0 && qc_roll_max < 180,
+		qc_lookahead > 0.f && _param_vt_qc_t_alt_loss.get() > FLT_EPSILON,
+	};
+
+	_quadchute_checks_enabled = 0;
+
+	for (int i = 0; i < kNumQuadchuteChecks; i++) {
+		_quadchute_checks_enabled |= checks_enabled[i] ? (1 << i) : 0;
+	}
+
+	if (!checks_enabled[5]) {
+		// the uncommanded descent reference is only maintained while the check runs
+		_quadchute_ref_alt = NAN;
+	}
+
+	if (qc_lookahead != _derived.qc_lookahead) {
+		_derived.qc_lookahead = qc_lookahead;
+		_quadchute_lookahead.reset();
+	}
+
+	// the altitude window is only filled if one of the checks using it runs
+	const float qc_window = (checks_enabled[4] || checks_enabled[5]) ? math::max(_param_vt_qc_window.get(), 0.f) : 0.f;
+
+	if (qc_window != _derived.qc_window) {
+		_derived.qc_window = qc_window;
+		_altitude_window.set_horizon(qc_window);
+	}
+
+	update_transition_schedules();
+
+	_derived.generation++;
 }
 
-float VtolType::getOpenLoopFrontTransitionTime() const
+/**
+ * @brief Rebuild the transition schedules.
+ *
+ * Samples the throttle blend after the front transition, the types add their tilt, pitch,
+ * throttle and MC weight profiles.
+ */
+
+void VtolType::update_transition_schedules()
 {
-	return getFrontTransitionTimeFactor() * _param_vt_f_tr_ol_tm.get();
+	_throttle_blend_schedule.build(0.f, THROTTLE_BLENDING_DUR_S, 0.f, 1.f, _param_vt_shape_thr.get());
 }
-float VtolType::getTransitionAirspeed() const
-{
-	// Since the stall airspeed increases with vehicle weight, we increase the transition airspeed
-	// by the same factor.
 
-	float weight_ratio = 1.0f;
+void VtolType::check_air_density_change()
+{
+	const float rho = _attc->getAirDensity();
 
-	if (_param_weight_base.get() > FLT_EPSILON && _param_weight_gross.get() > FLT_EPSILON) {
-		weight_ratio = math::constrain(_param_weight_gross.get() /
-					       _param_weight_base.get(), kMinWeightRatio, kMaxWeightRatio);
+	if (PX4_ISFINITE(rho) != PX4_ISFINITE(_derived.air_density)
+	    || fabsf(rho - _derived.air_density) > kAirDensityHysteresis) {
+		update_derived_params();
 	}
-
-	return sqrtf(weight_ratio) * _param_vt_arsp_trans.get();
 }
 
 float VtolType::getBlendAirspeed() const
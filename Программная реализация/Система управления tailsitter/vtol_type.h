@@ -1,9 +1,16 @@
 
-*/
 
 #ifndef VTOL_TYPE_H
 #define VTOL_TYPE_H
 
+#include "vtol_altitude_window.h"
+#include "vtol_attitude_cache.h"
+#include "vtol_io.h"
+#include "vtol_quadchute_lookahead.h"
+#include "vtol_transition_performance.h"
+#include "vtol_transition_schedule.h"
+#include "vtol_type_config.h"
+
 #include <drivers/drv_hrt.h>
 #include <lib/mathlib/mathlib.h>
 #include <px4_platform_common/module_params.h>
@@ -55,12 +62,37 @@ enum class QuadchuteReason {
 	MaximumRollExceeded,
 };
 
+/**
+ * Per-cycle control context. Sampled once at the start of a control cycle and handed to the
+ * type specific updates, so that all outputs of one cycle carry the same timestamp.
+ */
+struct VtolControlCycle {
+	static constexpr float kMinDt = 0.0001f;	// [s]
+	static constexpr float kMaxDt = 0.02f;	// [s]
+
+	hrt_abstime now;	// time of the cycle, used for all timestamps and elapsed times
+	float dt;		// time since the previous cycle [s], constrained to [kMinDt, kMaxDt]
+};
+
 class VtolAttitudeControl;
 
 class VtolType : public ModuleParams
 {
 public:
 
+	// input topics of the control cycle, see get_input_set()
+	enum Input : uint16_t {
+		INPUT_CONTROL_MODE = (1 << 0),
+		INPUT_ATTITUDE = (1 << 1),
+		INPUT_LOCAL_POSITION = (1 << 2),
+		INPUT_POSITION_SETPOINT_TRIPLET = (1 << 3),
+		INPUT_AIRSPEED = (1 << 4),
+		INPUT_TECS_STATUS = (1 << 5),
+		INPUT_LAND_DETECTED = (1 << 6),
+	};
+
+	static constexpr int kNumInputs = 7;
+
 	VtolType(VtolAttitudeControl *att_controller);
 	VtolType(const VtolType &) = delete;
 	VtolType &operator=(const VtolType &) = delete;
@@ -75,27 +107,33 @@ public:
 	/**
 	 * Update vtol state.
 	 */
-	virtual void update_vtol_state() = 0;
+	virtual void update_vtol_state(const VtolControlCycle &cycle) = 0;
 
 	/**
 	 * Update transition state.
 	 */
-	virtual void update_transition_state() = 0;
+	virtual void update_transition_state(const VtolControlCycle &cycle) = 0;
 
 	/**
 	 * Update multicopter state.
 	 */
-	virtual void update_mc_state();
+	virtual void update_mc_state(const VtolControlCycle &cycle);
 
 	/**
 	 * Update fixed wing state.
 	 */
-	virtual void update_fw_state();
+	virtual void update_fw_state(const VtolControlCycle &cycle);
+
+	/**
+	 * Inputs (Input bits) consumed in the given mode by the state machine, the mode update
+	 * and the quadchute checks. Only these topics are copied in a cycle of that mode.
+	 */
+	virtual uint16_t get_input_set(mode vtol_mode) const;
 
 	/**
 	 * Write control values to actuator output topics.
 	 */
-	virtual void fill_actuator_outputs() = 0;
+	virtual void fill_actuator_outputs(const VtolControlCycle &cycle) = 0;
 
 	/**
 	 * Special handling opportunity for the time right after transition to FW
@@ -103,61 +141,169 @@ public:
 	 */
 	virtual void waiting_on_tecs() {}
 
+	/**
+	 * Values shared by the quadchute checks, computed once per evaluation.
+	 */
+	struct QuadchuteInputs {
+		hrt_abstime now;
+		float dist_to_ground;	// [m]
+		float dcm_20;		// attitude dcm(2, 0) = -sin(pitch)
+		float dcm_21;		// attitude dcm(2, 1), roll = atan2(dcm(2, 1), dcm(2, 2))
+		float dcm_22;		// attitude dcm(2, 2)
+		float predicted_drop;	// altitude lost over VT_QC_LOOKAHEAD [m], only set if the look-ahead checks run
+		float predicted_dcm_20;	// attitude dcm(2, 0..2) projected over VT_QC_LOOKAHEAD, only set if the look-ahead checks run
+		float predicted_dcm_21;
+		float predicted_dcm_22;
+	};
+
+	/**
+	 * @return Bit of the given reason in a quadchute reason mask
+	 */
+	static constexpr uint16_t quadchuteReasonBit(QuadchuteReason reason) { return 1u << static_cast<int>(reason); }
+
+	/**
+	 * @return Altitude above ground from the distance sensor, above home or above the local origin,
+	 * whichever is available first [m]
+	 */
+	float getDistanceToGround() const;
+
 	/**
 	 *  @brief Indicates if quadchute is enabled.
 	 *
 	 * @return     true if enabled
 	 */
-	bool isQuadchuteEnabled();
+	bool isQuadchuteEnabled(const QuadchuteInputs &inputs) const;
 
 	/**
-	 *  @brief Evaluates quadchute conditions and returns a reson for quadchute.
+	 * Fill the attitude rows and, if VT_QC_LOOKAHEAD is set, the projected state of the inputs,
+	 * updating the altitude window and the attitude rate estimate.
+	 */
+	void updateQuadchuteInputs(QuadchuteInputs &inputs);
+
+	/**
+	 *  @brief Runs every enabled quadchute check that applies in the current mode.
 	 *
-	 * @return     QuadchuteReason, can be None
+	 * @param checks_hit If not null, set to the bit (1 << index) of each kQuadchuteChecks entry that triggered
+	 * @return     Mask of quadchuteReasonBit() of all active reasons, 0 if none
 	 */
-	QuadchuteReason getQuadchuteReason();
+	uint16_t evaluateQuadchute(const QuadchuteInputs &inputs, uint16_t *checks_hit = nullptr);
 
 	/**
 	 *  @brief Indicates if the vehicle is lower than VT_FW_MIN_ALT above the local origin.
 	 *
 	 * @return     true if below threshold
 	 */
-	bool isMinAltBreached();
+	bool isMinAltBreached(const QuadchuteInputs &inputs);
+
+	/**
+	 * @return TECS altitude reference minus the current altitude [m], NAN if the reference is not usable
+	 */
+	float getTecsAltitudeShortfall(hrt_abstime now) const;
+
+	/**
+	 * Add the current altitude and TECS shortfall to the quadchute altitude window (VT_QC_WINDOW).
+	 */
+	void updateAltitudeWindow(hrt_abstime now);
+
+	/**
+	 *  @brief Indicates if the vehicle will be lower than VT_FW_MIN_ALT above the local origin within VT_QC_LOOKAHEAD.
+	 *
+	 * @return     true if below threshold
+	 */
+	bool isMinAltBreachPredicted(const QuadchuteInputs &inputs);
 
 	/**
 	 * @brief Indicates if conditions are met for uncommanded-descent quad-chute.
 	 *
 	 * @return true if integrated height rate error larger than threshold
 	 */
-	bool isUncommandedDescent();
+	bool isUncommandedDescent(const QuadchuteInputs &inputs);
 
 	/**
 	 * @brief Indicates if there is an altitude loss higher than specified threshold during a VTOL transition to FW
 	 *
 	 * @return true if error larger than threshold
 	 */
-	bool isFrontTransitionAltitudeLoss();
+	bool isFrontTransitionAltitudeLoss(const QuadchuteInputs &inputs);
+
+	/**
+	 * @brief Indicates if the altitude loss during a VTOL transition to FW will exceed the threshold within VT_QC_LOOKAHEAD
+	 *
+	 * @return true if error larger than threshold
+	 */
+	bool isFrontTransitionAltitudeLossPredicted(const QuadchuteInputs &inputs);
+
+	/**
+	 * @return true if VT_QC_T_ALT_LOSS is set, the altitude is valid and controlled and the vehicle is in
+	 * front transition or less than 5s after it
+	 */
+	bool isFrontTransitionAltitudeMonitored(hrt_abstime now) const;
 
 	/**
 	 *  @brief Indicates if the absolute value of the vehicle pitch angle exceeds the threshold defined by VT_FW_QC_P
 	 *
 	 * @return     true if exeeded
 	 */
-	bool isPitchExceeded();
+	bool isPitchExceeded(const QuadchuteInputs &inputs);
 
 	/**
 	 *  @brief Indicates if the absolute value of the vehicle roll angle exceeds the threshold defined by VT_FW_QC_R
 	 *
 	 * @return     true if exeeded
 	 */
-	bool isRollExceeded();
+	bool isRollExceeded(const QuadchuteInputs &inputs);
+
+	/**
+	 *  @brief Indicates if the pitch angle will exceed VT_FW_QC_P within VT_QC_LOOKAHEAD
+	 *
+	 * @return     true if exeeded
+	 */
+	bool isPitchExceedPredicted(const QuadchuteInputs &inputs);
+
+	/**
+	 *  @brief Indicates if the roll angle will exceed VT_FW_QC_R within VT_QC_LOOKAHEAD
+	 *
+	 * @return     true if exeeded
+	 */
+	bool isRollExceedPredicted(const QuadchuteInputs &inputs);
+
+	/**
+	 * @param dcm_20 Attitude dcm(2, 0) = -sin(pitch)
+	 * @param sin_pitch_max sin of the pitch limit
+	 * @return true if the absolute pitch is above the limit
+	 */
+	static bool pitchBeyondLimit(float dcm_20, float sin_pitch_max) { return fabsf(dcm_20) > sin_pitch_max; }
+
+	/**
+	 * @param dcm_20 Attitude dcm(2, 0), dcm(2, 1) and dcm(2, 2), the row does not need to be normalized
+	 * @param cos_roll_max cos of the roll limit
+	 * @param sin_roll_max sin of the roll limit
+	 * @return true if the absolute roll is above the limit, roll is 0 in gimbal lock like for matrix::Eulerf
+	 */
+	static bool rollBeyondLimit(float dcm_20, float dcm_21, float dcm_22, float cos_roll_max, float sin_roll_max);
 
 	/**
 	 *  @brief Indicates if the front transition duration has exceeded the timeout definded by VT_TRANS_TIMEOUT
 	 *
 	 * @return     true if exeeded
 	 */
-	bool isFrontTransitionTimeout();
+	bool isFrontTransitionTimeout(const QuadchuteInputs &inputs);
+
+	/**
+	 * Print the quadchute checks with their evaluation and hit counts and the reasons of the last quadchute.
+	 */
+	void print_quadchute_status() const;
+
+	/**
+	 * Fly the scripted failures of quadchute_replay through the enabled quadchute checks of this
+	 * vehicle, as a front transition. Only call while disarmed and from the controller thread: the
+	 * quadchute state is borrowed for the replay, the altitude window and the attitude rate
+	 * estimate restart afterwards.
+	 *
+	 * @param horizon Look-ahead time [s], the look-ahead checks of the enabled checks run with it
+	 * instead of VT_QC_LOOKAHEAD if positive
+	 */
+	void replayQuadchute(float horizon, quadchute_replay::Report &report);
 
 	/**
 	 *  @brief Special handling of QuadchuteReason::ReasonExternal
@@ -167,7 +313,7 @@ public:
 	/**
 	 * Checks for fixed-wing failsafe condition and issues abort request if needed.
 	 */
-	void check_quadchute_condition();
+	void check_quadchute_condition(const VtolControlCycle &cycle);
 
 	/**
 	 * Returns true if we're allowed to do a mode transition on the ground.
@@ -179,24 +325,58 @@ public:
 	 */
 	float pusher_assist();
 
+	/**
+	 * Pitch limiting part of pusher_assist(), works on the quaternions only.
+	 *
+	 * @param q Vehicle attitude
+	 * @param q_d Attitude setpoint, its pitch in the heading frame is raised to the minimum if below
+	 * @param pitch_setpoint_min Minimum pitch in the heading frame [rad]
+	 * @param thrust_scale Forward thrust per unit of removed sin(pitch)
+	 * @return Forward thrust replacing the removed pitch [0, 0.9]
+	 */
+	static float pusher_assist_limit_pitch(const matrix::Quatf &q, float q_d[4], float pitch_setpoint_min,
+					       float thrust_scale);
+
 	virtual void blendThrottleAfterFrontTransition(float scale) {};
 
+	/**
+	 * Rebuild the transition schedules from the parameters and derived values, called by update_derived_params().
+	 * Types with own schedules extend it.
+	 */
+	virtual void update_transition_schedules();
+
 	mode get_mode() {return _common_vtol_mode;}
 
+	/**
+	 * @return true if the type drives the control surfaces through vehicle_torque_setpoint instance 1 in the
+	 * current mode, false if the output is held neutral (control surfaces locked in hover, VT_ELEV_MC_LOCK)
+	 */
+	virtual bool uses_torque_setpoint_1() const { return true; }
+
+	/**
+	 * @return true if the type writes vehicle_thrust_setpoint instance 1 (none of the current types does)
+	 */
+	virtual bool uses_thrust_setpoint_1() const { return false; }
+
+	/**
+	 * @return Name of the type specific internal flight mode (for status reporting)
+	 */
+	virtual const char *get_vtol_mode_name() const = 0;
+
 	/**
 	 * @return Minimum front transition time scaled for air density (if available) [s]
 	*/
-	float getMinimumFrontTransitionTime() const;
+	float getMinimumFrontTransitionTime() const { return _derived.min_front_trans_time; }
 
 	/**
 	 * @return Front transition timeout scaled for air density (if available) [s]
 	*/
-	float getFrontTransitionTimeout() const;
+	float getFrontTransitionTimeout() const { return _derived.front_trans_timeout; }
 
 	/**
 	* @return Minimum open-loop front transition time scaled for air density (if available) [s]
 	*/
-	float getOpenLoopFrontTransitionTime() const;
+	float getOpenLoopFrontTransitionTime() const { return _derived.open_loop_front_trans_time; }
 
 	/**
 	 *
@@ -208,7 +388,46 @@ public:
 	 *
 	 * @return The calibrated transition airspeed [m/s]
 	 */
-	float getTransitionAirspeed() const;
+	float getTransitionAirspeed() const { return _derived.transition_airspeed; }
+
+	/**
+	 * Rebuild the analytic transition performance grid, call after a parameter update before
+	 * update_derived_params(). A measured grid is left alone.
+	 */
+	void update_transition_performance();
+
+	/**
+	 * Take over the measured grid published by the command handler, call when its generation
+	 * differs from transition_table_generation().
+	 *
+	 * @return true if the grid changed, call update_derived_params()
+	 */
+	bool update_measured_transition_performance(TransitionTableHandover &table);
+
+	/**
+	 * @return Generation of the last measured grid taken over
+	 */
+	uint32_t transition_table_generation() const { return _transition_table_generation; }
+
+	/**
+	 * @return true if the transition performance comes from the measured table
+	 */
+	bool transition_performance_measured() const { return _transition_performance_measured; }
+
+	/**
+	 * Recompute the values derived from parameters and air density, call after a parameter update.
+	 */
+	void update_derived_params();
+
+	/**
+	 * Recompute the derived values if the air density changed by more than kAirDensityHysteresis.
+	 */
+	void check_air_density_change();
+
+	/**
+	 * @return Number of derived value refreshes so far
+	 */
+	uint32_t derived_params_generation() const { return _derived.generation; }
 
 	virtual void parameters_update() = 0;
 
@@ -217,7 +436,7 @@ public:
 	 * @brief Resets the transition timer states.
 	 *
 	 */
-	void resetTransitionStates();
+	void resetTransitionStates(const VtolControlCycle &cycle);
 
 	/**
 	 * @brief Handle EKF position resets.
@@ -231,26 +450,14 @@ protected:
 
 	static constexpr const int num_outputs_max = 8;
 
-	struct vehicle_attitude_s		*_v_att;				//vehicle attitude
+	VtolIo *_io;	// hot input fields and torque/thrust outputs, owned by the controller
+
 	struct vehicle_attitude_setpoint_s	*_v_att_sp;			//vehicle attitude setpoint
 	struct vehicle_attitude_setpoint_s *_mc_virtual_att_sp;	// virtual mc attitude setpoint
 	struct vehicle_attitude_setpoint_s *_fw_virtual_att_sp;	// virtual fw attitude setpoint
-	struct vehicle_control_mode_s		*_v_control_mode;	//vehicle control mode
 	struct vtol_vehicle_status_s 		*_vtol_vehicle_status;
-	struct vehicle_torque_setpoint_s 		*_vehicle_torque_setpoint_virtual_mc;
-	struct vehicle_torque_setpoint_s 		*_vehicle_torque_setpoint_virtual_fw;
-	struct vehicle_thrust_setpoint_s 		*_vehicle_thrust_setpoint_virtual_mc;
-	struct vehicle_thrust_setpoint_s 		*_vehicle_thrust_setpoint_virtual_fw;
-	struct vehicle_local_position_s			*_local_pos;
-	struct vehicle_local_position_setpoint_s	*_local_pos_sp;
-	struct airspeed_validated_s 			*_airspeed_validated;					// airspeed
-	struct tecs_status_s				*_tecs_status;
-	struct vehicle_land_detected_s			*_land_detected;
-
-	struct vehicle_torque_setpoint_s 		*_torque_setpoint_0;
-	struct vehicle_torque_setpoint_s 		*_torque_setpoint_1;
-	struct vehicle_thrust_setpoint_s 		*_thrust_setpoint_0;
-	struct vehicle_thrust_setpoint_s 		*_thrust_setpoint_1;
+
+	VtolAttitudeCache _attitude;	// quantities derived from the current attitude sample
 
 	float _mc_roll_weight = 1.0f;	// weight for multicopter attitude controller roll output
 	float _mc_pitch_weight = 1.0f;	// weight for multicopter attitude controller pitch output
@@ -269,16 +476,38 @@ protected:
 	bool _tecs_running = false;
 	hrt_abstime _tecs_running_ts = 0;
 
-	hrt_abstime _last_loop_ts = 0;
-	float _transition_dt = 0;
-
 	float _quadchute_ref_alt{NAN};	// altitude (AMSL) reference to compute quad-chute altitude loss condition
 
+	static constexpr int kAltitudeWindowSize = 32;
+	AltitudeWindow<kAltitudeWindowSize> _altitude_window;	// local altitude and TECS shortfall over VT_QC_WINDOW
+
+	QuadchuteLookahead _quadchute_lookahead;	// attitude rate for the VT_QC_LOOKAHEAD projection
+
 	float _accel_to_pitch_integ = 0;
 
 	bool _quadchute_command_treated{false};
 
-	float update_and_get_backtransition_pitch_sp();
+	struct QuadchuteCheck {
+		const char *name;
+		bool (VtolType::*check)(const QuadchuteInputs &inputs);
+		QuadchuteReason reason;
+		uint8_t modes;		// bit (1 << mode) for each mode the check applies in
+	};
+
+	static constexpr int kNumQuadchuteChecks = 10;
+	static constexpr int kFirstLookaheadQuadchuteCheck = 6;	// the VT_QC_LOOKAHEAD checks follow the current ones
+	static const QuadchuteCheck kQuadchuteChecks[kNumQuadchuteChecks];	// in order of increasing cost
+
+	struct QuadchuteCheckCounters {
+		uint32_t evaluations;
+		uint32_t hits;
+	};
+
+	uint16_t _quadchute_checks_enabled{0};	// bit per kQuadchuteChecks entry, refreshed with the parameters
+	QuadchuteCheckCounters _quadchute_check_counters[kNumQuadchuteChecks] {};
+	uint16_t _quadchute_reasons{0};		// reasons active when the last quadchute was triggered
+
+	float update_and_get_backtransition_pitch_sp(float dt);
 	bool isFrontTransitionCompleted();
 	virtual bool isFrontTransitionCompletedBase();
 
@@ -286,6 +515,24 @@ protected:
 
 	int _altitude_reset_counter{0};
 
+	// values derived from parameters and air density, refreshed by update_derived_params()
+	struct DerivedParams {
+		uint32_t generation{0};			// incremented on every refresh
+		float air_density{NAN};			// air density the transition times are scaled for [kg/m^3]
+		float min_front_trans_time{0.f};	// [s]
+		float open_loop_front_trans_time{0.f};	// [s]
+		float front_trans_timeout{0.f};		// [s]
+		float transition_airspeed{0.f};		// [m/s]
+		float blend_airspeed_margin{0.f};	// transition - blending airspeed [m/s]
+		float qc_sin_pitch_max{0.f};		// sin(VT_FW_QC_P)
+		float qc_cos_roll_max{1.f};		// cos(VT_FW_QC_R)
+		float qc_sin_roll_max{0.f};		// sin(VT_FW_QC_R)
+		float qc_window{0.f};			// VT_QC_WINDOW, 0 if the altitude checks are instantaneous [s]
+		float qc_lookahead{0.f};		// VT_QC_LOOKAHEAD, 0 if the look-ahead checks are disabled [s]
+	};
+
+	DerivedParams _derived{};
+
 	DEFINE_PARAMETERS_CUSTOM_PARENT(ModuleParams,
 					(ParamBool<px4::params::VT_ELEV_MC_LOCK>) _param_vt_elev_mc_lock,
 					(ParamFloat<px4::params::VT_FW_MIN_ALT>) _param_vt_fw_min_alt,
@@ -293,6 +540,8 @@ protected:
 					(ParamInt<px4::params::VT_FW_QC_P>) _param_vt_fw_qc_p,
 					(ParamInt<px4::params::VT_FW_QC_R>) _param_vt_fw_qc_r,
 					(ParamFloat<px4::params::VT_QC_T_ALT_LOSS>) _param_vt_qc_t_alt_loss,
+					(ParamFloat<px4::params::VT_QC_WINDOW>) _param_vt_qc_window,
+					(ParamFloat<px4::params::VT_QC_LOOKAHEAD>) _param_vt_qc_lookahead,
 					(ParamInt<px4::params::VT_FW_QC_HMAX>) _param_quadchute_max_height,
 					(ParamFloat<px4::params::VT_F_TR_OL_TM>) _param_vt_f_tr_ol_tm,
 					(ParamFloat<px4::params::VT_TRANS_MIN_TM>) _param_vt_trans_min_tm,
@@ -319,22 +568,24 @@ protected:
 					(ParamFloat<px4::params::MPC_LAND_ALT2>) _param_mpc_land_alt2,
 					(ParamFloat<px4::params::VT_LND_PITCH_MIN>) _param_vt_lnd_pitch_min,
 					(ParamFloat<px4::params::WEIGHT_BASE>) _param_weight_base,
-					(ParamFloat<px4::params::WEIGHT_GROSS>) _param_weight_gross
+					(ParamFloat<px4::params::WEIGHT_GROSS>) _param_weight_gross,
+					(ParamFloat<px4::params::VT_SHAPE_THR>) _param_vt_shape_thr,
+					(ParamFloat<px4::params::VT_SHAPE_WEIGHT>) _param_vt_shape_weight
 
 				       )
 
 private:
 	hrt_abstime _throttle_blend_start_ts{0};	// time at which we start blending between transition throttle and fixed wing throttle
+	TransitionSchedule _throttle_blend_schedule;	// blend scale over the time since _throttle_blend_start_ts
 
 	void resetAccelToPitchPitchIntegrator() { _accel_to_pitch_integ = 0.f; }
 	bool shouldBlendThrottleAfterFrontTransition() { return _throttle_blend_start_ts != 0; };
 
 	void stopBlendingThrottleAfterFrontTransition() { _throttle_blend_start_ts = 0; }
 
-	/**
-	 * @return Transition time scale factor for density.
-	*/
-	float getFrontTransitionTimeFactor() const;
+	TransitionPerformanceGrid _transition_performance;	// transition airspeed and times over air density and weight
+	bool _transition_performance_measured{false};		// filled from the VT_TRANS_TBL table
+	uint32_t _transition_table_generation{0};		// TransitionTableHandover generation taken over
 
 };
 
@@ -0,0 +1,37 @@
+/**
+ * @file vtol_type_config.h
+ * @brief Compile-time selection of the VTOL types built into the module.
+ *
+ * By default every type is built and VT_TYPE selects one at runtime. A board can fix
+ * the airframe with CONFIG_VTOL_ATT_CONTROL_TYPE_{TAILSITTER,TILTROTOR,STANDARD}
+ * (see Kconfig): only that type is compiled and the controller calls it directly.
+ */
+
+#pragma once
+
+#include <px4_platform_common/px4_config.h>
+
+#if defined(CONFIG_VTOL_ATT_CONTROL_TYPE_TAILSITTER)
+#  define VTOL_ATT_CONTROL_SPECIALIZED 1
+#  define VTOL_ATT_CONTROL_HAS_TAILSITTER 1
+#  define VTOL_ATT_CONTROL_HAS_TILTROTOR 0
+#  define VTOL_ATT_CONTROL_HAS_STANDARD 0
+
+#elif defined(CONFIG_VTOL_ATT_CONTROL_TYPE_TILTROTOR)
+#  define VTOL_ATT_CONTROL_SPECIALIZED 1
+#  define VTOL_ATT_CONTROL_HAS_TAILSITTER 0
+#  define VTOL_ATT_CONTROL_HAS_TILTROTOR 1
+#  define VTOL_ATT_CONTROL_HAS_STANDARD 0
+
+#elif defined(CONFIG_VTOL_ATT_CONTROL_TYPE_STANDARD)
+#  define VTOL_ATT_CONTROL_SPECIALIZED 1
+#  define VTOL_ATT_CONTROL_HAS_TAILSITTER 0
+#  define VTOL_ATT_CONTROL_HAS_TILTROTOR 0
+#  define VTOL_ATT_CONTROL_HAS_STANDARD 1
+
+#else
+#  define VTOL_ATT_CONTROL_SPECIALIZED 0
+#  define VTOL_ATT_CONTROL_HAS_TAILSITTER 1
+#  define VTOL_ATT_CONTROL_HAS_TILTROTOR 1
+#  define VTOL_ATT_CONTROL_HAS_STANDARD 1
+#endif